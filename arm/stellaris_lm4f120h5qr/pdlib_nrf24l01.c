@@ -109,10 +109,13 @@
  * 						PE3	<-> IRQ
  */
 
+#ifdef PART_LM4F120H5QR
 #define PDLIB_DEBUG
+#endif
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "pdlib_nrf24l01.h"
 
 #ifdef PDLIB_DEBUG
@@ -133,6 +136,11 @@
 #include "driverlib/gpio.h"
 #endif
 
+// Host emulator of the module
+#ifdef PDLIB_NRF24_EMU
+#include "pdlib_nrf24l01_emu.h"
+#endif
+
 #define TYPE_RX		0x01
 #define TYPE_TX		0x02
 
@@ -153,11 +161,31 @@ static unsigned long g_ulCEPin;
 static unsigned long g_ulCEBase;
 static unsigned long g_ulCSNPin;
 static unsigned long g_ulCSNBase;
+static unsigned char g_ucSSIIndex;
+static unsigned char g_ucTxAddress[5];
+static unsigned char g_ucAddressWidth = 5;
 
 static unsigned char g_ucStatus;
 
+/* PS: Last value written to CONFIG (reset value until RegisterInit) */
+static unsigned char g_ucConfig = 0x08;
+
+/* PS: Last values written to DYNPD and RX_PW_Px, so RX needs no register read for the payload mode */
+static unsigned char g_ucDynPLPipes;
+static unsigned char g_ucRxPayloadWidth[6];
+
+/* PS: IRQ pin, set by NRF24L01_InterruptInit(). Base 0 means the pin is not used */
+static unsigned long g_ulIRQBase;
+static unsigned long g_ulIRQPin;
+
+/* PS: Time source and idle hook used by the wait functions */
+static NRF24L01_ClockFn g_pfnClock = NULL;
+static NRF24L01_IdleFn g_pfnIdle = NULL;
+
 static unsigned int internal_states;
 
+static NRF24L01_Device *g_psActiveDevice = NULL;
+
 /* PS:
  * 
  * Function		: 	NRF24L01_Init
@@ -185,20 +213,37 @@ static unsigned int internal_states;
  */
  	
   
-#ifdef PART_LM4F120H5QR
+#if defined(PART_LM4F120H5QR) || defined(PDLIB_NRF24_EMU)
 
-void
-NRF24L01_Init(	unsigned long ulCEBase,
-				unsigned long ulCEPin,
-				unsigned long ulCEPeriph,
-				unsigned long ulCSNBase,
-				unsigned long ulCSNPin,
-				unsigned long ulCSNPeriph,
-				unsigned char ucSSIIndex)
+/* PS:
+ *
+ * Function		: 	_NRF24L01_InitInterface
+ *
+ * Arguments	: 	Same as NRF24L01_Init()
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Configures the SSI module and the CE/CSN pins without
+ * 					touching the registers of the module.
+ *
+ */
+
+static void
+_NRF24L01_InitInterface(unsigned long ulCEBase,
+						unsigned long ulCEPin,
+						unsigned long ulCEPeriph,
+						unsigned long ulCSNBase,
+						unsigned long ulCSNPin,
+						unsigned long ulCSNPeriph,
+						unsigned char ucSSIIndex)
 {
 	internal_states = 0x00;
+	g_ucAddressWidth = 5;
+	g_ulIRQBase = 0;
 
 	/* PS: Initialize communication */
+	g_ucSSIIndex = ucSSIIndex;
+
 #ifdef PDLIB_SPI
 	pdlibSPI_ConfigureSPIInterface(ucSSIIndex);
 #endif
@@ -211,24 +256,270 @@ NRF24L01_Init(	unsigned long ulCEBase,
 	g_ulCSNBase = ulCSNBase;
 	g_ulCSNPin = ulCSNPin;
 
+#ifdef PART_LM4F120H5QR
 	/* PS: Configure the CE pin to be GPIO output */
 	ROM_SysCtlPeripheralEnable(ulCEPeriph);
 	ROM_GPIOPinTypeGPIOOutput(g_ulCEBase, g_ulCEPin);
+#endif
 	
 	_NRF24L01_CELow();
 
+#ifdef PART_LM4F120H5QR
 	/* PS: Configure the CSN pin to be GPIO output */
 	ROM_SysCtlPeripheralEnable(ulCSNPeriph);
 	ROM_GPIOPinTypeGPIOOutput(ulCSNBase, ulCSNPin);
+#endif
 
 	_NRF24L01_CSNHigh();
+}
+
+void
+NRF24L01_Init(	unsigned long ulCEBase,
+				unsigned long ulCEPin,
+				unsigned long ulCEPeriph,
+				unsigned long ulCSNBase,
+				unsigned long ulCSNPin,
+				unsigned long ulCSNPeriph,
+				unsigned char ucSSIIndex)
+{
+	_NRF24L01_InitInterface(ulCEBase, ulCEPin, ulCEPeriph, ulCSNBase, ulCSNPin, ulCSNPeriph, ucSSIIndex);
 
 	NRF24L01_RegisterInit();
 
 	internal_states |= INTERNAL_STATE_INIT;
 }
 
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_WarmInit
+ *
+ * Arguments	: 	pucList		:	Expected configuration as a write list
+ * 									(see NRF24L01_RegisterWriteList())
+ * 					uiLength	:	Length of the write list in bytes
+ * 					Others		:	Same as NRF24L01_Init()
+ *
+ * Return		: 	Number of registers rewritten
+ * 					PDLIB_NRF24_ERROR	:	Module does not answer
+ *
+ * Description	: 	Init for an MCU reset while the module kept its supply.
+ * 					Instead of resetting all the registers and flushing the
+ * 					FIFOs, the registers of the write list are compared with
+ * 					the module and only the ones which differ are written
+ * 					(see NRF24L01_RegisterSync()).
+ *
+ * 					The RX FIFO and a pending RX_DR are kept, the TX FIFO is
+ * 					flushed. After a power loss the module is at its reset
+ * 					values and the whole list is written, so the list must
+ * 					contain every register the application relies on.
+ *
+ */
+
+int
+NRF24L01_WarmInit(	unsigned long ulCEBase,
+					unsigned long ulCEPin,
+					unsigned long ulCEPeriph,
+					unsigned long ulCSNBase,
+					unsigned long ulCSNPin,
+					unsigned long ulCSNPeriph,
+					unsigned char ucSSIIndex,
+					const unsigned char *pucList,
+					unsigned int uiLength)
+{
+	int ret;
+
+	_NRF24L01_InitInterface(ulCEBase, ulCEPin, ulCEPeriph, ulCSNBase, ulCSNPin, ulCSNPeriph, ucSSIIndex);
+
+	ret = NRF24L01_RegisterSync(pucList, uiLength);
+
+	if(ret >= 0)
+	{
+		NRF24L01_FlushTX();
+		NRF24L01_ClearInterruptFlag(PDLIB_INTERRUPT_MAX_RT | PDLIB_INTERRUPT_DATA_SENT);
+
+		internal_states |= INTERNAL_STATE_INIT;
+	}
+
+	return ret;
+}
+
+#endif
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_InitDevice
+ *
+ * Arguments	: 	psDevice	:	Context to hold the state of this module
+ * 					Others		:	Same as NRF24L01_Init()
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Initializes a module when more than one module is connected.
+ * 					The module will be the active module when the function returns.
+ *
+ * 					All the other APIs work on the active module. Use
+ * 					NRF24L01_SelectDevice() to switch between modules.
+ *
+ */
+
+void
+NRF24L01_InitDevice(NRF24L01_Device *psDevice,
+					unsigned long ulCEBase,
+					unsigned long ulCEPin,
+					unsigned long ulCEPeriph,
+					unsigned long ulCSNBase,
+					unsigned long ulCSNPin,
+					unsigned long ulCSNPeriph,
+					unsigned char ucSSIIndex)
+{
+	if(psDevice)
+	{
+		/* PS: Save the state of the previous module */
+		NRF24L01_SelectDevice(NULL);
+
+		NRF24L01_Init(ulCEBase, ulCEPin, ulCEPeriph, ulCSNBase, ulCSNPin, ulCSNPeriph, ucSSIIndex);
+
+		/* PS: State of the active module lives in the globals until another module is selected */
+		psDevice->ucSSIIndex = ucSSIIndex;
+		g_psActiveDevice = psDevice;
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_WarmInitDevice
+ *
+ * Arguments	: 	psDevice	:	Context to hold the state of this module
+ * 					Others		:	Same as NRF24L01_WarmInit()
+ *
+ * Return		: 	Same as NRF24L01_WarmInit()
+ *
+ * Description	: 	NRF24L01_InitDevice() with a warm start.
+ *
+ */
+
+#if defined(PART_LM4F120H5QR) || defined(PDLIB_NRF24_EMU)
+
+int
+NRF24L01_WarmInitDevice(NRF24L01_Device *psDevice,
+						unsigned long ulCEBase,
+						unsigned long ulCEPin,
+						unsigned long ulCEPeriph,
+						unsigned long ulCSNBase,
+						unsigned long ulCSNPin,
+						unsigned long ulCSNPeriph,
+						unsigned char ucSSIIndex,
+						const unsigned char *pucList,
+						unsigned int uiLength)
+{
+	int ret;
+
+	if(NULL == psDevice)
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	NRF24L01_SelectDevice(NULL);
+
+	ret = NRF24L01_WarmInit(ulCEBase, ulCEPin, ulCEPeriph, ulCSNBase, ulCSNPin, ulCSNPeriph, ucSSIIndex, pucList, uiLength);
+
+	psDevice->ucSSIIndex = ucSSIIndex;
+	g_psActiveDevice = psDevice;
+
+	return ret;
+}
+
+#endif
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_SelectDevice
+ *
+ * Arguments	: 	psDevice	:	Initialized module context.
+ * 									NULL will only save the state of the active module.
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Makes the module the active module. The state of the
+ * 					previously active module is saved to its context.
+ *
+ * 					Should not be called from an ISR while a module is
+ * 					accessed in the main loop.
+ *
+ */
+
+void
+NRF24L01_SelectDevice(NRF24L01_Device *psDevice)
+{
+	if(psDevice == g_psActiveDevice)
+	{
+		return;
+	}
+
+	if(g_psActiveDevice)
+	{
+		g_psActiveDevice->ulCEBase = g_ulCEBase;
+		g_psActiveDevice->ulCEPin = g_ulCEPin;
+		g_psActiveDevice->ulCSNBase = g_ulCSNBase;
+		g_psActiveDevice->ulCSNPin = g_ulCSNPin;
+		g_psActiveDevice->ucStatus = g_ucStatus;
+		g_psActiveDevice->uiInternalStates = internal_states;
+		memcpy(g_psActiveDevice->ucTxAddress, g_ucTxAddress, 5);
+		g_psActiveDevice->ucAddressWidth = g_ucAddressWidth;
+		g_psActiveDevice->ucConfig = g_ucConfig;
+		g_psActiveDevice->ucDynPLPipes = g_ucDynPLPipes;
+		memcpy(g_psActiveDevice->ucRxPayloadWidth, g_ucRxPayloadWidth, 6);
+		g_psActiveDevice->ulIRQBase = g_ulIRQBase;
+		g_psActiveDevice->ulIRQPin = g_ulIRQPin;
+	}
+
+	if(psDevice)
+	{
+		g_ulCEBase = psDevice->ulCEBase;
+		g_ulCEPin = psDevice->ulCEPin;
+		g_ulCSNBase = psDevice->ulCSNBase;
+		g_ulCSNPin = psDevice->ulCSNPin;
+		g_ucStatus = psDevice->ucStatus;
+		internal_states = psDevice->uiInternalStates;
+		g_ucSSIIndex = psDevice->ucSSIIndex;
+		memcpy(g_ucTxAddress, psDevice->ucTxAddress, 5);
+		g_ucAddressWidth = psDevice->ucAddressWidth;
+		g_ucConfig = psDevice->ucConfig;
+		g_ucDynPLPipes = psDevice->ucDynPLPipes;
+		memcpy(g_ucRxPayloadWidth, psDevice->ucRxPayloadWidth, 6);
+		g_ulIRQBase = psDevice->ulIRQBase;
+		g_ulIRQPin = psDevice->ulIRQPin;
+
+#ifdef PDLIB_SPI
+		pdlibSPI_SelectInterface(psDevice->ucSSIIndex);
 #endif
+	}
+
+	g_psActiveDevice = psDevice;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_GetActiveDevice
+ *
+ * Arguments	: 	None
+ *
+ * Return		: 	Module selected by NRF24L01_SelectDevice(), NULL if none
+ *
+ * Description	: 	Lets a caller which selects other modules restore the
+ * 					active one afterwards.
+ *
+ */
+
+NRF24L01_Device *
+NRF24L01_GetActiveDevice()
+{
+	return g_psActiveDevice;
+}
 
 
 /* PS:
@@ -239,7 +530,8 @@ NRF24L01_Init(	unsigned long ulCEBase,
  *
  * Return		: 	None
  *
- * Description	:	Registers the IRQ pin as an interrupt
+ * Description	:	Registers the IRQ pin as an interrupt. The wait functions
+ * 					read the pin instead of the STATUS register while it is high.
  *
  */
 
@@ -262,6 +554,9 @@ void NRF24L01_InterruptInit(unsigned long ulIRQBase,
 
 	ROM_IntEnable(ulInterrupt);
 	ROM_IntMasterEnable();
+
+	g_ulIRQBase = ulIRQBase;
+	g_ulIRQPin = ulIRQPin;
 }
 #endif
 
@@ -306,6 +601,8 @@ NRF24L01_RegisterInit()
 	NRF24L01_RegisterWrite_8(RF24_RX_ADDR_P4,0xC5);
 	NRF24L01_RegisterWrite_8(RF24_RX_ADDR_P5,0xC6);
 	NRF24L01_RegisterWrite_Multi(RF24_TX_ADDR,ucRxAddr1,5);
+	memcpy(g_ucTxAddress, ucRxAddr1, 5);
+	g_ucAddressWidth = 5;
 	NRF24L01_RegisterWrite_8(RF24_RX_PW_P0,0x00);
 	NRF24L01_RegisterWrite_8(RF24_RX_PW_P1,0x00);
 	NRF24L01_RegisterWrite_8(RF24_RX_PW_P2,0x00);
@@ -316,6 +613,158 @@ NRF24L01_RegisterInit()
 	NRF24L01_RegisterWrite_8(RF24_FEATURE,0x00);
 }
 
+#ifdef PDLIB_SPI
+
+/* PS: SPI bit rates tried by NRF24L01_TuneSPIClock(), slowest first */
+static const unsigned long g_ulSPIBitRates[] = {500000, 1000000, 2000000, 4000000, 8000000, 10000000};
+
+#define SPI_BIT_RATE_COUNT	(sizeof(g_ulSPIBitRates) / sizeof(g_ulSPIBitRates[0]))
+
+/* PS: Test patterns written to TX_ADDR */
+static const unsigned char g_ucSPITestPatterns[][5] =
+{
+	{0x55, 0xAA, 0x55, 0xAA, 0x55},
+	{0xAA, 0x55, 0xAA, 0x55, 0xAA},
+	{0xFF, 0x00, 0xFF, 0x00, 0xFF},
+	{0x0F, 0xF0, 0x96, 0x69, 0x81}
+};
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_CheckSPI
+ *
+ * Arguments	: 	None
+ *
+ * Return		: 	1 if all the test patterns are read back correctly, otherwise 0
+ *
+ * Description	: 	Writes the test patterns to TX_ADDR at the current SPI bit rate
+ * 					and reads them back. Only the configured address width is
+ * 					compared, the module doesn't store the other bytes.
+ *
+ */
+
+static unsigned char
+_NRF24L01_CheckSPI()
+{
+	unsigned char ucReadBack[5];
+	unsigned int i;
+
+	for(i = 0; i < (sizeof(g_ucSPITestPatterns) / sizeof(g_ucSPITestPatterns[0])); i++)
+	{
+		NRF24L01_RegisterWrite_Multi(RF24_TX_ADDR, (unsigned char*)g_ucSPITestPatterns[i], g_ucAddressWidth);
+		NRF24L01_RegisterRead_Multi(RF24_TX_ADDR, ucReadBack, g_ucAddressWidth);
+
+		if(0 != memcmp(ucReadBack, g_ucSPITestPatterns[i], g_ucAddressWidth))
+		{
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_TuneSPIClock
+ *
+ * Arguments	: 	ulMaxBitRate	:	Highest SPI bit rate to try (the module supports up to 10 MHz)
+ *
+ * Return		: 	Selected SPI bit rate
+ *
+ * Description	: 	Tries the SPI bit rates from the slowest to ulMaxBitRate and
+ * 					selects the fastest one which reads back all the test patterns
+ * 					correctly. The TX address is restored.
+ *
+ * 					Should be called after NRF24L01_Init() while the module is idle.
+ *
+ */
+
+unsigned long
+NRF24L01_TuneSPIClock(unsigned long ulMaxBitRate)
+{
+	unsigned char ucTxAddress[5];
+	unsigned long ulSelected = g_ulSPIBitRates[0];
+	unsigned int i;
+
+	/* PS: Read the TX address at the slowest bit rate */
+	pdlibSPI_SetBitRate(g_ucSSIIndex, g_ulSPIBitRates[0]);
+	NRF24L01_RegisterRead_Multi(RF24_TX_ADDR, ucTxAddress, g_ucAddressWidth);
+
+	for(i = 0; (i < SPI_BIT_RATE_COUNT) && (g_ulSPIBitRates[i] <= ulMaxBitRate); i++)
+	{
+		pdlibSPI_SetBitRate(g_ucSSIIndex, g_ulSPIBitRates[i]);
+
+		if(0 == _NRF24L01_CheckSPI())
+		{
+			break;
+		}
+
+		ulSelected = g_ulSPIBitRates[i];
+	}
+
+	pdlibSPI_SetBitRate(g_ucSSIIndex, ulSelected);
+
+	/* PS: Restore the TX address */
+	NRF24L01_SetTXAddress(ucTxAddress);
+
+#ifdef PDLIB_DEBUG
+	PrintRegValue("SPI bit rate :", ulSelected);
+#endif
+
+	return ulSelected;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_VerifySPIClock
+ *
+ * Arguments	: 	None
+ *
+ * Return		: 	SPI bit rate in use when the function returns, or 0 if the
+ * 					verification failed at every bit rate
+ *
+ * Description	: 	Verifies the current SPI bit rate with the test patterns. If the
+ * 					verification fails, falls back to the next slower bit rate until
+ * 					the verification passes or the slowest bit rate is reached. On
+ * 					0 the slowest bit rate stays selected.
+ *
+ * 					Can be called periodically or when an SPI error is suspected.
+ * 					The TX address is restored to the value set by NRF24L01_SetTXAddress().
+ *
+ */
+
+unsigned long
+NRF24L01_VerifySPIClock()
+{
+	unsigned long ulBitRate = pdlibSPI_GetBitRate(g_ucSSIIndex);
+	unsigned char ucPassed;
+	int i;
+
+	ucPassed = _NRF24L01_CheckSPI();
+
+	for(i = SPI_BIT_RATE_COUNT - 1; (i >= 0) && (0 == ucPassed); i--)
+	{
+		if(g_ulSPIBitRates[i] >= ulBitRate)
+		{
+			continue;
+		}
+
+		ulBitRate = g_ulSPIBitRates[i];
+		pdlibSPI_SetBitRate(g_ucSSIIndex, ulBitRate);
+
+		ucPassed = _NRF24L01_CheckSPI();
+	}
+
+	/* PS: Restore the TX address from the last value set through the driver */
+	NRF24L01_RegisterWrite_Multi(RF24_TX_ADDR, g_ucTxAddress, g_ucAddressWidth);
+
+	return ucPassed ? ulBitRate : 0;
+}
+
+#endif
+
 /* PS:
  * 
  * Function		: 	NRF24L01_GetStatus
@@ -394,11 +843,11 @@ NRF24L01_SetRFChannel(unsigned char ucRFChannel)
  * 
  * Function		: 	NRF24L01_SetPAGain
  * 
- * Arguments	: 	ucPAGain	: Only bits 0:1 are valid.
+ * Arguments	: 	iPAGain	: PA gain in dBm. Values in between are rounded up.
  * 
  * Return		: 	None
  * 
- * Description	: 	Sets the power amplifier gain based on the ucPAGain.
+ * Description	: 	Sets the power amplifier gain based on the iPAGain.
  * 					0 = 0 dBm (default)
  * 					-6 = -6 dBm
  * 					-12 = -12 dBm
@@ -419,7 +868,7 @@ NRF24L01_SetPAGain(int iPAGain)
 		iPAGain = 0;
 	}
 
-	 /* PS:
+	 /* PS: RF_PWR, bits 2:1
 	  * 				11 = 0 dBm (default)
 	  *					10 = -6 dBm
 	  *					01 = -12 dBm
@@ -428,16 +877,30 @@ NRF24L01_SetPAGain(int iPAGain)
 
 	iPAGain = 3 - (-1*(iPAGain) / 6);
 
-	if(ucCurrentVal)
-	{
-		ucCurrentVal |= ((iPAGain && 0x03) << 1);
-	}else
-	{
-		ucCurrentVal &= ~((iPAGain && 0x03) << 1);
-	}
+	ucCurrentVal &= ~(0x03 << 1);
+	ucCurrentVal |= ((iPAGain & 0x03) << 1);
 	
 	NRF24L01_RegisterWrite_8(RF24_RF_SETUP, ucCurrentVal);
 } 
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_GetPAGain
+ *
+ * Arguments	: 	None
+ *
+ * Return		: 	PA gain in dBm (0, -6, -12 or -18)
+ *
+ */
+
+int
+NRF24L01_GetPAGain()
+{
+	unsigned char ucLevel = (NRF24L01_RegisterRead_8(RF24_RF_SETUP) >> 1) & 0x03;
+
+	return -6 * (3 - ucLevel);
+}
  
  
 /* PS:
@@ -541,7 +1004,9 @@ void NRF24L01_SetARD(unsigned short usVal){
  *
  * Return		: 	None
  *
- * Description	: 	Set the address width for TX/RX address
+ * Description	: 	Set the address width for TX/RX address. The width is
+ * 					used by all the functions which read or write a TX/RX address,
+ * 					so the addresses should be set again after this call.
  *
  */
 void NRF24L01_SetAddressWidth(unsigned char ucVal){
@@ -559,17 +1024,358 @@ void NRF24L01_SetAddressWidth(unsigned char ucVal){
 	// 4 - 0x10
 	// 5 - 0x11
 
+	g_ucAddressWidth = ucWidth;
+
 	ucWidth -= 2;
 
 	NRF24L01_RegisterWrite_8(RF24_SETUP_AW, ucWidth);
 }
 
 
-
 /* PS:
- * 
- * Function		: 	NRF24L01_PowerDown
- * 
+ *
+ * Function		: 	NRF24L01_GetAddressWidth
+ *
+ * Arguments	: 	None
+ *
+ * Return		: 	Address width in bytes (3 ~ 5)
+ *
+ * Description	: 	Returns the address width used by the driver.
+ *
+ */
+
+unsigned char
+NRF24L01_GetAddressWidth()
+{
+	return g_ucAddressWidth;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_AddressByte
+ *
+ * Arguments	: 	ucIndex		:	Index of the byte (0 ~ 237)
+ *
+ * Return		: 	ucIndex'th address byte with at least two bit transitions
+ *
+ * Description	: 	Skips the bytes which are bad for an address, ie. bytes with
+ * 					less than two bit transitions (0x00, 0xFF, 0x0F, 0x80, ...)
+ * 					and the preamble like bytes 0x55 and 0xAA. There are 238
+ * 					good bytes, so the mapping is unique for 0 ~ 237.
+ *
+ */
+
+static unsigned char
+_NRF24L01_AddressByte(unsigned char ucIndex)
+{
+	unsigned int uiByte;
+	unsigned char ucTransitions;
+
+	for(uiByte = 0; uiByte < 256; uiByte++)
+	{
+		ucTransitions = uiByte ^ (uiByte >> 1);
+		ucTransitions &= 0x7F;
+
+		/* PS: Count the bits */
+		ucTransitions = (ucTransitions & 0x55) + ((ucTransitions >> 1) & 0x55);
+		ucTransitions = (ucTransitions & 0x33) + ((ucTransitions >> 2) & 0x33);
+		ucTransitions = (ucTransitions & 0x0F) + (ucTransitions >> 4);
+
+		if((ucTransitions < 2) || (0x55 == uiByte) || (0xAA == uiByte))
+		{
+			continue;
+		}
+
+		if(0 == ucIndex)
+		{
+			break;
+		}
+
+		ucIndex--;
+	}
+
+	return (unsigned char)uiByte;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_MakeAddress
+ *
+ * Arguments	: 	ulNetwork	:	Network ID, common to all the nodes of a network
+ * 					ucNode		:	Node ID (0 ~ PDLIB_NRF24_MAX_NODE)
+ * 					pucAddress	:	Buffer for the address (at least address width bytes)
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				: Success
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	: Invalid input argument
+ *
+ * Description	: 	Builds the address of a node for the current address width.
+ * 					The LSB is unique for each node and the other bytes are taken
+ * 					from the network ID, so the addresses of the nodes can be used
+ * 					on the pipes 1 ~ 5 of one receiver. None of the bytes looks
+ * 					like the preamble or has long runs of the same bit.
+ *
+ * 					Use the shortest address width the network allows
+ * 					(NRF24L01_SetAddressWidth()) to shorten the packets on air.
+ *
+ */
+
+int
+NRF24L01_MakeAddress(unsigned long ulNetwork, unsigned char ucNode, unsigned char *pucAddress)
+{
+	unsigned char i;
+
+	if((NULL == pucAddress) || (ucNode > PDLIB_NRF24_MAX_NODE))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	pucAddress[0] = _NRF24L01_AddressByte(ucNode);
+
+	for(i = 1; i < g_ucAddressWidth; i++)
+	{
+		pucAddress[i] = _NRF24L01_AddressByte((ulNetwork & 0xFF) % (PDLIB_NRF24_MAX_NODE + 1));
+		ulNetwork >>= 8;
+	}
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_SetCRCMode
+ *
+ * Arguments	: 	ucMode		:	PDLIB_NRF24_CRC_NONE, PDLIB_NRF24_CRC_1BYTE or PDLIB_NRF24_CRC_2BYTE
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				: Success
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	: Invalid mode, or CRC can't be disabled
+ * 													  because auto ack is enabled on a pipe
+ *
+ * Description	: 	Selects the hardware CRC of the packets. The module forces the
+ * 					CRC on while any bit of EN_AA is set, so auto ack has to be
+ * 					disabled (RF24_EN_AA = 0) before the CRC can be disabled.
+ *
+ * 					Each CRC byte adds 8 bits to every packet on air. Without the
+ * 					hardware CRC, corrupted packets are passed to the application,
+ * 					which should check the integrity itself (NRF24L01_AppendCRC16()).
+ *
+ * 					Both sides should use the same mode.
+ *
+ */
+
+int
+NRF24L01_SetCRCMode(unsigned char ucMode)
+{
+	unsigned char ucConfig = g_ucConfig & ~((RF24_EN_CRC) | (RF24_CRCO));
+
+	switch(ucMode)
+	{
+		case PDLIB_NRF24_CRC_NONE:
+			if(NRF24L01_RegisterRead_8(RF24_EN_AA) & 0x3F)
+			{
+				return PDLIB_NRF24_INVALID_ARGUMENT;
+			}
+			break;
+		case PDLIB_NRF24_CRC_1BYTE:
+			ucConfig |= (RF24_EN_CRC);
+			break;
+		case PDLIB_NRF24_CRC_2BYTE:
+			ucConfig |= (RF24_EN_CRC) | (RF24_CRCO);
+			break;
+		default:
+			return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	NRF24L01_RegisterWrite_8(RF24_CONFIG, ucConfig);
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_GetCRCMode
+ *
+ * Arguments	: 	None
+ *
+ * Return		: 	PDLIB_NRF24_CRC_NONE, PDLIB_NRF24_CRC_1BYTE or PDLIB_NRF24_CRC_2BYTE
+ *
+ * Description	: 	Returns the CRC mode from the last value written to CONFIG.
+ *
+ */
+
+unsigned char
+NRF24L01_GetCRCMode()
+{
+	if(0 == (g_ucConfig & (RF24_EN_CRC)))
+	{
+		return PDLIB_NRF24_CRC_NONE;
+	}
+
+	return (g_ucConfig & (RF24_CRCO)) ? PDLIB_NRF24_CRC_2BYTE : PDLIB_NRF24_CRC_1BYTE;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_GetAirTime
+ *
+ * Arguments	: 	ucPayloadLength	:	Payload length in bytes (0 ~ 32)
+ *
+ * Return		: 	Time on air of one packet in microseconds
+ *
+ * Description	: 	Calculates the time on air of one Enhanced ShockBurst packet
+ * 					(preamble, address, packet control field, payload and CRC) for
+ * 					the current address width, CRC mode and air data rate. The
+ * 					130us TX settling time and the ACK packet are not included.
+ *
+ * 					Can be used to compare the CRC modes and address widths for a
+ * 					stream.
+ *
+ */
+
+unsigned int
+NRF24L01_GetAirTime(unsigned char ucPayloadLength)
+{
+	unsigned char ucRFSetup = NRF24L01_RegisterRead_8(RF24_RF_SETUP);
+	unsigned int uiBits;
+	unsigned int uiKbps;
+
+	/* PS: Preamble + address + 9 bit packet control field + payload + CRC */
+	uiBits = 8 * (1 + g_ucAddressWidth + ucPayloadLength + NRF24L01_GetCRCMode()) + 9;
+
+	if(ucRFSetup & (RF24_RF_DR_LOW))
+	{
+		uiKbps = 250;
+	}else if(ucRFSetup & (RF24_RF_DR_HIGH))
+	{
+		uiKbps = 2000;
+	}else
+	{
+		uiKbps = 1000;
+	}
+
+	return ((uiBits * 1000) + uiKbps - 1) / uiKbps;
+}
+
+
+/* PS: CRC-16/CCITT (polynomial 0x1021), 4 bits at a time */
+static const unsigned short g_usCRC16Table[16] =
+{
+	0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+	0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_CRC16
+ *
+ * Arguments	: 	pucData		:	Data
+ * 					uiLength	:	Length of the data
+ * 					usCRC		:	Initial value (PDLIB_NRF24_CRC16_INIT, or the
+ * 									result of the previous block)
+ *
+ * Return		: 	CRC-16/CCITT of the data
+ *
+ * Description	: 	Software CRC, same polynomial as the 2 byte hardware CRC.
+ *
+ */
+
+unsigned short
+NRF24L01_CRC16(const unsigned char *pucData, unsigned int uiLength, unsigned short usCRC)
+{
+	while(uiLength--)
+	{
+		usCRC = (usCRC << 4) ^ g_usCRC16Table[(usCRC >> 12) ^ (*pucData >> 4)];
+		usCRC = (usCRC << 4) ^ g_usCRC16Table[(usCRC >> 12) ^ (*pucData & 0x0F)];
+		pucData++;
+	}
+
+	return usCRC;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_AppendCRC16
+ *
+ * Arguments	: 	pcData		:	Payload buffer
+ * 					uiLength	:	Length of the payload in the buffer
+ * 					uiSize		:	Size of the buffer
+ *
+ * Return		: 	Length of the payload with the CRC, or
+ * 					PDLIB_NRF24_BUFFER_TOO_SMALL	: No space for the CRC
+ *
+ * Description	: 	Appends the CRC-16 of the payload to the payload (MSB first),
+ * 					to carry the integrity check inside the payload when the
+ * 					hardware CRC is disabled. If the payload is encrypted, append
+ * 					the CRC (or a MAC) before encrypting, so the receiver checks
+ * 					the decrypted payload.
+ *
+ */
+
+int
+NRF24L01_AppendCRC16(char *pcData, unsigned int uiLength, unsigned int uiSize)
+{
+	unsigned short usCRC;
+
+	if((NULL == pcData) || ((uiLength + 2) > uiSize))
+	{
+		return PDLIB_NRF24_BUFFER_TOO_SMALL;
+	}
+
+	usCRC = NRF24L01_CRC16((unsigned char*)pcData, uiLength, PDLIB_NRF24_CRC16_INIT);
+
+	pcData[uiLength] = (char)(usCRC >> 8);
+	pcData[uiLength + 1] = (char)(usCRC & 0xFF);
+
+	return uiLength + 2;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_CheckCRC16
+ *
+ * Arguments	: 	pcData		:	Received payload with the CRC at the end
+ * 					uiLength	:	Length of the received payload
+ *
+ * Return		: 	Length of the payload without the CRC, or
+ * 					PDLIB_NRF24_CRC_ERROR			: CRC mismatch
+ *
+ * Description	: 	Checks a payload built by NRF24L01_AppendCRC16().
+ *
+ */
+
+int
+NRF24L01_CheckCRC16(const char *pcData, unsigned int uiLength)
+{
+	unsigned short usCRC;
+
+	if((NULL == pcData) || (uiLength < 2))
+	{
+		return PDLIB_NRF24_CRC_ERROR;
+	}
+
+	usCRC = NRF24L01_CRC16((const unsigned char*)pcData, uiLength - 2, PDLIB_NRF24_CRC16_INIT);
+
+	if((((unsigned char)pcData[uiLength - 2]) != (usCRC >> 8)) ||
+		(((unsigned char)pcData[uiLength - 1]) != (usCRC & 0xFF)))
+	{
+		return PDLIB_NRF24_CRC_ERROR;
+	}
+
+	return uiLength - 2;
+}
+
+
+
+/* PS:
+ * 
+ * Function		: 	NRF24L01_PowerDown
+ * 
  * Arguments	: 	None
  * 
  * Return		: 	None
@@ -581,10 +1387,7 @@ void NRF24L01_SetAddressWidth(unsigned char ucVal){
 void
 NRF24L01_PowerDown()
 {
-	unsigned char ucCurrentVal = NRF24L01_RegisterRead_8(RF24_CONFIG);
-	ucCurrentVal &= (~RF24_PWR_UP);
-	
-	NRF24L01_RegisterWrite_8(RF24_CONFIG, ucCurrentVal);
+	NRF24L01_RegisterWrite_8(RF24_CONFIG, g_ucConfig & ~(RF24_PWR_UP));
 	
 	_NRF24L01_CELow();
 
@@ -606,14 +1409,32 @@ NRF24L01_PowerDown()
 void
 NRF24L01_PowerUp()
 {
-	unsigned char ucCurrentVal = NRF24L01_RegisterRead_8(RF24_CONFIG);
-	ucCurrentVal |= (RF24_PWR_UP);
-	NRF24L01_RegisterWrite_8(RF24_CONFIG, ucCurrentVal);
+	NRF24L01_RegisterWrite_8(RF24_CONFIG, g_ucConfig | (RF24_PWR_UP));
 
 	internal_states |= INTERNAL_STATE_POWER_UP;
 }
 
 
+/* PS:
+ *
+ * Function		: 	NRF24L01_IsPoweredUp
+ *
+ * Arguments	: 	None
+ *
+ * Return		: 	1 if the module was powered up by the driver, otherwise 0
+ *
+ * Description	: 	Doesn't access the module. The module needs 1.5 ms after
+ * 					power up before it can go to RX or TX mode.
+ *
+ */
+
+unsigned char
+NRF24L01_IsPoweredUp()
+{
+	return (internal_states & INTERNAL_STATE_POWER_UP) ? 1 : 0;
+}
+
+
 /* PS:
  * 
  * Function		: 	NRF24L01_FlushTX
@@ -670,17 +1491,12 @@ NRF24L01_FlushRX()
 void
 NRF24L01_EnableRxMode()
 {
-	unsigned char ucCurrentVal = NRF24L01_GetStatus();
-
 	NRF24L01_PowerUp();
 
 	// PS: Clear RX_DR interrupt TODO: Why?
 	NRF24L01_ClearInterruptFlag(PDLIB_INTERRUPT_DATA_READY);
 
-	ucCurrentVal = NRF24L01_RegisterRead_8(RF24_CONFIG);
-	ucCurrentVal |= (RF24_PRIM_RX | RF24_PWR_UP);
-	
-	NRF24L01_RegisterWrite_8(RF24_CONFIG, ucCurrentVal);
+	NRF24L01_RegisterWrite_8(RF24_CONFIG, g_ucConfig | (RF24_PRIM_RX) | (RF24_PWR_UP));
 	
 	_NRF24L01_CEHigh();
 }
@@ -719,8 +1535,6 @@ void NRF24L01_DisableRxMode()
 void
 NRF24L01_EnableTxMode()
 {
-	unsigned char ucCurrentVal = 0;
-
 	// PS: Power up the device
 	NRF24L01_PowerUp();
 
@@ -728,10 +1542,7 @@ NRF24L01_EnableTxMode()
 	NRF24L01_ClearInterruptFlag(PDLIB_INTERRUPT_MAX_RT | PDLIB_INTERRUPT_DATA_SENT);
 
 	// PS: Set to TX mode
-	ucCurrentVal = NRF24L01_RegisterRead_8(RF24_CONFIG);
-	ucCurrentVal &= (~RF24_PRIM_RX);
-	
-	NRF24L01_RegisterWrite_8(RF24_CONFIG, ucCurrentVal);
+	NRF24L01_RegisterWrite_8(RF24_CONFIG, g_ucConfig & ~(RF24_PRIM_RX));
 
 	_NRF24L01_CEHigh();
 
@@ -766,6 +1577,77 @@ void NRF24L01_DisableTxMode()
 }
 
 
+/* PS:
+ *
+ * Function		: 	NRF24L01_Turnaround
+ *
+ * Arguments	: 	ucRxMode	:	1 to switch to RX mode, 0 to switch to TX mode
+ * 					ucSettle	:	1 to wait PDLIB_NRF24_TSTBY2A_US for the PLL to settle
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				:	Module is in the new mode
+ * 					PDLIB_NRF24_ERROR				:	Module is powered down
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Settling wait needs a clock source
+ *
+ * Description	: 	Fast switch between RX and TX for a powered up module. CE
+ * 					is low only while PRIM_RX is written, with one CONFIG write
+ * 					from the shadow, and the module stays in Standby, so the
+ * 					switch costs the 130 us settling instead of a power up.
+ *
+ * 					To TX, TX_DS and MAX_RT are cleared with one STATUS write
+ * 					and CE is left high: a payload in the TX FIFO is sent at
+ * 					once, otherwise the module waits in Standby II for one.
+ * 					RX_DR is not cleared, so no received payload is missed.
+ *
+ * 					Call it after the current TX has completed.
+ *
+ */
+
+int
+NRF24L01_Turnaround(unsigned char ucRxMode, unsigned char ucSettle)
+{
+	unsigned char ucConfig;
+	unsigned long ulStart;
+
+	if(0 == (internal_states & INTERNAL_STATE_POWER_UP))
+	{
+		return PDLIB_NRF24_ERROR;
+	}
+
+	if(ucSettle && (NULL == g_pfnClock))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	if(ucRxMode)
+	{
+		ucConfig = g_ucConfig | (RF24_PRIM_RX) | (RF24_PWR_UP);
+	}else
+	{
+		ucConfig = (g_ucConfig | (RF24_PWR_UP)) & ~(RF24_PRIM_RX);
+
+		NRF24L01_RegisterWrite_8(RF24_STATUS, RF24_TX_DS | RF24_MAX_RT);
+	}
+
+	_NRF24L01_CELow();
+
+	if(ucConfig != g_ucConfig)
+	{
+		NRF24L01_RegisterWrite_8(RF24_CONFIG, ucConfig);
+	}
+
+	_NRF24L01_CEHigh();
+
+	if(ucSettle)
+	{
+		ulStart = g_pfnClock();
+
+		while((g_pfnClock() - ulStart) < PDLIB_NRF24_TSTBY2A_US);
+	}
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+
 /* PS:
  * 
  * Function		: 	NRF24L01_IsDataReadyRx
@@ -813,6 +1695,177 @@ NRF24L01_IsDataReadyRx(char *pcPipeNo)
 }
 
 
+/* PS:
+ *
+ * Function		: 	NRF24L01_SetClockSource
+ *
+ * Arguments	: 	pfnClock	:	Function returning a free running microsecond count.
+ * 									Wrapping is handled. NULL removes the clock source.
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Sets the time source of the *Timeout() functions, ie. a
+ * 					function reading a 32 bit timer counting up in microseconds.
+ *
+ */
+
+void
+NRF24L01_SetClockSource(NRF24L01_ClockFn pfnClock)
+{
+	g_pfnClock = pfnClock;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_GetClockSource
+ *
+ * Arguments	: 	None
+ *
+ * Return		: 	Clock source set by NRF24L01_SetClockSource(), or NULL
+ *
+ */
+
+NRF24L01_ClockFn
+NRF24L01_GetClockSource()
+{
+	return g_pfnClock;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_SetIdleHook
+ *
+ * Arguments	: 	pfnIdle		:	Function called while waiting. NULL to busy wait.
+ *
+ * Return		: 	None
+ *
+ * Description	: 	The hook is called in every iteration of the wait loops. It
+ * 					can put the MCU to sleep until the next interrupt (ie. WFI)
+ * 					if the IRQ pin interrupt (NRF24L01_InterruptInit()) or a
+ * 					timer interrupt is enabled to wake it up.
+ *
+ */
+
+void
+NRF24L01_SetIdleHook(NRF24L01_IdleFn pfnIdle)
+{
+	g_pfnIdle = pfnIdle;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_GetTimeUs
+ *
+ * Arguments	: 	None
+ *
+ * Return		: 	Current time of the clock source in microseconds, 0 if not set
+ *
+ * Description	: 	Reads the clock source set by NRF24L01_SetClockSource().
+ *
+ */
+
+unsigned long
+NRF24L01_GetTimeUs()
+{
+	return (g_pfnClock) ? g_pfnClock() : 0;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_IRQAsserted
+ *
+ * Arguments	: 	ucMask		:	STATUS interrupt bits the caller waits for
+ *
+ * Return		: 	0 if the IRQ pin says none of the interrupts is asserted,
+ * 					otherwise 1 (STATUS register needs to be read)
+ *
+ * Description	: 	Saves the SPI transaction while the IRQ pin is high. If the
+ * 					pin is not registered or one of the interrupts is masked in
+ * 					CONFIG the pin can't be trusted.
+ *
+ */
+
+static unsigned char
+_NRF24L01_IRQAsserted(unsigned char ucMask)
+{
+#ifdef PART_LM4F120H5QR
+	if((0 != g_ulIRQBase) && (0 == (g_ucConfig & ucMask)))
+	{
+		return (0 == ROM_GPIOPinRead(g_ulIRQBase, g_ulIRQPin)) ? 1 : 0;
+	}
+#endif
+
+	return 1;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_WaitStatus
+ *
+ * Arguments	: 	ucMask		:	STATUS interrupt bits to wait for
+ * 					ulTimeoutUs	:	Timeout in microseconds, 0 to check once or
+ * 									PDLIB_NRF24_WAIT_FOREVER
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				: One of the bits is set (g_ucStatus is updated)
+ * 					PDLIB_NRF24_WOULD_BLOCK			: None set and ulTimeoutUs is 0
+ * 					PDLIB_NRF24_TIMEOUT				: None set within the timeout
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	: Timeout needs a clock source
+ *
+ * Description	: 	Common wait loop. Calls the idle hook between the checks.
+ *
+ * 					Interrupt bits have the same positions in STATUS and as
+ * 					the mask bits in CONFIG.
+ *
+ */
+
+static int
+_NRF24L01_WaitStatus(unsigned char ucMask, unsigned long ulTimeoutUs)
+{
+	unsigned long ulStart = 0;
+
+	if((0 != ulTimeoutUs) && (PDLIB_NRF24_WAIT_FOREVER != ulTimeoutUs))
+	{
+		if(NULL == g_pfnClock)
+		{
+			return PDLIB_NRF24_INVALID_ARGUMENT;
+		}
+
+		ulStart = g_pfnClock();
+	}
+
+	while(1)
+	{
+		if(_NRF24L01_IRQAsserted(ucMask))
+		{
+			if(NRF24L01_GetStatus() & ucMask)
+			{
+				return PDLIB_NRF24_SUCCESS;
+			}
+		}
+
+		if(0 == ulTimeoutUs)
+		{
+			return PDLIB_NRF24_WOULD_BLOCK;
+		}
+
+		if((PDLIB_NRF24_WAIT_FOREVER != ulTimeoutUs) && ((g_pfnClock() - ulStart) >= ulTimeoutUs))
+		{
+			return PDLIB_NRF24_TIMEOUT;
+		}
+
+		if(g_pfnIdle)
+		{
+			g_pfnIdle();
+		}
+	}
+}
+
+
 /* PS:
  *
  * Function		: 	NRF24L01_WaitForDataRx
@@ -822,39 +1875,146 @@ NRF24L01_IsDataReadyRx(char *pcPipeNo)
  * Return		: 	PDLIB_NRF24_ERROR	:	Invalid input argument
  * 					PDLIB_NRF24_SUCCESS	:	Data is in RX FIFO
  *
- * Description	: 	Wait until any RX pipe has data
+ * Description	: 	Wait until any RX pipe has data. Never returns if no data
+ * 					arrives, see NRF24L01_WaitForDataRxTimeout().
  *
  */
 
 int NRF24L01_WaitForDataRx(char *pcPipeNo)
 {
-	int iRet = PDLIB_NRF24_ERROR;
+	int iRet;
+
+	if(NULL == pcPipeNo)
+	{
+		return PDLIB_NRF24_ERROR;
+	}
+
+	iRet = NRF24L01_WaitForDataRxTimeout(pcPipeNo, PDLIB_NRF24_WAIT_FOREVER);
+
+	return (PDLIB_NRF24_SUCCESS == iRet) ? iRet : PDLIB_NRF24_ERROR;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_WaitForDataRxTimeout
+ *
+ * Arguments	: 	pcPipeNo [out]	:	Pipe number which contains the RX payload
+ * 					ulTimeoutUs		:	Timeout in microseconds, or PDLIB_NRF24_WAIT_FOREVER
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				:	Data is in RX FIFO
+ * 					PDLIB_NRF24_TIMEOUT				:	No data within the timeout
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument or no clock source
+ *
+ * Description	: 	Puts the module to RX mode and waits until any RX pipe has
+ * 					data or the timeout elapses. The module is in Standby I mode
+ * 					when the function returns.
+ *
+ */
+
+int NRF24L01_WaitForDataRxTimeout(char *pcPipeNo, unsigned long ulTimeoutUs)
+{
+	unsigned long ulStart = 0;
+	unsigned long ulElapsed;
+	unsigned long ulWaitUs = ulTimeoutUs;
+	int iRet;
+
+	if(NULL == pcPipeNo)
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	if((0 != ulTimeoutUs) && (PDLIB_NRF24_WAIT_FOREVER != ulTimeoutUs))
+	{
+		if(NULL == g_pfnClock)
+		{
+			return PDLIB_NRF24_INVALID_ARGUMENT;
+		}
+
+		ulStart = g_pfnClock();
+	}
 
 	NRF24L01_EnableRxMode();
 
 #ifdef PDLIB_DEBUG
 	PrintString("Waiting for data...\n\r");
-
-	/*
-		PrintRegValue("CONFIG: ",NRF24L01_RegisterRead_8(RF24_CONFIG));
-		PrintRegValue("EN_RXADDR: ",NRF24L01_RegisterRead_8(RF24_EN_RXADDR));
-		PrintRegValue("EN_AA: ",NRF24L01_RegisterRead_8(RF24_EN_AA));
-		PrintRegValue("RX_PW_P0: ",NRF24L01_RegisterRead_8(RF24_RX_PW_P0));*/
 #endif
 
+	do
+	{
+		/* PS: Spurious RX_DR must not restart the timeout */
+		if((0 != ulTimeoutUs) && (PDLIB_NRF24_WAIT_FOREVER != ulTimeoutUs))
+		{
+			ulElapsed = g_pfnClock() - ulStart;
+			ulWaitUs = (ulElapsed < ulTimeoutUs) ? (ulTimeoutUs - ulElapsed) : 0;
+		}
+
+		iRet = _NRF24L01_WaitStatus(RF24_RX_DR, ulWaitUs);
 
-	while(iRet == PDLIB_NRF24_ERROR)
+		if(PDLIB_NRF24_SUCCESS == iRet)
+		{
+			iRet = NRF24L01_IsDataReadyRx(pcPipeNo);
+
+			/* PS: RX_DR without a payload, ie. already read by an ISR */
+			if(PDLIB_NRF24_SUCCESS != iRet)
+			{
+				NRF24L01_ClearInterruptFlag(PDLIB_INTERRUPT_DATA_READY);
+			}
+		}
+	}while(PDLIB_NRF24_ERROR == iRet);
+
+	if(PDLIB_NRF24_WOULD_BLOCK == iRet)
 	{
-		iRet = NRF24L01_IsDataReadyRx(pcPipeNo);
+		iRet = PDLIB_NRF24_TIMEOUT;
 	}
 
-
 	NRF24L01_DisableRxMode();
 
 	return iRet;
 }
 
 
+/* PS:
+ *
+ * Function		: 	NRF24L01_PollDataRx
+ *
+ * Arguments	: 	pcPipeNo [out] : Pipe number which contains the RX payload
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				:	Data is in RX FIFO
+ * 					PDLIB_NRF24_WOULD_BLOCK			:	No data yet
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ *
+ * Description	: 	Non blocking check for RX data. Unlike the wait functions the
+ * 					mode is not changed, call NRF24L01_EnableRxMode() first. Only
+ * 					reads the IRQ pin while no interrupt is asserted.
+ *
+ */
+
+int NRF24L01_PollDataRx(char *pcPipeNo)
+{
+	int iRet;
+
+	if(NULL == pcPipeNo)
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	iRet = _NRF24L01_WaitStatus(RF24_RX_DR, 0);
+
+	if(PDLIB_NRF24_SUCCESS == iRet)
+	{
+		iRet = NRF24L01_IsDataReadyRx(pcPipeNo);
+
+		if(PDLIB_NRF24_SUCCESS != iRet)
+		{
+			iRet = PDLIB_NRF24_WOULD_BLOCK;
+		}
+	}
+
+	return iRet;
+}
+
+
 
 /* PS:
  *
@@ -912,9 +2072,13 @@ int NRF24L01_IsTxFifoEmpty()
  * 
  * Description	: 	Reading the number of data bytes available
  * 					in the specified pipe (for static payload mode).
+ * 					The width set by NRF24L01_SetRXPacketSize() is returned
+ * 					without accessing the module.
  *
- * 					For dynamic payload mode this will tell
- * 					the top most RX_FIFO payload length.
+ * 					For a pipe in dynamic payload mode this will tell
+ * 					the top most RX_FIFO payload length. If the module reports
+ * 					a length over 32 the payload is corrupted, RX FIFO is
+ * 					flushed and 0 is returned.
  * 
  */
 
@@ -924,18 +2088,22 @@ NRF24L01_GetRxDataAmount(unsigned char ucDataPipe)
 	char reg;
 	char ret = 0;
 
-	if((INTERNAL_STATE_DYNPL & internal_states) == 0){
-		if(ucDataPipe < 6)
-		{
-			reg = NRF24L01_RegisterRead_8(RF24_RX_PW_P0 + ucDataPipe);
-			ret = (reg & 0x3F);
-		}else
-		{
-			ret = 0;
-		}
+	if(ucDataPipe >= 6)
+	{
+		ret = 0;
+	}else if((0 == (INTERNAL_STATE_DYNPL & internal_states)) ||
+			(0 == (g_ucDynPLPipes & (1 << ucDataPipe))))
+	{
+		ret = g_ucRxPayloadWidth[ucDataPipe];
 	}else{
 		NRF24L01_SendRcvCommand(RF24_R_RX_PL_WID, &reg, 1);
 
+		if((unsigned char)reg > 32)
+		{
+			NRF24L01_FlushRX();
+			reg = 0;
+		}
+
 		ret = reg;
 	}
 
@@ -947,7 +2115,7 @@ NRF24L01_GetRxDataAmount(unsigned char ucDataPipe)
  * 
  * Function		: 	NRF24L01_SetTXAddress
  * 
- * Arguments	: 	address	:	Buffer which contains the five bytes to put to address.
+ * Arguments	: 	address	:	Buffer which contains the address (address width bytes, LSB first).
  * 
  * Return		: 	None
  * 
@@ -960,7 +2128,8 @@ NRF24L01_GetRxDataAmount(unsigned char ucDataPipe)
 void 
 NRF24L01_SetTXAddress(unsigned char* address)
 {
-	NRF24L01_RegisterWrite_Multi(RF24_TX_ADDR, (unsigned char*)address, 5);
+	NRF24L01_RegisterWrite_Multi(RF24_TX_ADDR, (unsigned char*)address, g_ucAddressWidth);
+	memcpy(g_ucTxAddress, address, g_ucAddressWidth);
 }
 
 /* PS:
@@ -987,27 +2156,46 @@ NRF24L01_SetTXAddress(unsigned char* address)
 int
 NRF24L01_WaitForTxComplete(char busy_wait)
 {
-	int ret = PDLIB_NRF24_SUCCESS;
-
-	NRF24L01_GetStatus();
+	int ret = NRF24L01_WaitForTxCompleteTimeout(busy_wait ? PDLIB_NRF24_WAIT_FOREVER : 0);
 
 #ifdef PDLIB_DEBUG
 	PrintRegValue("Current status :",g_ucStatus);
 #endif
 
-	if(busy_wait){
-		while((g_ucStatus & (RF24_MAX_RT | RF24_TX_DS)) == 0)
-		{
-			NRF24L01_GetStatus();
-		}
-	}else{
-		if((g_ucStatus & (RF24_MAX_RT | RF24_TX_DS)) == 0){
-			ret = PDLIB_NRF24_ERROR;
-		}
+	if(PDLIB_NRF24_WOULD_BLOCK == ret)
+	{
+		ret = PDLIB_NRF24_ERROR;
 	}
 
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_WaitForTxCompleteTimeout
+ *
+ * Arguments	: 	ulTimeoutUs	:	Timeout in microseconds, 0 to check without waiting
+ * 								or PDLIB_NRF24_WAIT_FOREVER
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				:	TX completed successfully
+ *					PDLIB_NRF24_TX_ARC_REACHED		:	Maximum retransmissions elapsed
+ *					PDLIB_NRF24_WOULD_BLOCK			:	TX not completed (only when ulTimeoutUs = 0)
+ *					PDLIB_NRF24_TIMEOUT				:	TX not completed within the timeout
+ *					PDLIB_NRF24_INVALID_ARGUMENT	:	Timeout needs a clock source
+ *
+ * Description	: 	Same as NRF24L01_WaitForTxComplete() with a bounded wait.
+ * 					A module which lost power never completes the TX, so use a
+ * 					timeout longer than the retransmit time (ARD x ARC).
+ *
+ */
+
+int
+NRF24L01_WaitForTxCompleteTimeout(unsigned long ulTimeoutUs)
+{
+	int ret = _NRF24L01_WaitStatus(RF24_MAX_RT | RF24_TX_DS, ulTimeoutUs);
 
-	if(g_ucStatus & RF24_MAX_RT)
+	if((PDLIB_NRF24_SUCCESS == ret) && (g_ucStatus & RF24_MAX_RT))
 	{
 #ifdef PDLIB_DEBUG
 		PrintRegValue("Maximum retransmissions reached!!! : status >> ",g_ucStatus);
@@ -1102,18 +2290,58 @@ NRF24L01_ClearInterruptFlag(char interrupt_bm)
 
 int NRF24L01_AttemptTx()
 {
-	int ret = PDLIB_NRF24_SUCCESS;
+	return NRF24L01_AttemptTxTimeout(PDLIB_NRF24_WAIT_FOREVER);
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_AttemptTxTimeout
+ *
+ * Arguments	: 	ulTimeoutUs	:	Timeout in microseconds (not 0), or PDLIB_NRF24_WAIT_FOREVER
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				:	TX completed successfully
+ *					PDLIB_NRF24_TX_ARC_REACHED		:	Maximum retransmissions elapsed
+ *					PDLIB_NRF24_TIMEOUT				:	TX not completed within the timeout
+ *					PDLIB_NRF24_INVALID_ARGUMENT	:	Timeout is 0 or needs a clock source, nothing is sent
+ *
+ * Description	: 	Same as NRF24L01_AttemptTx() with a bounded wait. On timeout
+ * 					or an invalid timeout the TX FIFO is flushed, so the caller
+ * 					can submit again.
+ *
+ * 					A timeout of 0 is rejected: a TX can't complete without
+ * 					waiting, and the module would be powered down in the middle
+ * 					of it. Use NRF24L01_AsyncSend() to send without blocking.
+ *
+ * 					Module will be in Power Down mode when it returns.
+ */
+
+int NRF24L01_AttemptTxTimeout(unsigned long ulTimeoutUs)
+{
+	int ret;
 
 #ifdef PDLIB_DEBUG
 	PrintString("Attempting TX...\n\r");
 #endif
 
+	/* PS: Fail before CE is pulsed, so nothing goes out */
+	if((0 == ulTimeoutUs) || ((PDLIB_NRF24_WAIT_FOREVER != ulTimeoutUs) && (NULL == g_pfnClock)))
+	{
+		NRF24L01_FlushTX();
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
 	NRF24L01_EnableTxMode();
 
-	ret = NRF24L01_WaitForTxComplete(1);
+	ret = NRF24L01_WaitForTxCompleteTimeout(ulTimeoutUs);
 
 	NRF24L01_DisableTxMode();
 
+	if(PDLIB_NRF24_TIMEOUT == ret)
+	{
+		NRF24L01_FlushTX();
+	}
+
 	NRF24L01_PowerDown();
 
 	return ret;
@@ -1124,11 +2352,11 @@ int NRF24L01_AttemptTx()
  * Function		: 	NRF24L01_SetRXAddress
  * 
  * Arguments	: 	ucDataPipe	:	Data pipe number
- * 					pucAddress	:	Buffer which contains the one/five bytes to put to address.
+ * 					pucAddress	:	Buffer which contains the one/address width bytes to put to address.
  * 
  * Return		: 	None
  * 
- * Description	: 	Set the RX address. P0 and P1 pipes have 5 byte address
+ * Description	: 	Set the RX address. P0 and P1 pipes have full width address
  * 					other pipes have 1 byte address(LSB). Other bytes are taken from
  * 					the P1 pipe address.
  * 
@@ -1144,7 +2372,7 @@ NRF24L01_SetRxAddress(	unsigned char ucDataPipe,
 		{
 			case 0:
 			case 1:
-				NRF24L01_RegisterWrite_Multi((RF24_RX_ADDR_P0 + ucDataPipe), pucAddress, 5);
+				NRF24L01_RegisterWrite_Multi((RF24_RX_ADDR_P0 + ucDataPipe), pucAddress, g_ucAddressWidth);
 				break;
 			case 2:
 			case 3:
@@ -1176,7 +2404,7 @@ void
 NRF24L01_SetRXPacketSize(	unsigned char ucDataPipe,
 							unsigned char ucPacketSize)
 {
-	if(ucPacketSize < 32)
+	if((ucPacketSize <= 32) && (ucDataPipe < 6))
 	{
 		NRF24L01_RegisterWrite_8((RF24_RX_PW_P0 + ucDataPipe), ucPacketSize);
 	}
@@ -1238,11 +2466,56 @@ NRF24L01_SetTxPayload(	char* pcData,
 		}
 	}else
 	{
-		ret = PDLIB_NRF24_ERROR;
+		ret = PDLIB_NRF24_ERROR;
+	}
+
+
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_SetTxPayloadV
+ *
+ * Arguments	: 	psVec		:	Segments of the payload, ie. header and body
+ * 					uiCount		:	Number of segments
+ *
+ * Return		: 	PDLIB_NRF24_TX_FIFO_FULL 		: Tx FIFO full
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	: Total length is 0 or more than 32
+ * 					PDLIB_NRF24_SUCCESS				: Success
+ *
+ * Description	: 	Set the TX payload from several buffers. The segments are
+ * 					streamed to the module in one W_TX_PAYLOAD command, so the
+ * 					payload doesn't need to be assembled in a staging buffer.
+ *
+ */
+
+int
+NRF24L01_SetTxPayloadV(	const NRF24L01_IOVec *psVec,
+						unsigned int uiCount)
+{
+	unsigned int uiLength = 0;
+	unsigned int i;
+
+	for(i = 0; (NULL != psVec) && (i < uiCount); i++)
+	{
+		uiLength += psVec[i].uiLength;
+	}
+
+	if((0 == uiLength) || (uiLength > 32))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	if(NRF24L01_IsTxFifoFull())
+	{
+		return PDLIB_NRF24_TX_FIFO_FULL;
 	}
 
+	NRF24L01_SendCommandV(RF24_W_TX_PAYLOAD, psVec, uiCount);
 
-	return ret;
+	return PDLIB_NRF24_SUCCESS;
 }
 
 
@@ -1288,11 +2561,14 @@ NRF24L01_EnableFeatureAckPL()
  *
  * Function		: 	NRF24L01_EnableFeatureDynPL
  *
- * Arguments	: 	pipe : Pipe number to enable the feature
+ * Arguments	: 	pipe : Pipe number to enable the feature (0 ~ 5)
  *
  * Return		: 	None
  *
- * Description	: 	Enable dynamic payload
+ * Description	: 	Enable dynamic payload for a pipe. Other pipes keep their
+ * 					mode, so static and dynamic payload pipes can be mixed.
+ * 					Auto ack should be enabled on the pipe. Nothing is changed
+ * 					for an invalid pipe.
  *
  */
 
@@ -1301,6 +2577,12 @@ NRF24L01_EnableFeatureDynPL(unsigned char pipe)
 {
 	char data = 0x73;
 
+	/* PS: No register is touched for an invalid pipe */
+	if(pipe > PDLIB_NRF24_PIPE5)
+	{
+		return;
+	}
+
 	if((internal_states & INTERNAL_STATE_STAND_BY) || (0 == (internal_states & INTERNAL_STATE_POWER_UP)))
 	{
 		/* PS: Check whether features register is activated */
@@ -1319,14 +2601,9 @@ NRF24L01_EnableFeatureDynPL(unsigned char pipe)
 			NRF24L01_RegisterWrite_8(RF24_FEATURE, (data | RF24_EN_DPL));
 		}
 
-		if(pipe <= 6)
-		{
-			/* PS: Check whether DYN-PD for 'pipe' is activated */
-			data = NRF24L01_RegisterRead_8(RF24_DYNPD);
-
-			if(0 == (data & pipe)){
-				NRF24L01_RegisterWrite_8(RF24_DYNPD, (data | (1 << pipe)));
-			}
+		/* PS: Check whether DYN-PD for 'pipe' is activated */
+		if(0 == (g_ucDynPLPipes & (1 << pipe))){
+			NRF24L01_RegisterWrite_8(RF24_DYNPD, (g_ucDynPLPipes | (1 << pipe)));
 		}
 
 		internal_states |= INTERNAL_STATE_DYNPL;
@@ -1373,6 +2650,32 @@ NRF24L01_EnableFeatureNoAckTx()
 }
 
 
+/* PS:
+ *
+ * Function		: 	NRF24L01_DisableFeatureDynPL
+ *
+ * Arguments	: 	pipe : Pipe number to disable the feature (0 ~ 5)
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Puts a pipe back to static payload mode. The payload width
+ * 					should be set using NRF24L01_SetRXPacketSize().
+ *
+ */
+
+void
+NRF24L01_DisableFeatureDynPL(unsigned char pipe)
+{
+	if((pipe < 6) && (g_ucDynPLPipes & (1 << pipe)))
+	{
+		if((internal_states & INTERNAL_STATE_STAND_BY) || (0 == (internal_states & INTERNAL_STATE_POWER_UP)))
+		{
+			NRF24L01_RegisterWrite_8(RF24_DYNPD, (g_ucDynPLPipes & ~(1 << pipe)));
+		}
+	}
+}
+
+
 // PS: Implement TX reuse feature
 		// TODO
 
@@ -1484,6 +2787,32 @@ NRF24L01_ReadRxPayload(	char* pcData,
 {
 	NRF24L01_SendRcvCommand(RF24_R_RX_PAYLOAD, pcData, cLength);
 }
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_ReadRxPayloadV
+ *
+ * Arguments	:	psVec [out]		:	Buffers for the parts of the payload, ie. header and body
+ * 					uiCount			:	Number of buffers
+ *
+ * Return		:	None
+ *
+ * Description	:
+ * 					Reads the top most payload of the RX FIFO into several buffers
+ * 					in one R_RX_PAYLOAD command. The total length of the buffers
+ * 					should be the payload length (NRF24L01_GetRxDataAmount()).
+ *
+ * 					Payload is automatically deleted from the FIFO once it is read.
+ *
+ */
+
+void
+NRF24L01_ReadRxPayloadV(const NRF24L01_IOVec *psVec,
+						unsigned int uiCount)
+{
+	NRF24L01_SendRcvCommandV(RF24_R_RX_PAYLOAD, psVec, uiCount);
+}
  
 
 /* PS:
@@ -1641,7 +2970,7 @@ int NRF24L01_SubmitData(char *pcData, unsigned int uiLength)
 	cTemp = NRF24L01_RegisterRead_8(RF24_EN_AA);
 
 	if(cTemp & RF24_ENAA_P0){
-		NRF24L01_RegisterRead_Multi(RF24_TX_ADDR, address, 5);
+		NRF24L01_RegisterRead_Multi(RF24_TX_ADDR, address, g_ucAddressWidth);
 		NRF24L01_SetRxAddress(PDLIB_NRF24_PIPE0, address);
 	}
 
@@ -1650,6 +2979,38 @@ int NRF24L01_SubmitData(char *pcData, unsigned int uiLength)
 	return ret;
 }
 
+/* PS:
+ *
+ * Function		: 	NRF24L01_SendDataTimeout
+ *
+ * Arguments	: 	pcData		:	Data packet to send
+ * 					ulLength	:	Length of the packet
+ * 					ulTimeoutUs	:	Timeout in microseconds (not 0), or PDLIB_NRF24_WAIT_FOREVER
+ *
+ * Return		:	PDLIB_NRF24_SUCCESS				: Success
+ * 					PDLIB_NRF24_TX_FIFO_FULL 		: Tx FIFO full
+ *					PDLIB_NRF24_TX_ARC_REACHED		: Maximum retransmissions elapsed
+ *					PDLIB_NRF24_TIMEOUT				: TX not completed within the timeout
+ *					PDLIB_NRF24_INVALID_ARGUMENT	: Timeout is 0 or needs a clock source
+ *
+ * Description	: 	Same as NRF24L01_SendData() with a bounded wait.
+ *
+ */
+
+int NRF24L01_SendDataTimeout(char *pcData, unsigned int uiLength, unsigned long ulTimeoutUs)
+{
+	int ret;
+
+	ret = NRF24L01_SubmitData(pcData, uiLength);
+
+	if(ret == PDLIB_NRF24_SUCCESS)
+	{
+		ret = NRF24L01_AttemptTxTimeout(ulTimeoutUs);
+	}
+
+	return ret;
+}
+
 /* PS:
  *
  * Function		: 	NRF24L01_SendDataTo
@@ -1713,6 +3074,17 @@ NRF24L01_RegisterWrite_8(unsigned char ucRegister, unsigned char ucValue)
 	
 	ucData[0] = (RF24_W_REGISTER | ucRegister);
 	ucData[1] = ucValue;
+
+	if(RF24_CONFIG == ucRegister)
+	{
+		g_ucConfig = ucValue;
+	}else if(RF24_DYNPD == ucRegister)
+	{
+		g_ucDynPLPipes = ucValue & 0x3F;
+	}else if((ucRegister >= RF24_RX_PW_P0) && (ucRegister <= RF24_RX_PW_P5))
+	{
+		g_ucRxPayloadWidth[ucRegister - RF24_RX_PW_P0] = ucValue & 0x3F;
+	}
 	
 	_NRF24L01_CSNLow();
 	
@@ -1751,23 +3123,250 @@ NRF24L01_RegisterWrite_Multi(	unsigned char ucRegister,
 {
 	if(NULL != pucData)
 	{
-		unsigned char *pucBuffer = (unsigned char*) malloc(sizeof(unsigned char) * (uiLength));
-		
-		if(NULL != pucBuffer)
-		{
-			memcpy(pucBuffer, pucData, uiLength);
-
-			_NRF24L01_CSNLow();
+		_NRF24L01_CSNLow();
 
 #ifdef PDLIB_SPI
-			g_ucStatus = pdlibSPI_TransferByte(RF24_W_REGISTER | ucRegister);
-			pdlibSPI_SendData(pucBuffer, uiLength);
+		g_ucStatus = pdlibSPI_TransferByte(RF24_W_REGISTER | ucRegister);
+		pdlibSPI_SendData(pucData, uiLength);
 #endif
-			_NRF24L01_CSNHigh();
+		_NRF24L01_CSNHigh();
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_RegisterWriteList
+ *
+ * Arguments	: 	pucList		:	Write list. Sequence of {register, length, data[length]}
+ * 					uiLength	:	Total length of the write list in bytes
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Streams a precomputed list of register writes to the module,
+ * 					for example a register image built by nrf24::MakeImage().
+ * 					Features are activated before FEATURE or DYNPD is written and
+ * 					the internal state is updated from the FEATURE value.
+ *
+ * 					The module should be in Power Down or Standby mode.
+ *
+ */
+
+void
+NRF24L01_RegisterWriteList(	const unsigned char *pucList,
+							unsigned int uiLength)
+{
+	unsigned int uiIndex = 0;
+	unsigned char ucRegister;
+	unsigned char ucCount;
+	char cActivate = 0x73;
+
+	while((NULL != pucList) && ((uiIndex + 2) <= uiLength))
+	{
+		ucRegister = pucList[uiIndex];
+		ucCount = pucList[uiIndex + 1];
+		uiIndex += 2;
+
+		if((uiIndex + ucCount) > uiLength)
+		{
+			break;
+		}
+
+		if(((RF24_FEATURE == ucRegister) || (RF24_DYNPD == ucRegister)) &&
+			(0 == (internal_states & INTERNAL_STATE_FEATURE_ENABLED)))
+		{
+			NRF24L01_SendCommand(RF24_ACTIVATE, &cActivate, 1);
+			internal_states |= INTERNAL_STATE_FEATURE_ENABLED;
+		}
+
+		if(1 == ucCount)
+		{
+			NRF24L01_RegisterWrite_8(ucRegister, pucList[uiIndex]);
+		}else
+		{
+			NRF24L01_RegisterWrite_Multi(ucRegister, (unsigned char*)&pucList[uiIndex], ucCount);
+		}
+
+		if((RF24_TX_ADDR == ucRegister) && (ucCount <= 5))
+		{
+			memcpy(g_ucTxAddress, &pucList[uiIndex], ucCount);
+		}
+
+		if((RF24_SETUP_AW == ucRegister) && (pucList[uiIndex] & 0x03))
+		{
+			g_ucAddressWidth = (pucList[uiIndex] & 0x03) + 2;
+		}
+
+		if(RF24_FEATURE == ucRegister)
+		{
+			internal_states &= ~(INTERNAL_STATE_DYNPL | INTERNAL_STATE_ACKPL);
+
+			if(pucList[uiIndex] & RF24_EN_DPL)
+			{
+				internal_states |= INTERNAL_STATE_DYNPL;
+			}
+
+			if(pucList[uiIndex] & RF24_EN_ACK_PAY)
+			{
+				internal_states |= INTERNAL_STATE_ACKPL;
+			}
+		}
+
+		uiIndex += ucCount;
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_LoadShadows
+ *
+ * Arguments	: 	None
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Reads the shadowed registers back from the module, so the
+ * 					driver state matches a module which was configured before
+ * 					the MCU reset.
+ *
+ */
+
+static void
+_NRF24L01_LoadShadows()
+{
+	unsigned char ucFeature;
+	unsigned char i;
+
+	g_ucConfig = NRF24L01_RegisterRead_8(RF24_CONFIG);
+
+	/* PS: CE is low after the reset */
+	if(g_ucConfig & RF24_PWR_UP)
+	{
+		internal_states |= (INTERNAL_STATE_POWER_UP | INTERNAL_STATE_STAND_BY);
+	}
+
+	g_ucAddressWidth = (NRF24L01_RegisterRead_8(RF24_SETUP_AW) & 0x03) + 2;
+	NRF24L01_RegisterRead_Multi(RF24_TX_ADDR, g_ucTxAddress, g_ucAddressWidth);
+
+	g_ucDynPLPipes = NRF24L01_RegisterRead_8(RF24_DYNPD) & 0x3F;
+
+	for(i = 0; i < 6; i++)
+	{
+		g_ucRxPayloadWidth[i] = NRF24L01_RegisterRead_8(RF24_RX_PW_P0 + i) & 0x3F;
+	}
+
+	ucFeature = NRF24L01_RegisterRead_8(RF24_FEATURE);
+
+	internal_states &= ~(INTERNAL_STATE_DYNPL | INTERNAL_STATE_ACKPL);
+
+	if(ucFeature & RF24_EN_DPL)
+	{
+		internal_states |= INTERNAL_STATE_DYNPL;
+	}
+
+	if(ucFeature & RF24_EN_ACK_PAY)
+	{
+		internal_states |= INTERNAL_STATE_ACKPL;
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_RegisterSync
+ *
+ * Arguments	: 	pucList		:	Expected configuration as a write list
+ * 									(see NRF24L01_RegisterWriteList())
+ * 					uiLength	:	Length of the write list in bytes
+ *
+ * Return		: 	Number of registers rewritten
+ * 					PDLIB_NRF24_ERROR	:	Module does not answer
+ *
+ * Description	: 	Reads each register of the write list from the active
+ * 					module and writes only the ones which differ. The FIFOs
+ * 					are not touched and STATUS entries are skipped, so a
+ * 					received payload survives. The driver state is loaded from
+ * 					the module afterwards.
+ *
+ * 					ACTIVATE toggles the features on the nRF24L01, so it is
+ * 					only sent when a FEATURE/DYNPD write does not read back.
+ *
+ */
+
+int
+NRF24L01_RegisterSync(const unsigned char *pucList, unsigned int uiLength)
+{
+	unsigned char pucCurrent[5];
+	unsigned int uiIndex = 0;
+	unsigned char ucRegister;
+	unsigned char ucCount;
+	unsigned char ucValue;
+	char cActivate = 0x73;
+	int iWritten = 0;
+
+	/* PS: SETUP_AW is 1..3 on a module which answers, a floating MISO reads 0x00 or 0xFF */
+	ucValue = NRF24L01_RegisterRead_8(RF24_SETUP_AW);
+
+	if((0 == ucValue) || (ucValue > 0x03))
+	{
+		return PDLIB_NRF24_ERROR;
+	}
+
+	if(NRF24L01_RegisterRead_8(RF24_FEATURE))
+	{
+		internal_states |= INTERNAL_STATE_FEATURE_ENABLED;
+	}
+
+	while((NULL != pucList) && ((uiIndex + 2) <= uiLength))
+	{
+		ucRegister = pucList[uiIndex];
+		ucCount = pucList[uiIndex + 1];
+		uiIndex += 2;
+
+		if((uiIndex + ucCount) > uiLength)
+		{
+			break;
+		}
+
+		if((0 == ucCount) || (ucCount > 5) || (RF24_STATUS == ucRegister) ||
+		   (RF24_OBSERVE_TX == ucRegister) || (RF24_CD == ucRegister) || (RF24_FIFO_STATUS == ucRegister))
+		{
+			uiIndex += ucCount;
+			continue;
+		}
+
+		NRF24L01_RegisterRead_Multi(ucRegister, pucCurrent, ucCount);
+
+		if(0 != memcmp(pucCurrent, &pucList[uiIndex], ucCount))
+		{
+			if((RF24_FEATURE == ucRegister) || (RF24_DYNPD == ucRegister))
+			{
+				ucValue = pucList[uiIndex];
+
+				NRF24L01_RegisterWrite_8(ucRegister, ucValue);
 
-			free(pucBuffer);
+				if((NRF24L01_RegisterRead_8(ucRegister) != ucValue) &&
+				   (0 == (internal_states & INTERNAL_STATE_FEATURE_ENABLED)))
+				{
+					NRF24L01_SendCommand(RF24_ACTIVATE, &cActivate, 1);
+					internal_states |= INTERNAL_STATE_FEATURE_ENABLED;
+
+					NRF24L01_RegisterWrite_8(ucRegister, ucValue);
+				}
+			}else
+			{
+				NRF24L01_RegisterWriteList(&pucList[uiIndex - 2], ucCount + 2);
+			}
+
+			iWritten++;
 		}
+
+		uiIndex += ucCount;
 	}
+
+	_NRF24L01_LoadShadows();
+
+	return iWritten;
 }
 
 
@@ -1859,6 +3458,8 @@ NRF24L01_RegisterRead_Multi(	unsigned char ucRegister,
  * 					If there is no payload for the command set the pucData NULL and
  * 					make the uiLength as 0
  *
+ * 					The data is streamed from the caller's buffer.
+ *
  */
 
 void
@@ -1866,27 +3467,59 @@ NRF24L01_SendCommand(	unsigned char ucCommand,
 						char *pcData,
 						unsigned int uiLength)
 {
-	unsigned char *pucBuffer = (unsigned char*) malloc(sizeof(unsigned char) * (uiLength + 1));
+	_NRF24L01_CSNLow();
+
+#ifdef PDLIB_SPI
+	g_ucStatus = pdlibSPI_TransferByte(ucCommand);
 
-	if(NULL != pucBuffer)
+	if(NULL != pcData)
 	{
-		pucBuffer[0] = ucCommand;
+		pdlibSPI_SendData((unsigned char*)pcData, uiLength);
+	}
+#endif
 
-		if(NULL != pcData)
-		{
-			memcpy(&pucBuffer[1], pcData, uiLength);
-		}
+	_NRF24L01_CSNHigh();
+}
 
-		_NRF24L01_CSNLow();
 
-#ifdef PDLIB_SPI
-		pdlibSPI_SendData(pucBuffer, uiLength+1);
-#endif
+/* PS:
+ *
+ * Function		: 	NRF24L01_SendCommandV
+ *
+ * Arguments	: 	ucCommand	:	Command to send.
+ * 					psVec		:	Segments of the data field
+ * 					uiCount		:	Number of segments
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Same as NRF24L01_SendCommand() but the data field is gathered
+ * 					from several buffers in one CSN frame. Segments with a NULL
+ * 					buffer or zero length are skipped.
+ *
+ */
 
-		_NRF24L01_CSNHigh();
+void
+NRF24L01_SendCommandV(	unsigned char ucCommand,
+						const NRF24L01_IOVec *psVec,
+						unsigned int uiCount)
+{
+	unsigned int i;
 
-		free(pucBuffer);
+	_NRF24L01_CSNLow();
+
+#ifdef PDLIB_SPI
+	g_ucStatus = pdlibSPI_TransferByte(ucCommand);
+
+	for(i = 0; (NULL != psVec) && (i < uiCount); i++)
+	{
+		if(NULL != psVec[i].pcData)
+		{
+			pdlibSPI_SendData((unsigned char*)psVec[i].pcData, psVec[i].uiLength);
+		}
 	}
+#endif
+
+	_NRF24L01_CSNHigh();
 }
 
 
@@ -1927,6 +3560,54 @@ void NRF24L01_SendRcvCommand(unsigned char ucCommand, char *pcData, unsigned int
 }
 
 
+/* PS:
+ *
+ * Function		: 	NRF24L01_SendRcvCommandV
+ *
+ * Arguments	: 	ucCommand	:	Command to send.
+ * 					psVec		:	Buffers to scatter the reply to
+ * 					uiCount		:	Number of buffers
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Same as NRF24L01_SendRcvCommand() but the reply is stored to
+ * 					several buffers in order, in one CSN frame. A segment with a
+ * 					NULL buffer discards its bytes.
+ *
+ */
+
+void
+NRF24L01_SendRcvCommandV(	unsigned char ucCommand,
+							const NRF24L01_IOVec *psVec,
+							unsigned int uiCount)
+{
+	unsigned int i;
+	unsigned int j;
+	unsigned char ucData;
+
+	_NRF24L01_CSNLow();
+
+#ifdef PDLIB_SPI
+	g_ucStatus = pdlibSPI_TransferByte(ucCommand);
+
+	for(i = 0; (NULL != psVec) && (i < uiCount); i++)
+	{
+		for(j = 0; j < psVec[i].uiLength; j++)
+		{
+			ucData = pdlibSPI_TransferByte(RF24_NOP);
+
+			if(NULL != psVec[i].pcData)
+			{
+				psVec[i].pcData[j] = ucData;
+			}
+		}
+	}
+#endif
+
+	_NRF24L01_CSNHigh();
+}
+
+
 // ----------------  Hardware Pin Control ------------------ //
 
 
@@ -1947,6 +3628,8 @@ _NRF24L01_CELow()
 {
 #ifdef PART_LM4F120H5QR
 	ROM_GPIOPinWrite(g_ulCEBase, g_ulCEPin, 0x00);
+#elif defined(PDLIB_NRF24_EMU)
+	NRF24L01_EmuSetCE(0);
 #endif
 
 	if(internal_states & INTERNAL_STATE_POWER_UP){
@@ -1974,6 +3657,8 @@ _NRF24L01_CEHigh()
 {
 #ifdef PART_LM4F120H5QR
 	ROM_GPIOPinWrite(g_ulCEBase, g_ulCEPin, 0xFF);
+#elif defined(PDLIB_NRF24_EMU)
+	NRF24L01_EmuSetCE(1);
 #endif
 
 	if(internal_states & INTERNAL_STATE_POWER_UP){
@@ -1999,6 +3684,8 @@ _NRF24L01_CSNLow()
 {
 #ifdef PART_LM4F120H5QR
 	ROM_GPIOPinWrite(g_ulCSNBase, g_ulCSNPin, 0x00);
+#elif defined(PDLIB_NRF24_EMU)
+	NRF24L01_EmuSetCSN(0);
 #endif
 }
 
@@ -2020,6 +3707,8 @@ _NRF24L01_CSNHigh()
 {
 #ifdef PART_LM4F120H5QR
 	ROM_GPIOPinWrite(g_ulCSNBase, g_ulCSNPin, 0xFF);
+#elif defined(PDLIB_NRF24_EMU)
+	NRF24L01_EmuSetCSN(1);
 #endif
 }
 
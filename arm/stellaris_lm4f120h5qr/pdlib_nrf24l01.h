@@ -14,6 +14,19 @@
 #define PDLIB_NRF24_TX_ARC_REACHED		-3
 #define PDLIB_NRF24_INVALID_ARGUMENT	-4
 #define PDLIB_NRF24_BUFFER_TOO_SMALL	-5
+#define PDLIB_NRF24_QUEUE_FULL			-6
+#define PDLIB_NRF24_CRC_ERROR			-7
+#define PDLIB_NRF24_TIMEOUT				-8
+#define PDLIB_NRF24_WOULD_BLOCK			-9
+#define PDLIB_NRF24_BUSY				-10
+
+/* PS: Timeout value for the *Timeout() functions to wait without a limit */
+#define PDLIB_NRF24_WAIT_FOREVER		0xFFFFFFFFUL
+
+/* PS: Standby -> RX/TX settling */
+#ifndef PDLIB_NRF24_TSTBY2A_US
+#define PDLIB_NRF24_TSTBY2A_US		130
+#endif
 
 #define PDLIB_NRF24_PIPE0	0
 #define PDLIB_NRF24_PIPE1	1
@@ -22,20 +35,76 @@
 #define PDLIB_NRF24_PIPE4	4
 #define PDLIB_NRF24_PIPE5	5
 
+/* PS: Highest node ID accepted by NRF24L01_MakeAddress() */
+#define PDLIB_NRF24_MAX_NODE	237
+
+/* PS: Hardware CRC modes, value is the number of CRC bytes */
+#define PDLIB_NRF24_CRC_NONE	0
+#define PDLIB_NRF24_CRC_1BYTE	1
+#define PDLIB_NRF24_CRC_2BYTE	2
+
+#define PDLIB_NRF24_CRC16_INIT	0xFFFF
+
 #define PDLIB_INTERRUPT_MAX_RT		1 << 0
 #define PDLIB_INTERRUPT_DATA_SENT	1 << 1
 #define PDLIB_INTERRUPT_DATA_READY	1 << 2
 
+/* PS: Free running microsecond counter and idle hook for the wait functions */
+typedef unsigned long (*NRF24L01_ClockFn)();
+typedef void (*NRF24L01_IdleFn)();
+
+/* PS: One segment of a payload, for the gather/scatter APIs */
+typedef struct
+{
+	char *pcData;
+	unsigned int uiLength;
+} NRF24L01_IOVec;
+
+/* PS: Context of one module. Used when more than one module is connected */
+typedef struct
+{
+	unsigned long ulCEBase;
+	unsigned long ulCEPin;
+	unsigned long ulCSNBase;
+	unsigned long ulCSNPin;
+	unsigned char ucSSIIndex;
+	unsigned char ucStatus;
+	unsigned char ucTxAddress[5];
+	unsigned char ucAddressWidth;
+	unsigned char ucConfig;
+	unsigned char ucDynPLPipes;
+	unsigned char ucRxPayloadWidth[6];
+	unsigned long ulIRQBase;
+	unsigned long ulIRQPin;
+	unsigned int uiInternalStates;
+} NRF24L01_Device;
+
 /* PS: Function prototypes */
 
 /* PS: Basic APIs */
 void NRF24L01_Init(unsigned long ulCEBase, unsigned long ulCEPin, unsigned long ulCEPeriph, unsigned long ulCSNBase, unsigned long ulCSNPin, unsigned long ulCSNPeriph, unsigned char ucSSIIndex);
+int NRF24L01_WarmInit(unsigned long ulCEBase, unsigned long ulCEPin, unsigned long ulCEPeriph, unsigned long ulCSNBase, unsigned long ulCSNPin, unsigned long ulCSNPeriph, unsigned char ucSSIIndex, const unsigned char *pucList, unsigned int uiLength);
 int NRF24L01_SendData(char *pcData, unsigned int uiLength);
 int NRF24L01_SendDataTo(unsigned char *address, char *pcData, unsigned int uiLength);
 int NRF24L01_WaitForDataRx(char *pcPipeNo);
 char NRF24L01_GetRxDataAmount(unsigned char ucDataPipe);
 int NRF24L01_GetData(char pipe, char* pcData, char *length);
 
+/* PS: Bounded and non blocking waits */
+void NRF24L01_SetClockSource(NRF24L01_ClockFn pfnClock);
+NRF24L01_ClockFn NRF24L01_GetClockSource();
+void NRF24L01_SetIdleHook(NRF24L01_IdleFn pfnIdle);
+unsigned long NRF24L01_GetTimeUs();
+int NRF24L01_SendDataTimeout(char *pcData, unsigned int uiLength, unsigned long ulTimeoutUs);
+int NRF24L01_WaitForDataRxTimeout(char *pcPipeNo, unsigned long ulTimeoutUs);
+int NRF24L01_PollDataRx(char *pcPipeNo);
+
+/* PS: Multiple module APIs */
+void NRF24L01_InitDevice(NRF24L01_Device *psDevice, unsigned long ulCEBase, unsigned long ulCEPin, unsigned long ulCEPeriph, unsigned long ulCSNBase, unsigned long ulCSNPin, unsigned long ulCSNPeriph, unsigned char ucSSIIndex);
+int NRF24L01_WarmInitDevice(NRF24L01_Device *psDevice, unsigned long ulCEBase, unsigned long ulCEPin, unsigned long ulCEPeriph, unsigned long ulCSNBase, unsigned long ulCSNPin, unsigned long ulCSNPeriph, unsigned char ucSSIIndex, const unsigned char *pucList, unsigned int uiLength);
+void NRF24L01_SelectDevice(NRF24L01_Device *psDevice);
+NRF24L01_Device *NRF24L01_GetActiveDevice();
+
 /* Intermediate APIs */
 /* PS: Configuration APIs */
 
@@ -47,16 +116,29 @@ void NRF24L01_InterruptInit(unsigned long ulIRQBase, unsigned long ulIRQPin, uns
 
 void NRF24L01_PowerDown();
 void NRF24L01_PowerUp();
+unsigned char NRF24L01_IsPoweredUp();
 void NRF24L01_SetAirDataRate(unsigned char ucDataRate);
 void NRF24L01_SetLNAGain(unsigned char ucLNAGain);
 void NRF24L01_SetPAGain(int iPAGain);
+int NRF24L01_GetPAGain();
 void NRF24L01_SetRFChannel(unsigned char ucRFChannel);
 void NRF24L01_SetARC(unsigned char ucVal);
 void NRF24L01_SetARD(unsigned short ucVal);
 void NRF24L01_SetAddressWidth(unsigned char ucVal);
+unsigned char NRF24L01_GetAddressWidth();
+int NRF24L01_MakeAddress(unsigned long ulNetwork, unsigned char ucNode, unsigned char *pucAddress);
+int NRF24L01_SetCRCMode(unsigned char ucMode);
+unsigned char NRF24L01_GetCRCMode();
+unsigned int NRF24L01_GetAirTime(unsigned char ucPayloadLength);
 unsigned char NRF24L01_GetStatus();
 
+#ifdef PDLIB_SPI
+unsigned long NRF24L01_TuneSPIClock(unsigned long ulMaxBitRate);
+unsigned long NRF24L01_VerifySPIClock();
+#endif
+
 void NRF24L01_EnableFeatureDynPL(unsigned char pipe);
+void NRF24L01_DisableFeatureDynPL(unsigned char pipe);
 void NRF24L01_EnableFeatureAckPL();
 void NRF24L01_EnableFeatureNoAckTx();
 char NRF24L01_GetInterruptState();
@@ -66,6 +148,7 @@ void NRF24L01_ClearInterruptFlag(char interrupt_bm);
 void NRF24L01_FlushTX();
 void NRF24L01_SetTXAddress(unsigned char* address);
 int NRF24L01_SetTxPayload(char* pcData, unsigned int uiLength);
+int NRF24L01_SetTxPayloadV(const NRF24L01_IOVec *psVec, unsigned int uiCount);
 int NRF24L01_SubmitData(char *pcData, unsigned int uiLength);
 void NRF24L01_EnableTxMode();
 void NRF24L01_DisableTxMode();
@@ -73,6 +156,8 @@ int NRF24L01_IsTxFifoFull();
 int NRF24L01_IsTxFifoEmpty();
 int NRF24L01_AttemptTx();
 int NRF24L01_WaitForTxComplete(char busy_wait);
+int NRF24L01_WaitForTxCompleteTimeout(unsigned long ulTimeoutUs);
+int NRF24L01_AttemptTxTimeout(unsigned long ulTimeoutUs);
 char NRF24L01_GetAckDataAmount();
 
 /* RX mode related */
@@ -81,8 +166,10 @@ void NRF24L01_SetRxAddress(unsigned char ucDataPipe, unsigned char *pucAddress);
 void NRF24L01_SetRXPacketSize(unsigned char ucDataPipe, unsigned char ucPacketSize);
 void NRF24L01_EnableRxMode();
 void NRF24L01_DisableRxMode();
+int NRF24L01_Turnaround(unsigned char ucRxMode, unsigned char ucSettle);
 int NRF24L01_IsDataReadyRx(char *pcPipeNo);
 void NRF24L01_ReadRxPayload(char* pcData, char cLength);
+void NRF24L01_ReadRxPayloadV(const NRF24L01_IOVec *psVec, unsigned int uiCount);
 int NRF24L01_SetAckPayload(char* pcData, char pipe, unsigned int uiLength);
 unsigned char NRF24L01_CarrierDetect();
 
@@ -91,8 +178,17 @@ unsigned char NRF24L01_RegisterRead_8(unsigned char ucRegister);
 unsigned char NRF24L01_RegisterRead_Multi(unsigned char ucRegister, unsigned char *pucBuffer, unsigned int uiLength);
 void NRF24L01_RegisterWrite_8(unsigned char ucRegister, unsigned char ucValue);
 void NRF24L01_RegisterWrite_Multi(unsigned char ucRegister, unsigned char *pucData, unsigned int uiLength);
+void NRF24L01_RegisterWriteList(const unsigned char *pucList, unsigned int uiLength);
+int NRF24L01_RegisterSync(const unsigned char *pucList, unsigned int uiLength);
 void NRF24L01_SendCommand(unsigned char ucCommand, char *pcData, unsigned int uiLength);
 void NRF24L01_SendRcvCommand(unsigned char ucCommand, char *pcData, unsigned int uiLength);
+void NRF24L01_SendCommandV(unsigned char ucCommand, const NRF24L01_IOVec *psVec, unsigned int uiCount);
+void NRF24L01_SendRcvCommandV(unsigned char ucCommand, const NRF24L01_IOVec *psVec, unsigned int uiCount);
+
+/* PS: Software CRC, for integrity checks inside the payload */
+unsigned short NRF24L01_CRC16(const unsigned char *pucData, unsigned int uiLength, unsigned short usCRC);
+int NRF24L01_AppendCRC16(char *pcData, unsigned int uiLength, unsigned int uiSize);
+int NRF24L01_CheckCRC16(const char *pcData, unsigned int uiLength);
 
 #endif
 
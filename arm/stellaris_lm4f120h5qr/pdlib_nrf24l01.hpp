@@ -0,0 +1,425 @@
+/*
+ * Please find the license in the GIT repo.
+ *
+ * Description:
+ *
+ * Header only C++ front end for the NRF24L01 module on LM4F120H5QR.
+ *
+ * Pins and the SSI module are template parameters, so every CE/CSN
+ * toggle is a single store to the masked GPIODATA address of the pin
+ * and every SPI byte is a store/load of the SSIDR register of a fixed
+ * SSI module. There are no global variables, no ROM calls and no table
+ * look ups in the transfer path.
+ *
+ * The C API (pdlib_nrf24l01.h) is not affected. Both use the register
+ * map in nRF24L01.h. Don't use both APIs on the same module.
+ *
+ * Requires C++14 (see pdlib_nrf24l01_config.hpp).
+ *
+ * Usage:
+ *
+ * 		typedef nrf24::SsiBus<SSI3_BASE, 3> Bus;
+ * 		typedef nrf24::GpioPin<GPIO_PORTE_BASE, GPIO_PIN_1, SYSCTL_PERIPH_GPIOE> Ce;
+ * 		typedef nrf24::GpioPin<GPIO_PORTE_BASE, GPIO_PIN_2, SYSCTL_PERIPH_GPIOE> Csn;
+ * 		typedef nrf24::GpioPin<GPIO_PORTE_BASE, GPIO_PIN_3, SYSCTL_PERIPH_GPIOE> Irq;
+ *
+ * 		typedef nrf24::Radio<Bus, Ce, Csn, Irq> Radio;
+ *
+ * 		Radio::Init();
+ * 		Radio::SetTxAddress(address);
+ * 		Radio::WritePayload(data, 23);
+ * 		Radio::EnableTxMode();
+ *
+ */
+
+#ifndef _PDLIB_NRF24L01_HPP
+#define _PDLIB_NRF24L01_HPP
+
+#include <stdint.h>
+#include "pdlib_nrf24l01_config.hpp"
+
+extern "C" {
+#include "nRF24L01.h"
+#include "pdlib_spi.h"
+#include "inc/hw_types.h"
+#include "inc/hw_memmap.h"
+#include "inc/hw_gpio.h"
+#include "inc/hw_ssi.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/gpio.h"
+#include "driverlib/rom.h"
+}
+
+namespace nrf24
+{
+
+/* PS: GPIO pin. Writes go to the masked GPIODATA address, so only this pin changes */
+template <unsigned long Base, unsigned char Pin, unsigned long Periph>
+struct GpioPin
+{
+	static inline void InitOutput()
+	{
+		ROM_SysCtlPeripheralEnable(Periph);
+		ROM_GPIOPinTypeGPIOOutput(Base, Pin);
+	}
+
+	static inline void InitInput()
+	{
+		ROM_SysCtlPeripheralEnable(Periph);
+		ROM_GPIOPinTypeGPIOInput(Base, Pin);
+	}
+
+	static inline void High()
+	{
+		HWREG(Base + GPIO_O_DATA + (Pin << 2)) = Pin;
+	}
+
+	static inline void Low()
+	{
+		HWREG(Base + GPIO_O_DATA + (Pin << 2)) = 0;
+	}
+
+	static inline bool IsHigh()
+	{
+		return (HWREG(Base + GPIO_O_DATA + (Pin << 2)) != 0);
+	}
+};
+
+/* PS: Use when the IRQ pin is not connected */
+struct NoPin
+{
+	static inline void InitOutput() {}
+	static inline void InitInput() {}
+	static inline void High() {}
+	static inline void Low() {}
+	static inline bool IsHigh() { return true; }
+};
+
+/* PS: SSI module. Index is the pdlib_spi index used to configure the module */
+template <unsigned long Base, unsigned char Index>
+struct SsiBus
+{
+	static inline void Init()
+	{
+		pdlibSPI_ConfigureSPIInterface(Index);
+	}
+
+	static inline uint8_t Transfer(uint8_t ucData)
+	{
+		/* Wait for space in TX FIFO */
+		while(0 == (HWREG(Base + SSI_O_SR) & SSI_SR_TNF));
+
+		HWREG(Base + SSI_O_DR) = ucData;
+
+		/* Wait for the received byte */
+		while(0 == (HWREG(Base + SSI_O_SR) & SSI_SR_RNE));
+
+		return (uint8_t)HWREG(Base + SSI_O_DR);
+	}
+};
+
+/* PS: Module connected to Bus with the given pins. All the members are static, there is no state */
+template <class Bus, class CePin, class CsnPin, class IrqPin = NoPin>
+class Radio
+{
+public:
+
+	static const uint8_t PayloadSize = 32;
+
+	/* PS: Same as NRF24L01_Init() + NRF24L01_RegisterInit() */
+	static void Init()
+	{
+		static constexpr RegisterImage kDefault = MakeImage(Config());
+
+		Bus::Init();
+
+		CePin::InitOutput();
+		CePin::Low();
+
+		CsnPin::InitOutput();
+		CsnPin::High();
+
+		IrqPin::InitInput();
+
+		FlushTx();
+		FlushRx();
+
+		ApplyImage(kDefault);
+	}
+
+	/* PS: Same as NRF24L01_WarmInit(), keeps the RX FIFO of a module which stayed powered. Returns the registers rewritten */
+	static uint8_t WarmInit(const RegisterImage &image)
+	{
+		Bus::Init();
+
+		CePin::InitOutput();
+		CePin::Low();
+
+		CsnPin::InitOutput();
+		CsnPin::High();
+
+		IrqPin::InitInput();
+
+		FlushTx();
+
+		return SyncImage(image);
+	}
+
+	/* PS: Writes only the registers of the image which differ from the module. STATUS entries are skipped */
+	static uint8_t SyncImage(const RegisterImage &image)
+	{
+		uint8_t pucCurrent[5];
+		uint8_t ucWritten = 0;
+		uint8_t ucCount;
+		uint8_t i = 0;
+		uint8_t j;
+
+		while((i + 2) <= image.ucLength)
+		{
+			ucCount = image.pucList[i + 1];
+
+			if((RF24_STATUS != image.pucList[i]) && (ucCount <= 5))
+			{
+				ReadRegister(image.pucList[i], pucCurrent, ucCount);
+
+				for(j = 0; (j < ucCount) && (pucCurrent[j] == image.pucList[i + 2 + j]); j++);
+
+				if(j < ucCount)
+				{
+					/* PS: A non plus module reads them as 0 until activated */
+					if((RF24_FEATURE == image.pucList[i]) || (RF24_DYNPD == image.pucList[i]))
+					{
+						WriteFeature(image.pucList[i], image.pucList[i + 2]);
+					}else
+					{
+						WriteRegister(image.pucList[i], &image.pucList[i + 2], ucCount);
+					}
+
+					ucWritten++;
+				}
+			}
+
+			i += 2 + ucCount;
+		}
+
+		return ucWritten;
+	}
+
+	/* PS: Streams a write list built by nrf24::MakeImage(). Module should be in Power Down or Standby */
+	static void ApplyImage(const RegisterImage &image)
+	{
+		uint8_t i = 0;
+
+		while((i + 2) <= image.ucLength)
+		{
+			if((RF24_FEATURE == image.pucList[i]) || (RF24_DYNPD == image.pucList[i]))
+			{
+				WriteFeature(image.pucList[i], image.pucList[i + 2]);
+			}else
+			{
+				WriteRegister(image.pucList[i], &image.pucList[i + 2], image.pucList[i + 1]);
+			}
+
+			i += 2 + image.pucList[i + 1];
+		}
+	}
+
+	/* PS: Writes FEATURE or DYNPD. The nRF24L01 (non plus) ignores them until ACTIVATE,
+	 * which toggles, so it is sent only if the value does not read back */
+	static void WriteFeature(uint8_t ucRegister, uint8_t ucValue)
+	{
+		static const uint8_t ucActivate = 0x73;
+
+		WriteRegister(ucRegister, ucValue);
+
+		if(ReadRegister(ucRegister) != ucValue)
+		{
+			Command(RF24_ACTIVATE, &ucActivate, 1);
+			WriteRegister(ucRegister, ucValue);
+		}
+	}
+
+	/* PS: Register level access, returns the STATUS register */
+	static inline uint8_t Command(uint8_t ucCommand)
+	{
+		uint8_t ucStatus;
+
+		CsnPin::Low();
+		ucStatus = Bus::Transfer(ucCommand);
+		CsnPin::High();
+
+		return ucStatus;
+	}
+
+	static inline uint8_t Command(uint8_t ucCommand, const uint8_t *pucData, uint8_t ucLength)
+	{
+		uint8_t ucStatus;
+
+		CsnPin::Low();
+		ucStatus = Bus::Transfer(ucCommand);
+
+		while(ucLength--)
+		{
+			Bus::Transfer(*pucData++);
+		}
+
+		CsnPin::High();
+
+		return ucStatus;
+	}
+
+	static inline uint8_t CommandRead(uint8_t ucCommand, uint8_t *pucData, uint8_t ucLength)
+	{
+		uint8_t ucStatus;
+
+		CsnPin::Low();
+		ucStatus = Bus::Transfer(ucCommand);
+
+		while(ucLength--)
+		{
+			*pucData++ = Bus::Transfer(RF24_NOP);
+		}
+
+		CsnPin::High();
+
+		return ucStatus;
+	}
+
+	static inline uint8_t ReadRegister(uint8_t ucRegister)
+	{
+		uint8_t ucValue;
+
+		CommandRead(RF24_R_REGISTER | ucRegister, &ucValue, 1);
+
+		return ucValue;
+	}
+
+	static inline uint8_t ReadRegister(uint8_t ucRegister, uint8_t *pucData, uint8_t ucLength)
+	{
+		return CommandRead(RF24_R_REGISTER | ucRegister, pucData, ucLength);
+	}
+
+	static inline uint8_t WriteRegister(uint8_t ucRegister, uint8_t ucValue)
+	{
+		return Command(RF24_W_REGISTER | ucRegister, &ucValue, 1);
+	}
+
+	static inline uint8_t WriteRegister(uint8_t ucRegister, const uint8_t *pucData, uint8_t ucLength)
+	{
+		return Command(RF24_W_REGISTER | ucRegister, pucData, ucLength);
+	}
+
+	/* PS: Basic operations */
+	static inline uint8_t GetStatus()
+	{
+		return Command(RF24_NOP);
+	}
+
+	static inline void FlushTx()
+	{
+		Command(RF24_FLUSH_TX);
+	}
+
+	static inline void FlushRx()
+	{
+		Command(RF24_FLUSH_RX);
+	}
+
+	static inline void SetRFChannel(uint8_t ucChannel)
+	{
+		WriteRegister(RF24_RF_CH, ucChannel & 0x7F);
+	}
+
+	/* PS: Address width in bytes (3 ~ 5) from SETUP_AW, same as NRF24L01_GetAddressWidth() */
+	static inline uint8_t GetAddressWidth()
+	{
+		uint8_t ucWidth = ReadRegister(RF24_SETUP_AW) & 0x03;
+
+		return ucWidth ? (ucWidth + 2) : 5;
+	}
+
+	/* PS: Address of GetAddressWidth() bytes */
+	static inline void SetTxAddress(const uint8_t *pucAddress)
+	{
+		WriteRegister(RF24_TX_ADDR, pucAddress, GetAddressWidth());
+	}
+
+	/* PS: Pipe 0 and 1 take GetAddressWidth() bytes, the other pipes the LSB */
+	static inline void SetRxAddress(uint8_t ucPipe, const uint8_t *pucAddress)
+	{
+		WriteRegister(RF24_RX_ADDR_P0 + ucPipe, pucAddress, (ucPipe < 2) ? GetAddressWidth() : 1);
+	}
+
+	static inline uint8_t WritePayload(const uint8_t *pucData, uint8_t ucLength)
+	{
+		return Command(RF24_W_TX_PAYLOAD, pucData, ucLength);
+	}
+
+	static inline uint8_t WritePayloadNoAck(const uint8_t *pucData, uint8_t ucLength)
+	{
+		return Command(RF24_W_TX_PAYLOAD_NOACK, pucData, ucLength);
+	}
+
+	static inline uint8_t WriteAckPayload(uint8_t ucPipe, const uint8_t *pucData, uint8_t ucLength)
+	{
+		return Command(RF24_W_ACK_PAYLOAD | (ucPipe & 0x07), pucData, ucLength);
+	}
+
+	static inline uint8_t ReadPayloadWidth()
+	{
+		uint8_t ucWidth;
+
+		CommandRead(RF24_R_RX_PL_WID, &ucWidth, 1);
+
+		return ucWidth;
+	}
+
+	static inline uint8_t ReadPayload(uint8_t *pucData, uint8_t ucLength)
+	{
+		return CommandRead(RF24_R_RX_PAYLOAD, pucData, ucLength);
+	}
+
+	static inline void ClearInterrupts(uint8_t ucMask)
+	{
+		WriteRegister(RF24_STATUS, ucMask & ((RF24_RX_DR) | (RF24_TX_DS) | (RF24_MAX_RT)));
+	}
+
+	/* PS: IRQ pin is active low */
+	static inline bool IsIrqAsserted()
+	{
+		return !IrqPin::IsHigh();
+	}
+
+	/* PS: Mode changes */
+	static inline void PowerUp()
+	{
+		WriteRegister(RF24_CONFIG, ReadRegister(RF24_CONFIG) | (RF24_PWR_UP));
+	}
+
+	static inline void PowerDown()
+	{
+		CePin::Low();
+		WriteRegister(RF24_CONFIG, ReadRegister(RF24_CONFIG) & (uint8_t)~(RF24_PWR_UP));
+	}
+
+	static inline void EnableRxMode()
+	{
+		WriteRegister(RF24_CONFIG, ReadRegister(RF24_CONFIG) | (RF24_PWR_UP) | (RF24_PRIM_RX));
+		CePin::High();
+	}
+
+	static inline void EnableTxMode()
+	{
+		WriteRegister(RF24_CONFIG, (ReadRegister(RF24_CONFIG) | (RF24_PWR_UP)) & (uint8_t)~(RF24_PRIM_RX));
+		CePin::High();
+	}
+
+	static inline void Standby()
+	{
+		CePin::Low();
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,754 @@
+/*
+ * Please find the license in the GIT repo.
+ *
+ * Description:
+ *
+ * Asynchronous operations for super loops without an RTOS. Each
+ * operation is a small state machine which is stepped by NRF24L01_Poll().
+ * A step never waits, the power up (1.5 ms) and RX/TX settling (130 us)
+ * delays are checked against the clock source on the next poll, so the
+ * main loop can do other work in between.
+ *
+ * Completion is reported by the ucDone flag of the operation and, if
+ * given, by a callback which runs inside NRF24L01_Poll().
+ *
+ * Only one operation per module can be in progress. Other driver calls
+ * to that module should not be made until the operation completes.
+ *
+ * Usage:
+ *
+ * [1]. Set the clock source using NRF24L01_SetClockSource()
+ * [2]. Start an operation, ie. NRF24L01_AsyncSend()
+ * [3]. Call NRF24L01_Poll() from the main loop
+ * [4]. Check psOp->ucDone or wait for the callback. The result is in psOp->iResult
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pdlib_nrf24l01_async.h"
+
+#define ASYNC_OP_INIT		0
+#define ASYNC_OP_SET_MODE	1
+#define ASYNC_OP_SEND		2
+#define ASYNC_OP_RECEIVE	3
+
+/* PS: States shared by the operations */
+#define ASYNC_STATE_START		0
+#define ASYNC_STATE_READY		1
+#define ASYNC_STATE_ACTIVE		2
+#define ASYNC_STATE_SETTLE		3
+
+static NRF24L01_AsyncOp *g_psOps = NULL;
+
+/* PS: Counts the NRF24L01_Poll() passes */
+static unsigned char g_ucPass = 0;
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_AsyncDelay
+ *
+ * Arguments	: 	psOp		:	Operation
+ * 					ulDelayUs	:	Delay before the next state runs
+ * 					ucState		:	Next state
+ *
+ * Return		: 	None
+ *
+ */
+
+static void
+_NRF24L01_AsyncDelay(NRF24L01_AsyncOp *psOp, unsigned long ulDelayUs, unsigned char ucState)
+{
+	psOp->ulWaitStart = NRF24L01_GetTimeUs();
+	psOp->ulWaitUs = ulDelayUs;
+	psOp->ucState = ucState;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_AsyncElapsed
+ *
+ * Arguments	: 	ulStart		:	Start time
+ * 					ulUs		:	Duration
+ *
+ * Return		: 	1 if ulUs microseconds have elapsed since ulStart
+ *
+ */
+
+static unsigned char
+_NRF24L01_AsyncElapsed(unsigned long ulStart, unsigned long ulUs)
+{
+	return ((NRF24L01_GetTimeUs() - ulStart) >= ulUs) ? 1 : 0;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_AsyncFinish
+ *
+ * Arguments	: 	psOp		:	Operation
+ * 					iResult		:	Result
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Removes the operation from the list, sets the result and
+ * 					calls the callback.
+ *
+ */
+
+static void
+_NRF24L01_AsyncFinish(NRF24L01_AsyncOp *psOp, int iResult)
+{
+	NRF24L01_AsyncOp **ppsOp = &g_psOps;
+
+	while(*ppsOp)
+	{
+		if(*ppsOp == psOp)
+		{
+			*ppsOp = psOp->psNext;
+			break;
+		}
+
+		ppsOp = &(*ppsOp)->psNext;
+	}
+
+	psOp->iResult = iResult;
+	psOp->ucDone = 1;
+
+	if(psOp->pfnDone)
+	{
+		psOp->pfnDone(psOp, psOp->pvArg);
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_AsyncStart
+ *
+ * Arguments	: 	psOp		:	Operation with the arguments filled in
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				: Operation started
+ * 					PDLIB_NRF24_BUSY				: Another operation is in progress on the module
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	: No clock source
+ *
+ */
+
+static int
+_NRF24L01_AsyncStart(NRF24L01_AsyncOp *psOp)
+{
+	NRF24L01_AsyncOp *psOther;
+
+	if(NULL == NRF24L01_GetClockSource())
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	/* PS: Poll selects the modules of other operations, keep the one active now */
+	if(NULL == psOp->psDevice)
+	{
+		psOp->psDevice = NRF24L01_GetActiveDevice();
+	}
+
+	for(psOther = g_psOps; psOther; psOther = psOther->psNext)
+	{
+		if((psOther == psOp) || (psOther->psDevice == psOp->psDevice))
+		{
+			return PDLIB_NRF24_BUSY;
+		}
+	}
+
+	psOp->ucState = ASYNC_STATE_START;
+	psOp->ucDone = 0;
+	psOp->iResult = PDLIB_NRF24_WOULD_BLOCK;
+	psOp->ulStart = NRF24L01_GetTimeUs();
+
+	/* PS: Started from a callback, the operation is stepped by the next poll */
+	psOp->ucPass = g_ucPass;
+
+	psOp->psNext = g_psOps;
+	g_psOps = psOp;
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_AsyncPowerUp
+ *
+ * Arguments	: 	psOp		:	Operation in ASYNC_STATE_START
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Powers up the module if needed. The operation goes to
+ * 					ASYNC_STATE_READY once the module is in Standby.
+ *
+ */
+
+static void
+_NRF24L01_AsyncPowerUp(NRF24L01_AsyncOp *psOp)
+{
+	if(NRF24L01_IsPoweredUp())
+	{
+		psOp->ucState = ASYNC_STATE_READY;
+	}else
+	{
+		NRF24L01_PowerUp();
+		_NRF24L01_AsyncDelay(psOp, PDLIB_NRF24_TPD2STBY_US, ASYNC_STATE_READY);
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_AsyncTimedOut
+ *
+ * Arguments	: 	psOp		:	Operation
+ *
+ * Return		: 	1 if the timeout of the operation has elapsed
+ *
+ */
+
+static unsigned char
+_NRF24L01_AsyncTimedOut(NRF24L01_AsyncOp *psOp)
+{
+	if(PDLIB_NRF24_WAIT_FOREVER == psOp->ulTimeoutUs)
+	{
+		return 0;
+	}
+
+	return _NRF24L01_AsyncElapsed(psOp->ulStart, psOp->ulTimeoutUs);
+}
+
+
+/* PS: Steps of each operation. Each runs until it has to wait and returns */
+
+static void
+_NRF24L01_AsyncStepInit(NRF24L01_AsyncOp *psOp)
+{
+	switch(psOp->ucState)
+	{
+		case ASYNC_STATE_ACTIVE:
+			if(psOp->pucList)
+			{
+				NRF24L01_RegisterWriteList(psOp->pucList, psOp->uiLength);
+			}else
+			{
+				NRF24L01_RegisterInit();
+			}
+
+			NRF24L01_PowerUp();
+			_NRF24L01_AsyncDelay(psOp, PDLIB_NRF24_TPD2STBY_US, ASYNC_STATE_SETTLE);
+			break;
+
+		case ASYNC_STATE_SETTLE:
+			_NRF24L01_AsyncFinish(psOp, PDLIB_NRF24_SUCCESS);
+			break;
+
+		default:
+			break;
+	}
+}
+
+static void
+_NRF24L01_AsyncStepSetMode(NRF24L01_AsyncOp *psOp)
+{
+	switch(psOp->ucState)
+	{
+		case ASYNC_STATE_START:
+			if(PDLIB_NRF24_MODE_POWER_DOWN == psOp->ucMode)
+			{
+				NRF24L01_PowerDown();
+				_NRF24L01_AsyncFinish(psOp, PDLIB_NRF24_SUCCESS);
+			}else
+			{
+				_NRF24L01_AsyncPowerUp(psOp);
+			}
+			break;
+
+		case ASYNC_STATE_READY:
+			if(PDLIB_NRF24_MODE_RX == psOp->ucMode)
+			{
+				NRF24L01_EnableRxMode();
+				_NRF24L01_AsyncDelay(psOp, PDLIB_NRF24_TSTBY2A_US, ASYNC_STATE_SETTLE);
+			}else if(PDLIB_NRF24_MODE_TX == psOp->ucMode)
+			{
+				NRF24L01_EnableTxMode();
+				_NRF24L01_AsyncDelay(psOp, PDLIB_NRF24_TSTBY2A_US, ASYNC_STATE_SETTLE);
+			}else
+			{
+				NRF24L01_DisableRxMode();
+				_NRF24L01_AsyncFinish(psOp, PDLIB_NRF24_SUCCESS);
+			}
+			break;
+
+		case ASYNC_STATE_SETTLE:
+			_NRF24L01_AsyncFinish(psOp, PDLIB_NRF24_SUCCESS);
+			break;
+
+		default:
+			break;
+	}
+}
+
+static void
+_NRF24L01_AsyncStepSend(NRF24L01_AsyncOp *psOp)
+{
+	int ret;
+
+	switch(psOp->ucState)
+	{
+		case ASYNC_STATE_START:
+			ret = NRF24L01_SubmitData(psOp->pcData, psOp->uiLength);
+
+			if(PDLIB_NRF24_SUCCESS != ret)
+			{
+				_NRF24L01_AsyncFinish(psOp, ret);
+			}else
+			{
+				_NRF24L01_AsyncPowerUp(psOp);
+			}
+			break;
+
+		case ASYNC_STATE_READY:
+			NRF24L01_EnableTxMode();
+			psOp->ucState = ASYNC_STATE_ACTIVE;
+			break;
+
+		case ASYNC_STATE_ACTIVE:
+			ret = NRF24L01_WaitForTxCompleteTimeout(0);
+
+			if(PDLIB_NRF24_WOULD_BLOCK == ret)
+			{
+				if(0 == _NRF24L01_AsyncTimedOut(psOp))
+				{
+					break;
+				}
+
+				ret = PDLIB_NRF24_TIMEOUT;
+			}
+
+			NRF24L01_DisableTxMode();
+			NRF24L01_ClearInterruptFlag(PDLIB_INTERRUPT_MAX_RT | PDLIB_INTERRUPT_DATA_SENT);
+
+			/* PS: The payload stays in the TX FIFO after MAX_RT */
+			if(PDLIB_NRF24_SUCCESS != ret)
+			{
+				NRF24L01_FlushTX();
+			}
+
+			_NRF24L01_AsyncFinish(psOp, ret);
+			break;
+
+		default:
+			break;
+	}
+}
+
+static void
+_NRF24L01_AsyncStepReceive(NRF24L01_AsyncOp *psOp)
+{
+	unsigned char ucPipe;
+	unsigned char ucLength;
+	int ret;
+
+	switch(psOp->ucState)
+	{
+		case ASYNC_STATE_START:
+			_NRF24L01_AsyncPowerUp(psOp);
+			break;
+
+		case ASYNC_STATE_READY:
+			NRF24L01_EnableRxMode();
+			psOp->ucState = ASYNC_STATE_ACTIVE;
+
+			/* PS: RX_DR was cleared, a payload may already be in the RX FIFO */
+			if(0 == (NRF24L01_RegisterRead_8(RF24_FIFO_STATUS) & RF24_RX_EMPTY))
+			{
+				psOp->ucState = ASYNC_STATE_SETTLE;
+			}
+			break;
+
+		case ASYNC_STATE_ACTIVE:
+			if(PDLIB_NRF24_SUCCESS == NRF24L01_PollDataRx(psOp->pcPipeNo))
+			{
+				psOp->ucState = ASYNC_STATE_SETTLE;
+			}else
+			{
+				if(_NRF24L01_AsyncTimedOut(psOp))
+				{
+					NRF24L01_DisableRxMode();
+					_NRF24L01_AsyncFinish(psOp, PDLIB_NRF24_TIMEOUT);
+				}
+				break;
+			}
+
+			/* no break */
+
+		case ASYNC_STATE_SETTLE:
+			NRF24L01_DisableRxMode();
+
+			ucPipe = (NRF24L01_GetStatus() >> 1) & 0x07;
+			ucLength = NRF24L01_GetRxDataAmount(ucPipe);
+
+			if((ucPipe > PDLIB_NRF24_PIPE5) || (0 == ucLength))
+			{
+				ret = PDLIB_NRF24_ERROR;
+			}else if(ucLength > (unsigned char)(*psOp->pcLength))
+			{
+				/* PS: Payload is left in the RX FIFO */
+				ret = PDLIB_NRF24_BUFFER_TOO_SMALL;
+			}else
+			{
+				NRF24L01_ReadRxPayload(psOp->pcData, ucLength);
+
+				*psOp->pcLength = ucLength;
+				*psOp->pcPipeNo = ucPipe;
+				ret = ucLength;
+			}
+
+			NRF24L01_ClearInterruptFlag(PDLIB_INTERRUPT_DATA_READY);
+
+			_NRF24L01_AsyncFinish(psOp, ret);
+			break;
+
+		default:
+			break;
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_AsyncInit
+ *
+ * Arguments	: 	psOp		:	Operation context
+ * 					psDevice	:	Module, NULL for the module active at this call
+ * 					pucList		:	Write list to apply (see NRF24L01_RegisterWriteList()),
+ * 									NULL for the defaults of NRF24L01_RegisterInit()
+ * 					uiLength	:	Length of the write list
+ * 					ulDelayUs	:	Delay before the registers are written, ie.
+ * 									PDLIB_NRF24_TPOR_US right after the supply is turned on
+ * 					pfnDone		:	Completion callback, can be NULL
+ * 					pvArg		:	Argument of the callback
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				: Operation started
+ * 					PDLIB_NRF24_BUSY				: Another operation is in progress on the module
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	: Invalid input argument or no clock source
+ *
+ * Description	: 	Configures the module (after NRF24L01_Init() or
+ * 					NRF24L01_InitDevice()) and powers it up. Completes when the
+ * 					module is in Standby.
+ *
+ */
+
+int
+NRF24L01_AsyncInit(	NRF24L01_AsyncOp *psOp,
+					NRF24L01_Device *psDevice,
+					const unsigned char *pucList,
+					unsigned int uiLength,
+					unsigned long ulDelayUs,
+					NRF24L01_AsyncCallback pfnDone,
+					void *pvArg)
+{
+	int ret;
+
+	if(NULL == psOp)
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	psOp->ucType = ASYNC_OP_INIT;
+	psOp->psDevice = psDevice;
+	psOp->pucList = pucList;
+	psOp->uiLength = uiLength;
+	psOp->ulTimeoutUs = PDLIB_NRF24_WAIT_FOREVER;
+	psOp->pfnDone = pfnDone;
+	psOp->pvArg = pvArg;
+
+	ret = _NRF24L01_AsyncStart(psOp);
+
+	if(PDLIB_NRF24_SUCCESS == ret)
+	{
+		_NRF24L01_AsyncDelay(psOp, ulDelayUs, ASYNC_STATE_ACTIVE);
+	}
+
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_AsyncSetMode
+ *
+ * Arguments	: 	psOp		:	Operation context
+ * 					psDevice	:	Module, NULL for the module active at this call
+ * 					ucMode		:	PDLIB_NRF24_MODE_POWER_DOWN, PDLIB_NRF24_MODE_STANDBY,
+ * 									PDLIB_NRF24_MODE_RX or PDLIB_NRF24_MODE_TX
+ * 					pfnDone		:	Completion callback, can be NULL
+ * 					pvArg		:	Argument of the callback
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				: Operation started
+ * 					PDLIB_NRF24_BUSY				: Another operation is in progress on the module
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	: Invalid input argument or no clock source
+ *
+ * Description	: 	Changes the mode of the module. Powers up the module first if
+ * 					needed. Completes when the module has settled in the new mode.
+ *
+ */
+
+int
+NRF24L01_AsyncSetMode(	NRF24L01_AsyncOp *psOp,
+						NRF24L01_Device *psDevice,
+						unsigned char ucMode,
+						NRF24L01_AsyncCallback pfnDone,
+						void *pvArg)
+{
+	if((NULL == psOp) || (ucMode > PDLIB_NRF24_MODE_TX))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	psOp->ucType = ASYNC_OP_SET_MODE;
+	psOp->psDevice = psDevice;
+	psOp->ucMode = ucMode;
+	psOp->ulTimeoutUs = PDLIB_NRF24_WAIT_FOREVER;
+	psOp->pfnDone = pfnDone;
+	psOp->pvArg = pvArg;
+
+	return _NRF24L01_AsyncStart(psOp);
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_AsyncSend
+ *
+ * Arguments	: 	psOp		:	Operation context
+ * 					psDevice	:	Module, NULL for the module active at this call
+ * 					pcData		:	Data packet to send, must stay valid until the first poll
+ * 					uiLength	:	Length of the packet
+ * 					ulTimeoutUs	:	Timeout in microseconds, or PDLIB_NRF24_WAIT_FOREVER
+ * 					pfnDone		:	Completion callback, can be NULL
+ * 					pvArg		:	Argument of the callback
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				: Operation started
+ * 					PDLIB_NRF24_BUSY				: Another operation is in progress on the module
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	: Invalid input argument or no clock source
+ *
+ * Description	: 	Same as NRF24L01_SendDataTimeout() without blocking. Result is
+ * 					PDLIB_NRF24_SUCCESS, PDLIB_NRF24_TX_FIFO_FULL,
+ * 					PDLIB_NRF24_TX_ARC_REACHED or PDLIB_NRF24_TIMEOUT. The module
+ * 					stays powered up in Standby, so the next send starts faster.
+ *
+ */
+
+int
+NRF24L01_AsyncSend(	NRF24L01_AsyncOp *psOp,
+					NRF24L01_Device *psDevice,
+					char *pcData,
+					unsigned int uiLength,
+					unsigned long ulTimeoutUs,
+					NRF24L01_AsyncCallback pfnDone,
+					void *pvArg)
+{
+	if((NULL == psOp) || (NULL == pcData))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	psOp->ucType = ASYNC_OP_SEND;
+	psOp->psDevice = psDevice;
+	psOp->pcData = pcData;
+	psOp->uiLength = uiLength;
+	psOp->ulTimeoutUs = ulTimeoutUs;
+	psOp->pfnDone = pfnDone;
+	psOp->pvArg = pvArg;
+
+	return _NRF24L01_AsyncStart(psOp);
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_AsyncReceive
+ *
+ * Arguments	: 	psOp				:	Operation context
+ * 					psDevice			:	Module, NULL for the module active at this call
+ * 					pcData [out]		:	Buffer to store the RX data
+ * 					pcLength [in/out]	:	Size of pcData, set to the payload length
+ * 					pcPipeNo [out]		:	Pipe number of the payload
+ * 					ulTimeoutUs			:	Timeout in microseconds, or PDLIB_NRF24_WAIT_FOREVER
+ * 					pfnDone				:	Completion callback, can be NULL
+ * 					pvArg				:	Argument of the callback
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				: Operation started
+ * 					PDLIB_NRF24_BUSY				: Another operation is in progress on the module
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	: Invalid input argument or no clock source
+ *
+ * Description	: 	Puts the module to RX mode and reads the first payload. Result
+ * 					is the payload length, PDLIB_NRF24_BUFFER_TOO_SMALL (payload is
+ * 					left in the RX FIFO) or PDLIB_NRF24_TIMEOUT. The module is in
+ * 					Standby when the operation completes.
+ *
+ */
+
+int
+NRF24L01_AsyncReceive(	NRF24L01_AsyncOp *psOp,
+						NRF24L01_Device *psDevice,
+						char *pcData,
+						char *pcLength,
+						char *pcPipeNo,
+						unsigned long ulTimeoutUs,
+						NRF24L01_AsyncCallback pfnDone,
+						void *pvArg)
+{
+	if((NULL == psOp) || (NULL == pcData) || (NULL == pcLength) || (NULL == pcPipeNo))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	psOp->ucType = ASYNC_OP_RECEIVE;
+	psOp->psDevice = psDevice;
+	psOp->pcData = pcData;
+	psOp->pcLength = pcLength;
+	psOp->pcPipeNo = pcPipeNo;
+	psOp->ulTimeoutUs = ulTimeoutUs;
+	psOp->pfnDone = pfnDone;
+	psOp->pvArg = pvArg;
+
+	return _NRF24L01_AsyncStart(psOp);
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_AsyncCancel
+ *
+ * Arguments	: 	psOp		:	Operation in progress
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Stops the operation and puts the module to Standby. The
+ * 					callback is not called, iResult is PDLIB_NRF24_ERROR.
+ *
+ */
+
+void
+NRF24L01_AsyncCancel(NRF24L01_AsyncOp *psOp)
+{
+	NRF24L01_Device *psActive = NRF24L01_GetActiveDevice();
+	NRF24L01_AsyncOp *psOther;
+
+	for(psOther = g_psOps; psOther; psOther = psOther->psNext)
+	{
+		if(psOther == psOp)
+		{
+			if(psOp->psDevice)
+			{
+				NRF24L01_SelectDevice(psOp->psDevice);
+			}
+
+			NRF24L01_DisableRxMode();
+
+			psOp->pfnDone = NULL;
+			_NRF24L01_AsyncFinish(psOp, PDLIB_NRF24_ERROR);
+			break;
+		}
+	}
+
+	if(psActive && (psActive != NRF24L01_GetActiveDevice()))
+	{
+		NRF24L01_SelectDevice(psActive);
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_Poll
+ *
+ * Arguments	: 	None
+ *
+ * Return		: 	Number of operations still in progress
+ *
+ * Description	: 	Steps every operation in progress whose delay has elapsed.
+ * 					Call from the main loop as often as possible. Callbacks may
+ * 					start new operations. The module active before the call is
+ * 					active again afterwards.
+ *
+ */
+
+unsigned char
+NRF24L01_Poll()
+{
+	NRF24L01_Device *psActive = NRF24L01_GetActiveDevice();
+	NRF24L01_AsyncOp *psOp;
+	unsigned char ucPass = ++g_ucPass;
+	unsigned char ucCount = 0;
+
+	while(1)
+	{
+		/* PS: Callbacks may finish, cancel or start operations, so the list is
+		 * searched again after every step for one not visited in this pass */
+		psOp = g_psOps;
+
+		while(psOp && (ucPass == psOp->ucPass))
+		{
+			psOp = psOp->psNext;
+		}
+
+		if(NULL == psOp)
+		{
+			break;
+		}
+
+		psOp->ucPass = ucPass;
+
+		if((ASYNC_STATE_START == psOp->ucState) || _NRF24L01_AsyncElapsed(psOp->ulWaitStart, psOp->ulWaitUs))
+		{
+			/* PS: Only delays set by _NRF24L01_AsyncDelay() are checked once */
+			psOp->ulWaitUs = 0;
+
+			if(psOp->psDevice)
+			{
+				NRF24L01_SelectDevice(psOp->psDevice);
+			}
+
+			switch(psOp->ucType)
+			{
+				case ASYNC_OP_INIT:
+					_NRF24L01_AsyncStepInit(psOp);
+					break;
+				case ASYNC_OP_SET_MODE:
+					_NRF24L01_AsyncStepSetMode(psOp);
+					break;
+				case ASYNC_OP_SEND:
+					_NRF24L01_AsyncStepSend(psOp);
+					break;
+				case ASYNC_OP_RECEIVE:
+					_NRF24L01_AsyncStepReceive(psOp);
+					break;
+				default:
+					_NRF24L01_AsyncFinish(psOp, PDLIB_NRF24_ERROR);
+					break;
+			}
+		}
+	}
+
+	/* PS: Synchronous calls of the main loop go to the module active before */
+	if(psActive && (psActive != NRF24L01_GetActiveDevice()))
+	{
+		NRF24L01_SelectDevice(psActive);
+	}
+
+	for(psOp = g_psOps; psOp; psOp = psOp->psNext)
+	{
+		ucCount++;
+	}
+
+	return ucCount;
+}
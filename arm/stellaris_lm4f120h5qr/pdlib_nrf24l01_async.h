@@ -0,0 +1,67 @@
+#ifndef _PDLIB_NRF24L01_ASYNC
+#define _PDLIB_NRF24L01_ASYNC
+
+#include "pdlib_nrf24l01.h"
+
+/* Configurations */
+
+/* PS: Power down -> Standby (crystal start up) */
+#ifndef PDLIB_NRF24_TPD2STBY_US
+#define PDLIB_NRF24_TPD2STBY_US		1500
+#endif
+
+/* PS: Supply on -> SPI access */
+#define PDLIB_NRF24_TPOR_US			100000
+
+#define PDLIB_NRF24_MODE_POWER_DOWN	0
+#define PDLIB_NRF24_MODE_STANDBY	1
+#define PDLIB_NRF24_MODE_RX			2
+#define PDLIB_NRF24_MODE_TX			3
+
+typedef struct _NRF24L01_AsyncOp NRF24L01_AsyncOp;
+
+/* PS: Called from NRF24L01_Poll() when the operation completes */
+typedef void (*NRF24L01_AsyncCallback)(NRF24L01_AsyncOp *psOp, void *pvArg);
+
+/* PS: One operation in progress. Owned by the caller, must stay valid until ucDone is set */
+struct _NRF24L01_AsyncOp
+{
+	NRF24L01_Device *psDevice;
+	unsigned char ucType;
+	unsigned char ucState;
+	volatile unsigned char ucDone;
+	int iResult;
+
+	/* PS: Current delay and the overall timeout */
+	unsigned long ulWaitStart;
+	unsigned long ulWaitUs;
+	unsigned long ulStart;
+	unsigned long ulTimeoutUs;
+
+	/* PS: Arguments */
+	char *pcData;
+	unsigned int uiLength;
+	char *pcLength;
+	char *pcPipeNo;
+	const unsigned char *pucList;
+	unsigned char ucMode;
+
+	NRF24L01_AsyncCallback pfnDone;
+	void *pvArg;
+
+	/* PS: Last NRF24L01_Poll() pass which visited the operation */
+	unsigned char ucPass;
+
+	NRF24L01_AsyncOp *psNext;
+};
+
+/* PS: Function prototypes */
+
+int NRF24L01_AsyncInit(NRF24L01_AsyncOp *psOp, NRF24L01_Device *psDevice, const unsigned char *pucList, unsigned int uiLength, unsigned long ulDelayUs, NRF24L01_AsyncCallback pfnDone, void *pvArg);
+int NRF24L01_AsyncSetMode(NRF24L01_AsyncOp *psOp, NRF24L01_Device *psDevice, unsigned char ucMode, NRF24L01_AsyncCallback pfnDone, void *pvArg);
+int NRF24L01_AsyncSend(NRF24L01_AsyncOp *psOp, NRF24L01_Device *psDevice, char *pcData, unsigned int uiLength, unsigned long ulTimeoutUs, NRF24L01_AsyncCallback pfnDone, void *pvArg);
+int NRF24L01_AsyncReceive(NRF24L01_AsyncOp *psOp, NRF24L01_Device *psDevice, char *pcData, char *pcLength, char *pcPipeNo, unsigned long ulTimeoutUs, NRF24L01_AsyncCallback pfnDone, void *pvArg);
+void NRF24L01_AsyncCancel(NRF24L01_AsyncOp *psOp);
+unsigned char NRF24L01_Poll();
+
+#endif
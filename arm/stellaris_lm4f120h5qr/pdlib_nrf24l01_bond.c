@@ -0,0 +1,403 @@
+/*
+ * Please find the license in the GIT repo.
+ *
+ * Description:
+ *
+ * Channel bonding. One logical stream is striped over 2-4 modules,
+ * each module on its own RF channel. The TX side writes packets to the
+ * modules in round robin, so each module runs its own TX FIFO. Every
+ * packet carries a one byte sequence number and the RX side puts the
+ * packets back in order using a bounded reorder buffer.
+ *
+ * Packet format:
+ *
+ * 		[0]		:	Sequence number
+ * 		[1..31]	:	Data
+ *
+ * Usage:
+ *
+ * [1]. Initialize the modules using NRF24L01_InitDevice()
+ * [2]. Call NRF24L01_BondInit() with the same channels and address on both sides
+ * [3]. TX side: NRF24L01_BondSend(), RX side: NRF24L01_BondReceive()
+ * [4]. Call NRF24L01_BondService() from the main loop
+ *
+ * A lost packet holds back the packets after it until the reorder buffer
+ * is full. Call NRF24L01_BondSkipGap() when the stream goes idle to
+ * release them.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pdlib_nrf24l01_bond.h"
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_BondInit
+ *
+ * Arguments	: 	psBond			:	Bond context
+ * 					ppsDevices		:	Initialized modules
+ * 					pucChannels		:	RF channel of each module
+ * 					ucDeviceCount	:	Number of modules (2 ~ 4)
+ * 					pucAddress		:	Address of the RX side (5 bytes)
+ * 					ucRole			:	PDLIB_NRF24_BOND_ROLE_TX or PDLIB_NRF24_BOND_ROLE_RX
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				: Success
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	: Invalid input argument
+ *
+ * Description	: 	Configures all the modules and puts them to TX or RX mode.
+ * 					Modules stay in that mode. Dynamic payload is used.
+ *
+ */
+
+int
+NRF24L01_BondInit(	NRF24L01_Bond *psBond,
+					NRF24L01_Device **ppsDevices,
+					unsigned char *pucChannels,
+					unsigned char ucDeviceCount,
+					unsigned char *pucAddress,
+					unsigned char ucRole)
+{
+	unsigned char i;
+
+	if((ucDeviceCount < 2) || (ucDeviceCount > PDLIB_NRF24_BOND_MAX_DEVICES) ||
+		(NULL == ppsDevices) || (NULL == pucChannels) || (NULL == pucAddress))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	memset(psBond, 0, sizeof(NRF24L01_Bond));
+
+	psBond->ucDeviceCount = ucDeviceCount;
+	psBond->ucRole = ucRole;
+
+	for(i = 0; i < ucDeviceCount; i++)
+	{
+		psBond->psDevices[i] = ppsDevices[i];
+
+		NRF24L01_SelectDevice(ppsDevices[i]);
+		NRF24L01_SetRFChannel(pucChannels[i]);
+
+		if(PDLIB_NRF24_BOND_ROLE_TX == ucRole)
+		{
+			NRF24L01_SetTXAddress(pucAddress);
+			NRF24L01_SetRxAddress(PDLIB_NRF24_PIPE0, pucAddress);
+			NRF24L01_EnableFeatureDynPL(PDLIB_NRF24_PIPE0);
+
+			/* PS: CE stays high, packets are sent as soon as they are written */
+			NRF24L01_EnableTxMode();
+		}else
+		{
+			NRF24L01_SetRxAddress(PDLIB_NRF24_PIPE1, pucAddress);
+			NRF24L01_EnableFeatureDynPL(PDLIB_NRF24_PIPE1);
+
+			NRF24L01_EnableRxMode();
+		}
+	}
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_BondSend
+ *
+ * Arguments	: 	psBond		:	Bond context
+ * 					pcData		:	Data packet to send
+ * 					uiLength	:	Length of the packet (Maximum is 31)
+ *
+ * Return		:	PDLIB_NRF24_SUCCESS				: Success
+ * 					PDLIB_NRF24_TX_FIFO_FULL 		: TX FIFOs of all the modules are full
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	: Invalid input argument
+ *
+ * Description	: 	Writes the packet to the next module which has space in
+ * 					its TX FIFO.
+ *
+ */
+
+int
+NRF24L01_BondSend(	NRF24L01_Bond *psBond,
+					char *pcData,
+					unsigned int uiLength)
+{
+	int ret = PDLIB_NRF24_TX_FIFO_FULL;
+	char cSeq = psBond->ucTxSeq;
+	NRF24L01_IOVec psVec[2];
+	unsigned char ucDevice;
+	unsigned char i;
+
+	if((NULL == pcData) || (0 == uiLength) || (uiLength > PDLIB_NRF24_BOND_PAYLOAD_SIZE))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	/* PS: Sequence number and data are streamed to the module without assembling the packet */
+	psVec[0].pcData = &cSeq;
+	psVec[0].uiLength = 1;
+	psVec[1].pcData = pcData;
+	psVec[1].uiLength = uiLength;
+
+	for(i = 0; i < psBond->ucDeviceCount; i++)
+	{
+		ucDevice = (psBond->ucNextDevice + i) % psBond->ucDeviceCount;
+
+		NRF24L01_SelectDevice(psBond->psDevices[ucDevice]);
+
+		if(PDLIB_NRF24_SUCCESS == NRF24L01_SetTxPayloadV(psVec, 2))
+		{
+			psBond->ucNextDevice = (ucDevice + 1) % psBond->ucDeviceCount;
+			psBond->ucTxSeq++;
+			psBond->pucTxInFlight[ucDevice]++;
+
+			ret = PDLIB_NRF24_SUCCESS;
+			break;
+		}
+	}
+
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_BondReceive
+ *
+ * Arguments	: 	psBond				:	Bond context
+ * 					pcData [out]		:	Allocated buffer to store the RX data
+ * 					length	[in/out]	:	Length in bytes of pcData
+ *
+ * Return		:	Positive						: Number of bytes read
+ * 					PDLIB_NRF24_ERROR				: Next packet in sequence is not received yet
+ * 					PDLIB_NRF24_BUFFER_TOO_SMALL	: Buffer is smaller than the packet
+ *
+ * Description	: 	Gets the next packet of the stream in order.
+ *
+ */
+
+int
+NRF24L01_BondReceive(	NRF24L01_Bond *psBond,
+						char *pcData,
+						char *length)
+{
+	int ret = PDLIB_NRF24_ERROR;
+	NRF24L01_BondSlot *psSlot = &psBond->psSlots[psBond->ucRxSeq % PDLIB_NRF24_BOND_WINDOW];
+
+	if((NULL == pcData) || (NULL == length))
+	{
+		ret = PDLIB_NRF24_INVALID_ARGUMENT;
+	}else if(psSlot->ucValid)
+	{
+		if((*length) >= psSlot->ucLength)
+		{
+			(*length) = psSlot->ucLength;
+			memcpy(pcData, psSlot->pcData, psSlot->ucLength);
+
+			psSlot->ucValid = 0;
+			psBond->ucRxSeq++;
+
+			ret = psSlot->ucLength;
+		}else
+		{
+			ret = PDLIB_NRF24_BUFFER_TOO_SMALL;
+		}
+	}
+
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_BondSkipGap
+ *
+ * Arguments	: 	psBond		:	Bond context
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Gives up on missing packets so that the packets received
+ * 					after them can be read. Skipped packets are counted in
+ * 					ulRxSkipped.
+ *
+ */
+
+void
+NRF24L01_BondSkipGap(NRF24L01_Bond *psBond)
+{
+	unsigned char i;
+
+	/* PS: Nothing to skip if no later packet is waiting */
+	for(i = 1; i < PDLIB_NRF24_BOND_WINDOW; i++)
+	{
+		if(psBond->psSlots[(unsigned char)(psBond->ucRxSeq + i) % PDLIB_NRF24_BOND_WINDOW].ucValid)
+		{
+			break;
+		}
+	}
+
+	if(i < PDLIB_NRF24_BOND_WINDOW)
+	{
+		while(0 == psBond->psSlots[psBond->ucRxSeq % PDLIB_NRF24_BOND_WINDOW].ucValid)
+		{
+			psBond->ucRxSeq++;
+			psBond->ulRxSkipped++;
+		}
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_BondStore
+ *
+ * Arguments	: 	psBond		:	Bond context
+ * 					pcFrame		:	Received packet including the sequence number
+ * 					ucLength	:	Length of the packet
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Puts the packet to the reorder buffer. If the packet is too far
+ * 					ahead, missing packets are skipped to make space. If the oldest
+ * 					packet is not read yet the new packet is dropped.
+ *
+ */
+
+static void
+_NRF24L01_BondStore(NRF24L01_Bond *psBond,
+					char *pcFrame,
+					unsigned char ucLength)
+{
+	unsigned char ucOffset = (unsigned char)(pcFrame[0] - psBond->ucRxSeq);
+	NRF24L01_BondSlot *psSlot;
+
+	/* PS: Packet from the past */
+	if(ucOffset >= 128)
+	{
+		psBond->ulRxDuplicates++;
+		return;
+	}
+
+	while(ucOffset >= PDLIB_NRF24_BOND_WINDOW)
+	{
+		if(psBond->psSlots[psBond->ucRxSeq % PDLIB_NRF24_BOND_WINDOW].ucValid)
+		{
+			psBond->ulRxOverruns++;
+			return;
+		}
+
+		psBond->ucRxSeq++;
+		psBond->ulRxSkipped++;
+		ucOffset--;
+	}
+
+	psSlot = &psBond->psSlots[(unsigned char)pcFrame[0] % PDLIB_NRF24_BOND_WINDOW];
+
+	if(psSlot->ucValid)
+	{
+		psBond->ulRxDuplicates++;
+	}else
+	{
+		memcpy(psSlot->pcData, &pcFrame[1], ucLength - 1);
+		psSlot->ucLength = ucLength - 1;
+		psSlot->ucValid = 1;
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_BondService
+ *
+ * Arguments	: 	psBond		:	Bond context
+ *
+ * Return		: 	None
+ *
+ * Description	: 	TX side: clears the TX interrupts of all the modules. If the
+ * 					maximum retransmissions are reached the TX FIFO of that module
+ * 					is dropped and counted in ulTxLost. When TX_DS is pending too,
+ * 					the acknowledged packets are settled first and only the
+ * 					packets known to be left in the FIFO are counted.
+ *
+ * 					RX side: drains the RX FIFO of all the modules to the
+ * 					reorder buffer.
+ *
+ */
+
+void
+NRF24L01_BondService(NRF24L01_Bond *psBond)
+{
+	char pcFrame[PDLIB_NRF24_BOND_PAYLOAD_SIZE + 1];
+	unsigned char ucStatus;
+	unsigned char ucQueued;
+	unsigned char ucLength;
+	unsigned char i;
+
+	for(i = 0; i < psBond->ucDeviceCount; i++)
+	{
+		NRF24L01_SelectDevice(psBond->psDevices[i]);
+
+		if(PDLIB_NRF24_BOND_ROLE_TX == psBond->ucRole)
+		{
+			ucStatus = NRF24L01_GetStatus();
+
+			if(ucStatus & RF24_MAX_RT)
+			{
+				if(NRF24L01_RegisterRead_8(RF24_FIFO_STATUS) & RF24_FIFO_FULL)
+				{
+					ucQueued = 3;
+				}else if(ucStatus & RF24_TX_DS)
+				{
+					/* PS: TX_DS settles the packets before the failed one. If the FIFO
+					 * isn't full it can't tell how many are left, only the failed one
+					 * is sure to be, so the loss is not over counted */
+					ucQueued = 1;
+				}else
+				{
+					/* PS: Nothing completed since the last clear */
+					ucQueued = (psBond->pucTxInFlight[i] > 2) ? 2 : (psBond->pucTxInFlight[i] ? psBond->pucTxInFlight[i] : 1);
+				}
+
+				/* PS: The flush drops the failed packet and the ones written after it */
+				NRF24L01_FlushTX();
+				psBond->ulTxLost += ucQueued;
+				psBond->pucTxInFlight[i] = 0;
+			}else if(psBond->pucTxInFlight[i])
+			{
+				/* PS: TX_DS is one flag for all the packets sent since the last clear */
+				if(ucStatus & RF24_TX_DS)
+				{
+					psBond->pucTxInFlight[i]--;
+				}
+
+				if(NRF24L01_IsTxFifoEmpty())
+				{
+					psBond->pucTxInFlight[i] = 0;
+				}
+			}
+
+			if(ucStatus & (RF24_MAX_RT | RF24_TX_DS))
+			{
+				NRF24L01_ClearInterruptFlag(PDLIB_INTERRUPT_MAX_RT | PDLIB_INTERRUPT_DATA_SENT);
+			}
+		}else
+		{
+			NRF24L01_ClearInterruptFlag(PDLIB_INTERRUPT_DATA_READY);
+
+			while(0 == (NRF24L01_RegisterRead_8(RF24_FIFO_STATUS) & RF24_RX_EMPTY))
+			{
+				ucLength = NRF24L01_GetRxDataAmount(PDLIB_NRF24_PIPE1);
+
+				if((ucLength < 2) || (ucLength > sizeof(pcFrame)))
+				{
+					NRF24L01_FlushRX();
+					break;
+				}
+
+				NRF24L01_ReadRxPayload(pcFrame, ucLength);
+
+				_NRF24L01_BondStore(psBond, pcFrame, ucLength);
+			}
+		}
+	}
+}
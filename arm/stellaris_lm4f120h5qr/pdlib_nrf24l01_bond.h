@@ -0,0 +1,57 @@
+#ifndef _PDLIB_NRF24L01_BOND
+#define _PDLIB_NRF24L01_BOND
+
+#include "pdlib_nrf24l01.h"
+
+/* Configurations */
+
+#define PDLIB_NRF24_BOND_MAX_DEVICES	4
+
+/* PS: Reorder buffer size in packets. Should be a power of two less than 128 */
+#ifndef PDLIB_NRF24_BOND_WINDOW
+#define PDLIB_NRF24_BOND_WINDOW			16
+#endif
+
+/* PS: One byte of each packet is used for the sequence number */
+#define PDLIB_NRF24_BOND_PAYLOAD_SIZE	31
+
+#define PDLIB_NRF24_BOND_ROLE_TX		0
+#define PDLIB_NRF24_BOND_ROLE_RX		1
+
+typedef struct
+{
+	char pcData[PDLIB_NRF24_BOND_PAYLOAD_SIZE];
+	unsigned char ucLength;
+	unsigned char ucValid;
+} NRF24L01_BondSlot;
+
+/* PS: One logical stream striped over several modules, each on its own channel */
+typedef struct
+{
+	NRF24L01_Device *psDevices[PDLIB_NRF24_BOND_MAX_DEVICES];
+	unsigned char ucDeviceCount;
+	unsigned char ucRole;
+
+	/* PS: TX side */
+	unsigned char ucTxSeq;
+	unsigned char ucNextDevice;
+	unsigned char pucTxInFlight[PDLIB_NRF24_BOND_MAX_DEVICES];
+	unsigned long ulTxLost;
+
+	/* PS: RX side */
+	NRF24L01_BondSlot psSlots[PDLIB_NRF24_BOND_WINDOW];
+	unsigned char ucRxSeq;
+	unsigned long ulRxSkipped;
+	unsigned long ulRxOverruns;
+	unsigned long ulRxDuplicates;
+} NRF24L01_Bond;
+
+/* PS: Function prototypes */
+
+int NRF24L01_BondInit(NRF24L01_Bond *psBond, NRF24L01_Device **ppsDevices, unsigned char *pucChannels, unsigned char ucDeviceCount, unsigned char *pucAddress, unsigned char ucRole);
+int NRF24L01_BondSend(NRF24L01_Bond *psBond, char *pcData, unsigned int uiLength);
+int NRF24L01_BondReceive(NRF24L01_Bond *psBond, char *pcData, char *length);
+void NRF24L01_BondSkipGap(NRF24L01_Bond *psBond);
+void NRF24L01_BondService(NRF24L01_Bond *psBond);
+
+#endif
@@ -0,0 +1,258 @@
+/*
+ * Please find the license in the GIT repo.
+ *
+ * Description:
+ *
+ * Bus manager for several modules sharing one SSI module. Each module has
+ * its own CE and CSN pins (see NRF24L01_InitDevice()). Work for the
+ * modules is submitted as jobs and NRF24L01_BusRun() runs them one after
+ * the other, so transactions of different modules never overlap.
+ *
+ * Jobs submitted with PDLIB_NRF24_BUS_PRIORITY_IRQ (ie. from the IRQ ISR)
+ * run before any pending PDLIB_NRF24_BUS_PRIORITY_BULK job, such as
+ * payload writes. The IRQ queue is checked again after every job.
+ *
+ * Usage:
+ *
+ * [1]. Initialize the modules using NRF24L01_InitDevice()
+ * [2]. Call NRF24L01_BusInit() for the SSI module
+ * [3]. Submit jobs using NRF24L01_BusSubmit() (ISR safe)
+ * [4]. Call NRF24L01_BusRun() from the main loop
+ * [5]. Call NRF24L01_BusGetLoad() periodically. If the load is close to
+ * 		1000 or jobs are rejected, the bus is saturated.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pdlib_nrf24l01_bus.h"
+
+#ifdef PDLIB_SPI
+#include "pdlib_spi.h"
+#endif
+
+#ifdef PART_LM4F120H5QR
+#include "inc/hw_types.h"
+#include "driverlib/rom.h"
+#include "driverlib/interrupt.h"
+
+#define BUS_ENTER_CRITICAL(x)	x = ROM_IntMasterDisable()
+#define BUS_EXIT_CRITICAL(x)	do{ if(!(x)) ROM_IntMasterEnable(); }while(0)
+#else
+#define BUS_ENTER_CRITICAL(x)	x = 0
+#define BUS_EXIT_CRITICAL(x)	(void)x
+#endif
+
+/* PS: SSI module indexes of pdlib_spi, 0 ~ 4 */
+#define BUS_SSI_MODULES			5
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_BusInit
+ *
+ * Arguments	: 	psBus		:	Bus context
+ * 					ucSSIIndex	:	Index of the SSI module shared by the modules
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				: Bus initialized
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	: Invalid input argument
+ *
+ * Description	: 	Initializes the bus context and resets the byte count of the
+ * 					SSI module.
+ *
+ */
+
+int
+NRF24L01_BusInit(NRF24L01_Bus *psBus, unsigned char ucSSIIndex)
+{
+	if((NULL == psBus) || (ucSSIIndex >= BUS_SSI_MODULES))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	memset(psBus, 0, sizeof(NRF24L01_Bus));
+
+	psBus->ucSSIIndex = ucSSIIndex;
+
+#ifdef PDLIB_SPI
+	pdlibSPI_GetByteCount(ucSSIIndex, 1);
+#endif
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_BusSubmit
+ *
+ * Arguments	: 	psBus		:	Bus context
+ * 					psDevice	:	Module the job is for. Should be on this bus.
+ * 					pfnJob		:	Job function
+ * 					pvArg		:	Argument passed to the job function
+ * 					ucPriority	:	PDLIB_NRF24_BUS_PRIORITY_IRQ or PDLIB_NRF24_BUS_PRIORITY_BULK
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				: Job is queued
+ * 					PDLIB_NRF24_QUEUE_FULL			: Queue is full
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	: Invalid input argument
+ *
+ * Description	: 	Queues a job. Can be called from an ISR.
+ *
+ */
+
+int
+NRF24L01_BusSubmit(	NRF24L01_Bus *psBus,
+					NRF24L01_Device *psDevice,
+					NRF24L01_BusJob pfnJob,
+					void *pvArg,
+					unsigned char ucPriority)
+{
+	int ret = PDLIB_NRF24_SUCCESS;
+	NRF24L01_BusQueue *psQueue;
+	NRF24L01_BusEntry *psEntry;
+	unsigned char ucMasked;
+
+	if((NULL == psDevice) || (NULL == pfnJob) || (ucPriority >= PDLIB_NRF24_BUS_PRIORITIES) ||
+		(psDevice->ucSSIIndex != psBus->ucSSIIndex))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	psQueue = &psBus->psQueues[ucPriority];
+
+	BUS_ENTER_CRITICAL(ucMasked);
+
+	if(psQueue->ucCount >= PDLIB_NRF24_BUS_QUEUE_DEPTH)
+	{
+		psBus->ulRejected++;
+		ret = PDLIB_NRF24_QUEUE_FULL;
+	}else
+	{
+		psEntry = &psQueue->psEntries[(psQueue->ucHead + psQueue->ucCount) % PDLIB_NRF24_BUS_QUEUE_DEPTH];
+		psEntry->psDevice = psDevice;
+		psEntry->pfnJob = pfnJob;
+		psEntry->pvArg = pvArg;
+
+		psQueue->ucCount++;
+
+		if(psQueue->ucCount > psQueue->ucHighWater)
+		{
+			psQueue->ucHighWater = psQueue->ucCount;
+		}
+	}
+
+	BUS_EXIT_CRITICAL(ucMasked);
+
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_BusRun
+ *
+ * Arguments	: 	psBus		:	Bus context
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Runs the queued jobs until both queues are empty. Highest
+ * 					priority job is picked every time. Should be called from
+ * 					the main loop only. The module active before the call is
+ * 					selected again when it returns.
+ *
+ */
+
+void
+NRF24L01_BusRun(NRF24L01_Bus *psBus)
+{
+	NRF24L01_Device *psActive = NRF24L01_GetActiveDevice();
+	NRF24L01_BusQueue *psQueue;
+	NRF24L01_BusEntry sEntry;
+	unsigned char ucPriority;
+	unsigned char ucMasked;
+
+	while(1)
+	{
+		BUS_ENTER_CRITICAL(ucMasked);
+
+		for(ucPriority = 0; ucPriority < PDLIB_NRF24_BUS_PRIORITIES; ucPriority++)
+		{
+			if(psBus->psQueues[ucPriority].ucCount > 0)
+			{
+				break;
+			}
+		}
+
+		if(ucPriority < PDLIB_NRF24_BUS_PRIORITIES)
+		{
+			psQueue = &psBus->psQueues[ucPriority];
+
+			sEntry = psQueue->psEntries[psQueue->ucHead];
+			psQueue->ucHead = (psQueue->ucHead + 1) % PDLIB_NRF24_BUS_QUEUE_DEPTH;
+			psQueue->ucCount--;
+		}
+
+		BUS_EXIT_CRITICAL(ucMasked);
+
+		if(ucPriority >= PDLIB_NRF24_BUS_PRIORITIES)
+		{
+			break;
+		}
+
+		NRF24L01_SelectDevice(sEntry.psDevice);
+		sEntry.pfnJob(sEntry.psDevice, sEntry.pvArg);
+
+		psBus->pulJobs[ucPriority]++;
+	}
+
+	/* PS: Synchronous calls of the main loop go to the module active before */
+	if(psActive && (psActive != NRF24L01_GetActiveDevice()))
+	{
+		NRF24L01_SelectDevice(psActive);
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_BusGetLoad
+ *
+ * Arguments	: 	psBus		:	Bus context
+ * 					ulWindowUs	:	Time elapsed since the previous call (in microseconds)
+ *
+ * Return		: 	Bus utilisation in the window (0 ~ 1000, per mille)
+ *
+ * Description	: 	Calculates the time the SSI module was clocking data out of
+ * 					the number of bytes transferred and the SPI bit rate.
+ * 					Resets the byte count.
+ *
+ */
+
+unsigned int
+NRF24L01_BusGetLoad(NRF24L01_Bus *psBus, unsigned long ulWindowUs)
+{
+	unsigned long long ullBusyUs = 0;
+#ifdef PDLIB_SPI
+	unsigned long ulBitRate;
+
+	ullBusyUs = (unsigned long long)pdlibSPI_GetByteCount(psBus->ucSSIIndex, 1) * 8 * 1000000;
+	ulBitRate = pdlibSPI_GetBitRate(psBus->ucSSIIndex);
+
+	/* PS: 0 for an SSI index pdlib_spi doesn't know */
+	if(0 == ulBitRate)
+	{
+		return 0;
+	}
+
+	ullBusyUs /= ulBitRate;
+#endif
+
+	if(0 == ulWindowUs)
+	{
+		return 0;
+	}
+
+	ullBusyUs = (ullBusyUs * 1000) / ulWindowUs;
+
+	return (ullBusyUs > 1000) ? 1000 : (unsigned int)ullBusyUs;
+}
@@ -0,0 +1,51 @@
+#ifndef _PDLIB_NRF24L01_BUS
+#define _PDLIB_NRF24L01_BUS
+
+#include "pdlib_nrf24l01.h"
+
+/* Configurations */
+
+#ifndef PDLIB_NRF24_BUS_QUEUE_DEPTH
+#define PDLIB_NRF24_BUS_QUEUE_DEPTH		8
+#endif
+
+/* PS: Job priorities. IRQ jobs always run before bulk jobs */
+#define PDLIB_NRF24_BUS_PRIORITY_IRQ	0
+#define PDLIB_NRF24_BUS_PRIORITY_BULK	1
+#define PDLIB_NRF24_BUS_PRIORITIES		2
+
+/* PS: A job is a set of transactions to one module. The module is selected when the job runs */
+typedef void (*NRF24L01_BusJob)(NRF24L01_Device *psDevice, void *pvArg);
+
+typedef struct
+{
+	NRF24L01_Device *psDevice;
+	NRF24L01_BusJob pfnJob;
+	void *pvArg;
+} NRF24L01_BusEntry;
+
+typedef struct
+{
+	NRF24L01_BusEntry psEntries[PDLIB_NRF24_BUS_QUEUE_DEPTH];
+	unsigned char ucHead;
+	unsigned char ucCount;
+	unsigned char ucHighWater;
+} NRF24L01_BusQueue;
+
+/* PS: Modules sharing one SSI module */
+typedef struct
+{
+	unsigned char ucSSIIndex;
+	NRF24L01_BusQueue psQueues[PDLIB_NRF24_BUS_PRIORITIES];
+	unsigned long pulJobs[PDLIB_NRF24_BUS_PRIORITIES];
+	unsigned long ulRejected;
+} NRF24L01_Bus;
+
+/* PS: Function prototypes */
+
+int NRF24L01_BusInit(NRF24L01_Bus *psBus, unsigned char ucSSIIndex);
+int NRF24L01_BusSubmit(NRF24L01_Bus *psBus, NRF24L01_Device *psDevice, NRF24L01_BusJob pfnJob, void *pvArg, unsigned char ucPriority);
+void NRF24L01_BusRun(NRF24L01_Bus *psBus);
+unsigned int NRF24L01_BusGetLoad(NRF24L01_Bus *psBus, unsigned long ulWindowUs);
+
+#endif
@@ -0,0 +1,354 @@
+/*
+ * Please find the license in the GIT repo.
+ *
+ * Description:
+ *
+ * Compile time configuration of the NRF24L01 module (C++14).
+ *
+ * nrf24::Config is a constexpr builder of the full register image. The
+ * configuration is checked with NRF24_CHECK_CONFIG(), which fails the
+ * build for illegal combinations. nrf24::MakeImage() turns the
+ * configuration into a flat write list at compile time. The write list
+ * can be streamed to the module with NRF24L01_RegisterWriteList() (C API)
+ * or nrf24::Radio<>::ApplyImage() (C++ front end).
+ *
+ * Usage:
+ *
+ * 		static constexpr uint8_t ucAddress[5] = {0xDE, 0xAD, 0xBE, 0xEF, 0x01};
+ *
+ * 		static constexpr nrf24::Config kConfig = nrf24::Config()
+ * 			.PrimaryRx(false)
+ * 			.Channel(76)
+ * 			.DataRate(2)
+ * 			.Retries(500, 5)
+ * 			.TxAddress(ucAddress)
+ * 			.RxAddress(0, ucAddress)
+ * 			.AckPayload();
+ *
+ * 		NRF24_CHECK_CONFIG(kConfig);
+ *
+ * 		static constexpr nrf24::RegisterImage kImage = nrf24::MakeImage(kConfig);
+ *
+ * 		NRF24L01_RegisterWriteList(kImage.pucList, kImage.ucLength);
+ *
+ */
+
+#ifndef _PDLIB_NRF24L01_CONFIG_HPP
+#define _PDLIB_NRF24L01_CONFIG_HPP
+
+#include <stdint.h>
+
+extern "C" {
+#include "nRF24L01.h"
+}
+
+namespace nrf24
+{
+
+/* PS: Largest possible write list: 20 single byte registers and 3 addresses of 5 bytes */
+static const uint8_t RegisterImageSize = (20 * 3) + (3 * 7);
+
+/* PS: Write list. Sequence of {register, length, data[length]} */
+struct RegisterImage
+{
+	uint8_t pucList[RegisterImageSize];
+	uint8_t ucLength;
+};
+
+struct Config
+{
+	uint8_t ucConfig;
+	uint8_t ucEnAA;
+	uint8_t ucEnRxAddr;
+	uint8_t ucAddressWidth;
+	uint16_t usRetryDelay;
+	uint8_t ucRetryCount;
+	uint8_t ucChannel;
+	uint8_t ucRFSetup;
+	uint8_t ucDynPD;
+	uint8_t ucFeature;
+	uint8_t pucRxPW[6];
+	uint8_t pucTxAddress[5];
+	uint8_t pucRxAddress0[5];
+	uint8_t pucRxAddress1[5];
+	uint8_t pucRxAddressLSB[4];
+
+	/* PS: Same values as NRF24L01_RegisterInit() */
+	constexpr Config()
+		: ucConfig((RF24_EN_CRC) | (RF24_PRIM_RX)),
+		  ucEnAA(0x3F),
+		  ucEnRxAddr(0x03),
+		  ucAddressWidth(5),
+		  usRetryDelay(250),
+		  ucRetryCount(3),
+		  ucChannel(2),
+		  ucRFSetup(0x0F),
+		  ucDynPD(0),
+		  ucFeature(0),
+		  pucRxPW{0, 0, 0, 0, 0, 0},
+		  pucTxAddress{0xE7, 0xE7, 0xE7, 0xE7, 0xE7},
+		  pucRxAddress0{0xE7, 0xE7, 0xE7, 0xE7, 0xE7},
+		  pucRxAddress1{0xC2, 0xC2, 0xC2, 0xC2, 0xC2},
+		  pucRxAddressLSB{0xC3, 0xC4, 0xC5, 0xC6}
+	{
+	}
+
+	/* PS: Setters, each returns a modified copy */
+
+	constexpr Config Channel(uint8_t ucValue) const
+	{
+		Config c = *this;
+		c.ucChannel = ucValue;
+		return c;
+	}
+
+	/* PS: 1 or 2 (Mbps) */
+	constexpr Config DataRate(uint8_t ucMbps) const
+	{
+		Config c = *this;
+		c.ucRFSetup = (ucMbps == 2) ? (c.ucRFSetup | (RF24_RF_DR)) : (c.ucRFSetup & ~(RF24_RF_DR));
+		return c;
+	}
+
+	/* PS: 0, -6, -12 or -18 (dBm) */
+	constexpr Config PAGain(int iDbm) const
+	{
+		Config c = *this;
+		c.ucRFSetup = (c.ucRFSetup & ~0x06) | ((uint8_t)((3 - (-iDbm / 6)) & 0x03) << 1);
+		return c;
+	}
+
+	constexpr Config LNAGain(bool bEnable) const
+	{
+		Config c = *this;
+		c.ucRFSetup = bEnable ? (c.ucRFSetup | (RF24_LNA_HCURR)) : (c.ucRFSetup & ~(RF24_LNA_HCURR));
+		return c;
+	}
+
+	/* PS: 3, 4 or 5 (bytes) */
+	constexpr Config AddressWidth(uint8_t ucBytes) const
+	{
+		Config c = *this;
+		c.ucAddressWidth = ucBytes;
+		return c;
+	}
+
+	/* PS: usDelay : 250 ~ 4000 us in steps of 250, ucCount : 0 ~ 15 */
+	constexpr Config Retries(uint16_t usDelay, uint8_t ucCount) const
+	{
+		Config c = *this;
+		c.usRetryDelay = usDelay;
+		c.ucRetryCount = ucCount;
+		return c;
+	}
+
+	/* PS: 0 (disabled), 1 or 2 (bytes) */
+	constexpr Config Crc(uint8_t ucBytes) const
+	{
+		Config c = *this;
+		c.ucConfig &= ~((RF24_EN_CRC) | (RF24_CRCO));
+		c.ucConfig |= (ucBytes == 0) ? 0 : ((ucBytes == 1) ? (RF24_EN_CRC) : ((RF24_EN_CRC) | (RF24_CRCO)));
+		return c;
+	}
+
+	constexpr Config PrimaryRx(bool bRx) const
+	{
+		Config c = *this;
+		c.ucConfig = bRx ? (c.ucConfig | (RF24_PRIM_RX)) : (c.ucConfig & ~(RF24_PRIM_RX));
+		return c;
+	}
+
+	/* PS: Bit mask of pipes */
+	constexpr Config AutoAck(uint8_t ucPipes) const
+	{
+		Config c = *this;
+		c.ucEnAA = ucPipes & 0x3F;
+		return c;
+	}
+
+	/* PS: Bit mask of pipes */
+	constexpr Config EnablePipes(uint8_t ucPipes) const
+	{
+		Config c = *this;
+		c.ucEnRxAddr = ucPipes & 0x3F;
+		return c;
+	}
+
+	constexpr Config PayloadWidth(uint8_t ucPipe, uint8_t ucWidth) const
+	{
+		Config c = *this;
+		c.pucRxPW[ucPipe] = ucWidth;
+		return c;
+	}
+
+	/* PS: Bit mask of pipes */
+	constexpr Config DynamicPayload(uint8_t ucPipes) const
+	{
+		Config c = *this;
+		c.ucDynPD |= (ucPipes & 0x3F);
+		c.ucFeature |= (RF24_EN_DPL);
+		return c;
+	}
+
+	/* PS: Same as NRF24L01_EnableFeatureAckPL(), dynamic payload is enabled for pipe 0 */
+	constexpr Config AckPayload() const
+	{
+		Config c = DynamicPayload(1 << 0);
+		c.ucFeature |= (RF24_EN_ACK_PAY);
+		return c;
+	}
+
+	constexpr Config NoAckTx() const
+	{
+		Config c = *this;
+		c.ucFeature |= (RF24_EN_DYN_ACK);
+		return c;
+	}
+
+	constexpr Config TxAddress(const uint8_t (&pucAddress)[5]) const
+	{
+		Config c = *this;
+		for(int i = 0; i < 5; i++) c.pucTxAddress[i] = pucAddress[i];
+		return c;
+	}
+
+	/* PS: Pipe 0 and 1 take the full address, other pipes take only pucAddress[0] */
+	constexpr Config RxAddress(uint8_t ucPipe, const uint8_t (&pucAddress)[5]) const
+	{
+		Config c = *this;
+		for(int i = 0; i < 5; i++)
+		{
+			if(ucPipe == 0) c.pucRxAddress0[i] = pucAddress[i];
+			if(ucPipe == 1) c.pucRxAddress1[i] = pucAddress[i];
+		}
+		if((ucPipe >= 2) && (ucPipe < 6)) c.pucRxAddressLSB[ucPipe - 2] = pucAddress[0];
+		return c;
+	}
+
+	/* PS: Checks used by NRF24_CHECK_CONFIG() */
+
+	constexpr bool ChannelValid() const
+	{
+		return (ucChannel <= 125);
+	}
+
+	constexpr bool AddressWidthValid() const
+	{
+		return (ucAddressWidth >= 3) && (ucAddressWidth <= 5);
+	}
+
+	constexpr bool RetriesValid() const
+	{
+		return (usRetryDelay >= 250) && (usRetryDelay <= 4000) && ((usRetryDelay % 250) == 0) && (ucRetryCount <= 15);
+	}
+
+	constexpr bool PayloadWidthsValid() const
+	{
+		for(int i = 0; i < 6; i++)
+		{
+			if(pucRxPW[i] > 32) return false;
+		}
+		return true;
+	}
+
+	/* PS: Enabled static payload pipes of a PRX need a payload width */
+	constexpr bool StaticPipesValid() const
+	{
+		for(int i = 0; i < 6; i++)
+		{
+			if((ucConfig & (RF24_PRIM_RX)) && (ucEnRxAddr & (1 << i)) && !(ucDynPD & (1 << i)) && (pucRxPW[i] == 0)) return false;
+		}
+		return true;
+	}
+
+	/* PS: Auto acknowledgement needs CRC */
+	constexpr bool CrcValid() const
+	{
+		return (ucEnAA == 0) || (ucConfig & (RF24_EN_CRC));
+	}
+
+	/* PS: Dynamic payload pipes need EN_DPL and auto acknowledgement */
+	constexpr bool DynamicPayloadValid() const
+	{
+		return (ucDynPD == 0) || ((ucFeature & (RF24_EN_DPL)) && ((ucDynPD & ~ucEnAA) == 0));
+	}
+
+	/* PS: ACK payload needs at least 500 us retransmission delay */
+	constexpr bool AckPayloadValid() const
+	{
+		return !(ucFeature & (RF24_EN_ACK_PAY)) || ((usRetryDelay >= 500) && (ucDynPD & (1 << 0)));
+	}
+
+	/* PS: Register values */
+
+	constexpr uint8_t SetupAW() const
+	{
+		return ucAddressWidth - 2;
+	}
+
+	constexpr uint8_t SetupRetr() const
+	{
+		return (uint8_t)((((usRetryDelay / 250) - 1) << 4) | (ucRetryCount & 0x0F));
+	}
+};
+
+/* PS: Appends one register write to the image */
+constexpr void _ImageAppend(RegisterImage &image, uint8_t ucRegister, const uint8_t *pucData, uint8_t ucCount)
+{
+	image.pucList[image.ucLength++] = ucRegister;
+	image.pucList[image.ucLength++] = ucCount;
+	for(uint8_t i = 0; i < ucCount; i++) image.pucList[image.ucLength++] = pucData[i];
+}
+
+constexpr void _ImageAppend(RegisterImage &image, uint8_t ucRegister, uint8_t ucValue)
+{
+	image.pucList[image.ucLength++] = ucRegister;
+	image.pucList[image.ucLength++] = 1;
+	image.pucList[image.ucLength++] = ucValue;
+}
+
+/* PS: Builds the write list. CONFIG is written with PWR_UP cleared, use the mode APIs to power up */
+constexpr RegisterImage MakeImage(const Config &c)
+{
+	RegisterImage image = {{0}, 0};
+
+	_ImageAppend(image, RF24_CONFIG, c.ucConfig);
+	_ImageAppend(image, RF24_EN_AA, c.ucEnAA);
+	_ImageAppend(image, RF24_EN_RXADDR, c.ucEnRxAddr);
+	_ImageAppend(image, RF24_SETUP_AW, c.SetupAW());
+	_ImageAppend(image, RF24_SETUP_RETR, c.SetupRetr());
+	_ImageAppend(image, RF24_RF_CH, c.ucChannel);
+	_ImageAppend(image, RF24_RF_SETUP, c.ucRFSetup);
+	_ImageAppend(image, RF24_STATUS, (RF24_RX_DR) | (RF24_TX_DS) | (RF24_MAX_RT));
+
+	/* PS: Only the configured address width is written */
+	_ImageAppend(image, RF24_RX_ADDR_P0, c.pucRxAddress0, c.ucAddressWidth);
+	_ImageAppend(image, RF24_RX_ADDR_P1, c.pucRxAddress1, c.ucAddressWidth);
+
+	for(uint8_t i = 0; i < 4; i++) _ImageAppend(image, RF24_RX_ADDR_P2 + i, c.pucRxAddressLSB[i]);
+
+	_ImageAppend(image, RF24_TX_ADDR, c.pucTxAddress, c.ucAddressWidth);
+
+	for(uint8_t i = 0; i < 6; i++) _ImageAppend(image, RF24_RX_PW_P0 + i, c.pucRxPW[i]);
+
+	/* PS: FEATURE before DYNPD */
+	_ImageAppend(image, RF24_FEATURE, c.ucFeature);
+	_ImageAppend(image, RF24_DYNPD, c.ucDynPD);
+
+	return image;
+}
+
+}
+
+/* PS: Fails the build if the configuration is not valid */
+#define NRF24_CHECK_CONFIG(cfg) \
+	static_assert((cfg).ChannelValid(), "nrf24: RF channel should be 0 ~ 125"); \
+	static_assert((cfg).AddressWidthValid(), "nrf24: address width should be 3 ~ 5"); \
+	static_assert((cfg).RetriesValid(), "nrf24: ARD should be 250 ~ 4000 us in steps of 250, ARC should be 0 ~ 15"); \
+	static_assert((cfg).PayloadWidthsValid(), "nrf24: payload width should be 32 or less"); \
+	static_assert((cfg).StaticPipesValid(), "nrf24: enabled static payload pipe of a PRX has no payload width"); \
+	static_assert((cfg).CrcValid(), "nrf24: auto acknowledgement needs CRC"); \
+	static_assert((cfg).DynamicPayloadValid(), "nrf24: dynamic payload pipe needs EN_DPL and auto acknowledgement"); \
+	static_assert((cfg).AckPayloadValid(), "nrf24: ACK payload needs ARD of 500 us or more and dynamic payload on pipe 0")
+
+#endif
@@ -0,0 +1,277 @@
+/*
+ * Please find the license in the GIT repo.
+ *
+ * Description:
+ *
+ * Optional listen before talk for the TX path. Before each attempt the
+ * module listens for PDLIB_NRF24_CSMA_LISTEN_US and reads CD (RPD on
+ * the nRF24L01+). While the channel is busy the sender waits a random
+ * number of slots from a window which doubles with each busy check.
+ *
+ * The hardware retries are limited to a few per attempt and the ARD is
+ * picked at random for each attempt, so contenders do not retry in step.
+ * SETUP_RETR is restored when the send returns.
+ * When the retries run out the payload is flushed and the next attempt
+ * starts with a carrier check again.
+ *
+ * Needs a clock source (NRF24L01_SetClockSource()).
+ *
+ * Usage:
+ *
+ * 		NRF24L01_CSMA sMac;
+ *
+ * 		NRF24L01_CSMAInit(&sMac, ulUniqueId);
+ * 		ret = NRF24L01_CSMASend(&sMac, data, 23, 20000);
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pdlib_nrf24l01_csma.h"
+#include "pdlib_nrf24l01_async.h"
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_CSMAInit
+ *
+ * Arguments	: 	psMac		:	Sender
+ * 					ulSeed		:	Seed of the backoff, should differ between nodes
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Sets the defaults: window of 4 to 64 slots, 5 attempts and
+ * 					2 hardware retries spread over 250 to 1000 us. The fields can
+ * 					be changed afterwards.
+ *
+ */
+
+void
+NRF24L01_CSMAInit(NRF24L01_CSMA *psMac, unsigned long ulSeed)
+{
+	if(psMac)
+	{
+		memset(psMac, 0, sizeof(NRF24L01_CSMA));
+
+		psMac->ucMinExp = 2;
+		psMac->ucMaxExp = 6;
+		psMac->ucMaxAttempts = 5;
+		psMac->ucARC = 2;
+		psMac->ucARDSteps = 4;
+		psMac->ulSeed = ulSeed ? ulSeed : 1;
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_CSMARandom
+ *
+ * Arguments	: 	psMac		:	Sender
+ *
+ * Return		: 	Next pseudo random number (xorshift32)
+ *
+ */
+
+static unsigned long
+_NRF24L01_CSMARandom(NRF24L01_CSMA *psMac)
+{
+	unsigned long ulX = psMac->ulSeed;
+
+	ulX ^= (ulX << 13) & 0xFFFFFFFFUL;
+	ulX ^= (ulX >> 17);
+	ulX ^= (ulX << 5) & 0xFFFFFFFFUL;
+
+	psMac->ulSeed = ulX;
+
+	return ulX;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_CSMADelay
+ *
+ * Arguments	: 	ulUs		:	Time to wait in microseconds
+ *
+ * Return		: 	None
+ *
+ */
+
+static void
+_NRF24L01_CSMADelay(unsigned long ulUs)
+{
+	unsigned long ulStart = NRF24L01_GetTimeUs();
+
+	while((NRF24L01_GetTimeUs() - ulStart) < ulUs);
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_CSMABackoff
+ *
+ * Arguments	: 	psMac		:	Sender
+ * 					ucAttempt	:	Number of the failed attempt, from 1
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Waits 0 .. 2^(ucMinExp + ucAttempt - 1) - 1 slots, the
+ * 					exponent limited to ucMaxExp.
+ *
+ */
+
+static void
+_NRF24L01_CSMABackoff(NRF24L01_CSMA *psMac, unsigned char ucAttempt)
+{
+	unsigned char ucExp = psMac->ucMinExp + ucAttempt - 1;
+	unsigned long ulUs;
+
+	if(ucExp > psMac->ucMaxExp)
+	{
+		ucExp = psMac->ucMaxExp;
+	}
+
+	ulUs = (_NRF24L01_CSMARandom(psMac) & ((1UL << ucExp) - 1)) * PDLIB_NRF24_CSMA_SLOT_US;
+
+	psMac->sStats.ulBackoffUs += ulUs;
+
+	_NRF24L01_CSMADelay(ulUs);
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_CSMAChannelClear
+ *
+ * Arguments	: 	None
+ *
+ * Return		: 	1							:	No carrier on the channel
+ * 					0							:	Channel busy
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	No clock source
+ *
+ * Description	: 	Listens on the channel of the active module. The module is
+ * 					powered up and left in Standby I mode.
+ *
+ */
+
+int
+NRF24L01_CSMAChannelClear()
+{
+	unsigned long ulListenUs = PDLIB_NRF24_CSMA_LISTEN_US;
+	unsigned char ucCarrier;
+
+	if(NULL == NRF24L01_GetClockSource())
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	if(0 == NRF24L01_IsPoweredUp())
+	{
+		ulListenUs += PDLIB_NRF24_TPD2STBY_US;
+	}
+
+	NRF24L01_EnableRxMode();
+
+	_NRF24L01_CSMADelay(ulListenUs);
+
+	ucCarrier = NRF24L01_CarrierDetect();
+
+	NRF24L01_DisableRxMode();
+
+	return ucCarrier ? 0 : 1;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_CSMASend
+ *
+ * Arguments	: 	psMac		:	Sender
+ * 					pcData		:	Payload
+ * 					uiLength	:	Payload length
+ * 					ulTimeoutUs	:	Timeout of each attempt, see NRF24L01_SendDataTimeout()
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				:	Payload sent
+ * 					PDLIB_NRF24_BUSY				:	Channel stayed busy
+ * 					PDLIB_NRF24_TX_ARC_REACHED		:	Not acknowledged in any attempt
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument, timeout 0 or no clock source
+ * 					Others							:	Same as NRF24L01_SendDataTimeout()
+ *
+ * Description	: 	Sends the payload when the channel is clear, with random
+ * 					backoff while it is busy. Up to ucMaxAttempts carrier checks
+ * 					and attempts are made. SETUP_RETR is rewritten for every
+ * 					attempt and restored before returning.
+ *
+ */
+
+int
+NRF24L01_CSMASend(NRF24L01_CSMA *psMac, char *pcData, unsigned int uiLength, unsigned long ulTimeoutUs)
+{
+	unsigned char ucAttempt = 0;
+	unsigned char ucSetupRetr;
+	unsigned char ucARD;
+	int iClear;
+	int ret;
+
+	if((NULL == psMac) || (NULL == pcData) || (0 == psMac->ucMaxAttempts) || (0 == ulTimeoutUs))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	ucSetupRetr = NRF24L01_RegisterRead_8(RF24_SETUP_RETR);
+
+	while(1)
+	{
+		iClear = NRF24L01_CSMAChannelClear();
+
+		if(iClear < 0)
+		{
+			ret = iClear;
+			break;
+		}
+
+		if(iClear)
+		{
+			ucARD = (psMac->ucARDSteps > 1) ? (unsigned char)(_NRF24L01_CSMARandom(psMac) % psMac->ucARDSteps) : 0;
+
+			NRF24L01_RegisterWrite_8(RF24_SETUP_RETR, ((ucARD & 0x0F) << 4) | (psMac->ucARC & 0x0F));
+
+			ret = NRF24L01_SendDataTimeout(pcData, uiLength, ulTimeoutUs);
+
+			if(PDLIB_NRF24_SUCCESS == ret)
+			{
+				psMac->sStats.ulSent++;
+				break;
+			}
+
+			if(PDLIB_NRF24_TX_ARC_REACHED != ret)
+			{
+				break;
+			}
+
+			/* PS: MAX_RT keeps the payload in the TX FIFO, the next attempt writes it again */
+			NRF24L01_FlushTX();
+			psMac->sStats.ulLost++;
+		}else
+		{
+			psMac->sStats.ulBusy++;
+			ret = PDLIB_NRF24_BUSY;
+		}
+
+		ucAttempt++;
+
+		if(ucAttempt >= psMac->ucMaxAttempts)
+		{
+			psMac->sStats.ulDropped++;
+			break;
+		}
+
+		_NRF24L01_CSMABackoff(psMac, ucAttempt);
+	}
+
+	/* PS: Other senders of the module use the configured retries */
+	NRF24L01_RegisterWrite_8(RF24_SETUP_RETR, ucSetupRetr);
+
+	return ret;
+}
@@ -0,0 +1,52 @@
+#ifndef _PDLIB_NRF24L01_CSMA
+#define _PDLIB_NRF24L01_CSMA
+
+#include "pdlib_nrf24l01.h"
+
+/* Configurations */
+
+/* PS: RX time for a carrier check, RX settling (130 us) + CD/RPD detection (40 us) */
+#ifndef PDLIB_NRF24_CSMA_LISTEN_US
+#define PDLIB_NRF24_CSMA_LISTEN_US		170
+#endif
+
+/* PS: Backoff slot */
+#ifndef PDLIB_NRF24_CSMA_SLOT_US
+#define PDLIB_NRF24_CSMA_SLOT_US		250
+#endif
+
+typedef struct
+{
+	unsigned long ulSent;
+	unsigned long ulBusy;
+	unsigned long ulLost;
+	unsigned long ulDropped;
+	unsigned long ulBackoffUs;
+} NRF24L01_CSMAStats;
+
+/* PS: Listen before talk settings and state of one sender */
+typedef struct
+{
+	/* PS: Backoff window is 2^ucMinExp .. 2^ucMaxExp slots */
+	unsigned char ucMinExp;
+	unsigned char ucMaxExp;
+
+	/* PS: Carrier checks and software retries before giving up */
+	unsigned char ucMaxAttempts;
+
+	/* PS: Hardware retries per attempt and the ARD range (in 250 us steps) they are spread over */
+	unsigned char ucARC;
+	unsigned char ucARDSteps;
+
+	unsigned long ulSeed;
+
+	NRF24L01_CSMAStats sStats;
+} NRF24L01_CSMA;
+
+/* PS: Function prototypes */
+
+void NRF24L01_CSMAInit(NRF24L01_CSMA *psMac, unsigned long ulSeed);
+int NRF24L01_CSMAChannelClear();
+int NRF24L01_CSMASend(NRF24L01_CSMA *psMac, char *pcData, unsigned int uiLength, unsigned long ulTimeoutUs);
+
+#endif
@@ -0,0 +1,532 @@
+/*
+ * Please find the license in the GIT repo.
+ *
+ * Description:
+ *
+ * Packet level forward error correction for streams without
+ * acknowledgement. The data packets are sent in groups of N and each
+ * group is followed by P XOR parity packets. Parity packet j covers the
+ * data packets i of the group with i % P == j, so the classes are
+ * interleaved: any burst of up to P consecutive lost data packets, or
+ * one lost packet in every class, is rebuilt by the receiver without a
+ * back channel. The code rate is N / (N + P).
+ *
+ * Packet format:
+ *
+ * 		[0]		:	Group number
+ * 		[1]		:	Data	: Index in the group (0 ~ N-1)
+ * 					Parity	: 0x80 | ((packets in the group - 1) << 2) | class
+ * 		[2]		:	Data	: Length of the data
+ * 					Parity	: XOR of the lengths of the class
+ * 		[3..31]	:	Data, or XOR of the data of the class
+ *
+ * Usage:
+ *
+ * TX side, with NRF24L01_EnableFeatureNoAckTx() and dynamic payload:
+ *
+ * 		len = NRF24L01_FECEncode(&sEnc, data, 20, packet);
+ * 		NRF24L01_SendCommand(RF24_W_TX_PAYLOAD_NOACK, packet, len);
+ *
+ * 		while((len = NRF24L01_FECGetParity(&sEnc, packet)) > 0)
+ * 			NRF24L01_SendCommand(RF24_W_TX_PAYLOAD_NOACK, packet, len);
+ *
+ * RX side:
+ *
+ * 		NRF24L01_FECDecode(&sDec, packet, len);
+ * 		while(NRF24L01_FECRead(&sDec, data, &length) >= 0)
+ * 			...
+ *
+ * Data packets are given out as they arrive and rebuilt packets as soon
+ * as their parity is received, so rebuilt packets come out of order.
+ * Read all the packets after each NRF24L01_FECDecode(), the first packet
+ * of the next group drops the packets left in the decoder.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pdlib_nrf24l01_fec.h"
+
+#define FEC_PARITY_FLAG		0x80
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_FECXor
+ *
+ * Arguments	: 	pcDest		:	Accumulator
+ * 					pcData		:	Data
+ * 					uiLength	:	Length of the data
+ *
+ * Return		: 	None
+ *
+ */
+
+static void
+_NRF24L01_FECXor(char *pcDest, const char *pcData, unsigned int uiLength)
+{
+	unsigned int i;
+
+	for(i = 0; i < uiLength; i++)
+	{
+		pcDest[i] ^= pcData[i];
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_FECEncoderInit
+ *
+ * Arguments	: 	psEnc		:	Encoder
+ * 					ucData		:	Data packets per group (1 ~ PDLIB_NRF24_FEC_MAX_DATA)
+ * 					ucParity	:	Parity packets per group (1 ~ PDLIB_NRF24_FEC_MAX_PARITY, not more than ucData)
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				:	Success
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ *
+ */
+
+int
+NRF24L01_FECEncoderInit(NRF24L01_FECEncoder *psEnc, unsigned char ucData, unsigned char ucParity)
+{
+	if((NULL == psEnc) || (0 == ucData) || (ucData > PDLIB_NRF24_FEC_MAX_DATA) ||
+		(0 == ucParity) || (ucParity > PDLIB_NRF24_FEC_MAX_PARITY) || (ucParity > ucData))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	memset(psEnc, 0, sizeof(NRF24L01_FECEncoder));
+
+	psEnc->ucData = ucData;
+	psEnc->ucParity = ucParity;
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_FECEncode
+ *
+ * Arguments	: 	psEnc		:	Encoder
+ * 					pcData		:	Data to send
+ * 					uiLength	:	Length of the data (Maximum is 29)
+ * 					pcPacket	:	Packet to send, 32 bytes
+ *
+ * Return		: 	Positive						:	Length of the packet
+ * 					PDLIB_NRF24_BUSY				:	Parity of the last group is not taken yet
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ *
+ * Description	: 	Builds the next data packet of the group. After the last
+ * 					data packet of a group, take the parity packets with
+ * 					NRF24L01_FECGetParity().
+ *
+ */
+
+int
+NRF24L01_FECEncode(NRF24L01_FECEncoder *psEnc, const char *pcData, unsigned int uiLength, char *pcPacket)
+{
+	unsigned char ucClass;
+
+	if((NULL == psEnc) || (NULL == pcData) || (NULL == pcPacket) || (uiLength > PDLIB_NRF24_FEC_PAYLOAD_SIZE))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	if(psEnc->ucParityPending)
+	{
+		return PDLIB_NRF24_BUSY;
+	}
+
+	ucClass = psEnc->ucCount % psEnc->ucParity;
+
+	_NRF24L01_FECXor(psEnc->pcParity[ucClass], pcData, uiLength);
+	psEnc->pucLengthXor[ucClass] ^= uiLength;
+
+	if(uiLength > psEnc->pucLengthMax[ucClass])
+	{
+		psEnc->pucLengthMax[ucClass] = uiLength;
+	}
+
+	pcPacket[0] = psEnc->ucGroup;
+	pcPacket[1] = psEnc->ucCount;
+	pcPacket[2] = uiLength;
+	memcpy(&pcPacket[PDLIB_NRF24_FEC_HEADER_SIZE], pcData, uiLength);
+
+	psEnc->ucCount++;
+
+	if(psEnc->ucCount == psEnc->ucData)
+	{
+		psEnc->ucParityPending = psEnc->ucParity;
+	}
+
+	return PDLIB_NRF24_FEC_HEADER_SIZE + uiLength;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_FECGetParity
+ *
+ * Arguments	: 	psEnc		:	Encoder
+ * 					pcPacket	:	Packet to send, 32 bytes
+ *
+ * Return		: 	Positive						:	Length of the packet
+ * 					0								:	No parity packet pending
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ *
+ * Description	: 	Builds the next parity packet of a complete group. After
+ * 					the last one the encoder starts the next group.
+ *
+ */
+
+int
+NRF24L01_FECGetParity(NRF24L01_FECEncoder *psEnc, char *pcPacket)
+{
+	unsigned char ucClass;
+	unsigned char ucLength;
+
+	if((NULL == psEnc) || (NULL == pcPacket))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	if(0 == psEnc->ucParityPending)
+	{
+		return 0;
+	}
+
+	ucClass = psEnc->ucParityNext;
+	ucLength = psEnc->pucLengthMax[ucClass];
+
+	pcPacket[0] = psEnc->ucGroup;
+	pcPacket[1] = FEC_PARITY_FLAG | ((psEnc->ucCount - 1) << 2) | ucClass;
+	pcPacket[2] = psEnc->pucLengthXor[ucClass];
+	memcpy(&pcPacket[PDLIB_NRF24_FEC_HEADER_SIZE], psEnc->pcParity[ucClass], ucLength);
+
+	psEnc->ucParityNext++;
+	psEnc->ucParityPending--;
+
+	if(0 == psEnc->ucParityPending)
+	{
+		memset(psEnc->pcParity, 0, sizeof(psEnc->pcParity));
+		memset(psEnc->pucLengthXor, 0, sizeof(psEnc->pucLengthXor));
+		memset(psEnc->pucLengthMax, 0, sizeof(psEnc->pucLengthMax));
+		psEnc->ucParityNext = 0;
+		psEnc->ucCount = 0;
+		psEnc->ucGroup++;
+	}
+
+	return PDLIB_NRF24_FEC_HEADER_SIZE + ucLength;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_FECFlush
+ *
+ * Arguments	: 	psEnc		:	Encoder
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Ends a partial group, ie. when the stream goes idle. Its
+ * 					parity packets can then be taken with NRF24L01_FECGetParity().
+ *
+ */
+
+void
+NRF24L01_FECFlush(NRF24L01_FECEncoder *psEnc)
+{
+	if(psEnc && psEnc->ucCount && (0 == psEnc->ucParityPending))
+	{
+		psEnc->ucParityPending = (psEnc->ucCount < psEnc->ucParity) ? psEnc->ucCount : psEnc->ucParity;
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_FECDecoderInit
+ *
+ * Arguments	: 	psDec		:	Decoder
+ * 					ucData		:	Data packets per group, same as the TX side
+ * 					ucParity	:	Parity packets per group, same as the TX side
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				:	Success
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ *
+ */
+
+int
+NRF24L01_FECDecoderInit(NRF24L01_FECDecoder *psDec, unsigned char ucData, unsigned char ucParity)
+{
+	if((NULL == psDec) || (0 == ucData) || (ucData > PDLIB_NRF24_FEC_MAX_DATA) ||
+		(0 == ucParity) || (ucParity > PDLIB_NRF24_FEC_MAX_PARITY) || (ucParity > ucData))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	memset(psDec, 0, sizeof(NRF24L01_FECDecoder));
+
+	psDec->ucData = ucData;
+	psDec->ucParity = ucParity;
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_FECStartGroup
+ *
+ * Arguments	: 	psDec		:	Decoder
+ * 					ucGroup		:	Group number of the received packet
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Counts the packets of the current group which were not
+ * 					given out and clears the decoder for the new group.
+ *
+ */
+
+static void
+_NRF24L01_FECStartGroup(NRF24L01_FECDecoder *psDec, unsigned char ucGroup)
+{
+	unsigned char ucCount = psDec->ucCount ? psDec->ucCount : psDec->ucData;
+	unsigned char i;
+
+	if(psDec->ucStarted)
+	{
+		for(i = 0; i < ucCount; i++)
+		{
+			if(0 == (psDec->usRead & (1 << i)))
+			{
+				psDec->sStats.ulLost++;
+			}
+		}
+	}
+
+	memset(psDec->pcSlots, 0, sizeof(psDec->pcSlots));
+	memset(psDec->pcParity, 0, sizeof(psDec->pcParity));
+	psDec->usValid = 0;
+	psDec->usRead = 0;
+	psDec->ucParityValid = 0;
+	psDec->ucCount = 0;
+
+	psDec->ucGroup = ucGroup;
+	psDec->ucStarted = 1;
+	psDec->sStats.ulGroups++;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_FECRecover
+ *
+ * Arguments	: 	psDec		:	Decoder
+ * 					ucClass		:	Parity class
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Rebuilds the data packet of the class if its parity and all
+ * 					the other data packets of the class are received.
+ *
+ */
+
+static void
+_NRF24L01_FECRecover(NRF24L01_FECDecoder *psDec, unsigned char ucClass)
+{
+	unsigned char ucCount = psDec->ucCount ? psDec->ucCount : psDec->ucData;
+	unsigned char ucMissing = 0xFF;
+	unsigned char ucLength;
+	unsigned char i;
+
+	if(0 == (psDec->ucParityValid & (1 << ucClass)))
+	{
+		return;
+	}
+
+	for(i = ucClass; i < ucCount; i += psDec->ucParity)
+	{
+		if(0 == (psDec->usValid & (1 << i)))
+		{
+			if(0xFF != ucMissing)
+			{
+				return;
+			}
+
+			ucMissing = i;
+		}
+	}
+
+	if(0xFF == ucMissing)
+	{
+		return;
+	}
+
+	memcpy(psDec->pcSlots[ucMissing], psDec->pcParity[ucClass], PDLIB_NRF24_FEC_PAYLOAD_SIZE);
+	ucLength = psDec->pucLengthXor[ucClass];
+
+	for(i = ucClass; i < ucCount; i += psDec->ucParity)
+	{
+		if(i != ucMissing)
+		{
+			_NRF24L01_FECXor(psDec->pcSlots[ucMissing], psDec->pcSlots[i], PDLIB_NRF24_FEC_PAYLOAD_SIZE);
+			ucLength ^= psDec->pucLength[i];
+		}
+	}
+
+	/* PS: Only a corrupted parity gives an impossible length */
+	if(ucLength > PDLIB_NRF24_FEC_PAYLOAD_SIZE)
+	{
+		memset(psDec->pcSlots[ucMissing], 0, PDLIB_NRF24_FEC_PAYLOAD_SIZE);
+		return;
+	}
+
+	psDec->pucLength[ucMissing] = ucLength;
+	psDec->usValid |= (1 << ucMissing);
+	psDec->sStats.ulRecovered++;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_FECDecode
+ *
+ * Arguments	: 	psDec		:	Decoder
+ * 					pcPacket	:	Received packet
+ * 					ucLength	:	Length of the packet
+ *
+ * Return		: 	Positive or 0					:	Number of packets ready to read
+ * 					PDLIB_NRF24_ERROR				:	Not a valid packet
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ *
+ * Description	: 	Takes a received packet and rebuilds the lost data packets
+ * 					which its class allows.
+ *
+ */
+
+int
+NRF24L01_FECDecode(NRF24L01_FECDecoder *psDec, const char *pcPacket, unsigned char ucLength)
+{
+	unsigned char ucIndex;
+	unsigned char ucClass;
+	unsigned char ucCount;
+	unsigned short usReady;
+	int ret = 0;
+
+	if((NULL == psDec) || (NULL == pcPacket))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	if((ucLength < PDLIB_NRF24_FEC_HEADER_SIZE) || (ucLength > (PDLIB_NRF24_FEC_HEADER_SIZE + PDLIB_NRF24_FEC_PAYLOAD_SIZE)))
+	{
+		return PDLIB_NRF24_ERROR;
+	}
+
+	ucIndex = pcPacket[1];
+	ucLength -= PDLIB_NRF24_FEC_HEADER_SIZE;
+
+	if(ucIndex & FEC_PARITY_FLAG)
+	{
+		ucClass = ucIndex & 0x03;
+		ucCount = ((ucIndex >> 2) & 0x0F) + 1;
+
+		if((ucClass >= psDec->ucParity) || (ucCount > psDec->ucData))
+		{
+			return PDLIB_NRF24_ERROR;
+		}
+	}else
+	{
+		if((ucIndex >= psDec->ucData) || (ucLength != (unsigned char)pcPacket[2]))
+		{
+			return PDLIB_NRF24_ERROR;
+		}
+
+		ucClass = ucIndex % psDec->ucParity;
+	}
+
+	if((0 == psDec->ucStarted) || ((unsigned char)pcPacket[0] != psDec->ucGroup))
+	{
+		_NRF24L01_FECStartGroup(psDec, pcPacket[0]);
+	}
+
+	if(ucIndex & FEC_PARITY_FLAG)
+	{
+		memcpy(psDec->pcParity[ucClass], &pcPacket[PDLIB_NRF24_FEC_HEADER_SIZE], ucLength);
+		psDec->pucLengthXor[ucClass] = pcPacket[2];
+		psDec->ucParityValid |= (1 << ucClass);
+		psDec->ucCount = ucCount;
+
+		_NRF24L01_FECRecover(psDec, ucClass);
+	}else if(0 == (psDec->usValid & (1 << ucIndex)))
+	{
+		memcpy(psDec->pcSlots[ucIndex], &pcPacket[PDLIB_NRF24_FEC_HEADER_SIZE], ucLength);
+		psDec->pucLength[ucIndex] = ucLength;
+		psDec->usValid |= (1 << ucIndex);
+		psDec->sStats.ulReceived++;
+
+		_NRF24L01_FECRecover(psDec, ucClass);
+	}
+
+	for(usReady = psDec->usValid & ~psDec->usRead; usReady; usReady >>= 1)
+	{
+		ret += usReady & 1;
+	}
+
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_FECRead
+ *
+ * Arguments	: 	psDec		:	Decoder
+ * 					pcData		:	Buffer for the data
+ * 					length		:	Size of the buffer, returns the length of the data
+ *
+ * Return		: 	Positive or 0					:	Number of bytes read
+ * 					PDLIB_NRF24_ERROR				:	No packet to read
+ * 					PDLIB_NRF24_BUFFER_TOO_SMALL	:	Buffer is smaller than the data
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ *
+ * Description	: 	Gives out the received or rebuilt data packet with the
+ * 					lowest index in the group which is not read yet.
+ *
+ */
+
+int
+NRF24L01_FECRead(NRF24L01_FECDecoder *psDec, char *pcData, char *length)
+{
+	unsigned short usReady;
+	unsigned char i;
+
+	if((NULL == psDec) || (NULL == pcData) || (NULL == length))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	usReady = psDec->usValid & ~psDec->usRead;
+
+	for(i = 0; i < psDec->ucData; i++)
+	{
+		if(usReady & (1 << i))
+		{
+			if((unsigned char)(*length) < psDec->pucLength[i])
+			{
+				return PDLIB_NRF24_BUFFER_TOO_SMALL;
+			}
+
+			(*length) = psDec->pucLength[i];
+			memcpy(pcData, psDec->pcSlots[i], psDec->pucLength[i]);
+			psDec->usRead |= (1 << i);
+
+			return psDec->pucLength[i];
+		}
+	}
+
+	return PDLIB_NRF24_ERROR;
+}
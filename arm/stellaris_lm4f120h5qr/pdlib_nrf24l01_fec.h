@@ -0,0 +1,78 @@
+#ifndef _PDLIB_NRF24L01_FEC
+#define _PDLIB_NRF24L01_FEC
+
+#include "pdlib_nrf24l01.h"
+
+/* Configurations */
+
+/* PS: Largest group, data packets per group */
+#ifndef PDLIB_NRF24_FEC_MAX_DATA
+#define PDLIB_NRF24_FEC_MAX_DATA		16
+#endif
+
+/* PS: Largest parity count per group. Maximum is 4 */
+#ifndef PDLIB_NRF24_FEC_MAX_PARITY
+#define PDLIB_NRF24_FEC_MAX_PARITY		4
+#endif
+
+/* PS: Three bytes of each packet are used for the header */
+#define PDLIB_NRF24_FEC_HEADER_SIZE		3
+#define PDLIB_NRF24_FEC_PAYLOAD_SIZE	29
+
+typedef struct
+{
+	unsigned char ucData;
+	unsigned char ucParity;
+	unsigned char ucGroup;
+	unsigned char ucCount;
+
+	/* PS: Parity of each class, sent once the group is complete */
+	char pcParity[PDLIB_NRF24_FEC_MAX_PARITY][PDLIB_NRF24_FEC_PAYLOAD_SIZE];
+	unsigned char pucLengthXor[PDLIB_NRF24_FEC_MAX_PARITY];
+	unsigned char pucLengthMax[PDLIB_NRF24_FEC_MAX_PARITY];
+	unsigned char ucParityNext;
+	unsigned char ucParityPending;
+} NRF24L01_FECEncoder;
+
+typedef struct
+{
+	unsigned long ulReceived;
+	unsigned long ulRecovered;
+	unsigned long ulLost;
+	unsigned long ulGroups;
+} NRF24L01_FECStats;
+
+typedef struct
+{
+	unsigned char ucData;
+	unsigned char ucParity;
+	unsigned char ucGroup;
+	unsigned char ucStarted;
+
+	/* PS: Data packets of the group, 0 until a parity packet tells a short group */
+	unsigned char ucCount;
+
+	char pcSlots[PDLIB_NRF24_FEC_MAX_DATA][PDLIB_NRF24_FEC_PAYLOAD_SIZE];
+	unsigned char pucLength[PDLIB_NRF24_FEC_MAX_DATA];
+	unsigned short usValid;
+	unsigned short usRead;
+
+	char pcParity[PDLIB_NRF24_FEC_MAX_PARITY][PDLIB_NRF24_FEC_PAYLOAD_SIZE];
+	unsigned char pucLengthXor[PDLIB_NRF24_FEC_MAX_PARITY];
+	unsigned char ucParityValid;
+
+	NRF24L01_FECStats sStats;
+} NRF24L01_FECDecoder;
+
+/* PS: Function prototypes */
+
+int NRF24L01_FECEncoderInit(NRF24L01_FECEncoder *psEnc, unsigned char ucData, unsigned char ucParity);
+int NRF24L01_FECEncode(NRF24L01_FECEncoder *psEnc, const char *pcData, unsigned int uiLength, char *pcPacket);
+int NRF24L01_FECGetParity(NRF24L01_FECEncoder *psEnc, char *pcPacket);
+void NRF24L01_FECFlush(NRF24L01_FECEncoder *psEnc);
+
+int NRF24L01_FECDecoderInit(NRF24L01_FECDecoder *psDec, unsigned char ucData, unsigned char ucParity);
+int NRF24L01_FECDecode(NRF24L01_FECDecoder *psDec, const char *pcPacket, unsigned char ucLength);
+int NRF24L01_FECRead(NRF24L01_FECDecoder *psDec, char *pcData, char *length);
+
+#endif
@@ -0,0 +1,501 @@
+/*
+ * Please find the license in the GIT repo.
+ *
+ * Description:
+ *
+ * Rateless broadcast of a blob (ie. firmware or configuration) to many
+ * nodes at once. The blob is cut into K source symbols of 27 bytes
+ * (K up to 64). Symbol numbers below K carry the source symbols as they
+ * are, every later symbol number is the XOR of a pseudo random subset of
+ * the source symbols, chosen by the symbol number. The sender keeps
+ * sending new symbols over NOACK frames and each receiver completes the
+ * blob once it holds K independent symbols, whichever frames it missed.
+ * Receivers solve the symbols by Gaussian elimination over GF(2) as they
+ * arrive; a random subset is independent of the ones before with
+ * probability of at least 1/2, so K + 2 symbols are enough on average.
+ *
+ * Packet format:
+ *
+ * 		[0]		:	Blob id
+ * 		[1..2]	:	Blob length (LSB first)
+ * 		[3..4]	:	Symbol number (LSB first)
+ * 		[5..31]	:	Symbol
+ *
+ * Top up:
+ *
+ * Receivers put NRF24L01_FountainGetStatus() in their ack payload. After
+ * the broadcast the sender sends the next symbols to each straggler with
+ * acknowledgement, and NRF24L01_FountainParseStatus() on the ack payload
+ * tells how many more symbols the node needs.
+ *
+ * Usage:
+ *
+ * TX side:
+ *
+ * 		NRF24L01_FountainTxInit(&sTx, blob, len, id);
+ * 		NRF24L01_FountainNext(&sTx, packet);
+ * 		NRF24L01_SendCommand(RF24_W_TX_PAYLOAD_NOACK, packet, 32);
+ *
+ * RX side:
+ *
+ * 		NRF24L01_FountainRxInit(&sRx, buffer, sizeof(buffer));
+ * 		if(0 == NRF24L01_FountainDecode(&sRx, packet, 32))
+ * 			... blob complete in buffer
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pdlib_nrf24l01_fountain.h"
+
+#define FOUNTAIN_STATUS_MAGIC	'F'
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_FountainMask
+ *
+ * Arguments	: 	ucBlobId	:	Blob id
+ * 					ucSymbols	:	Number of source symbols
+ * 					usSymbol	:	Symbol number
+ *
+ * Return		: 	Source symbols XORed into the symbol, bit i for symbol i
+ *
+ * Description	: 	Same on the TX and RX side. Symbol numbers below ucSymbols
+ * 					are the source symbols.
+ *
+ */
+
+static unsigned long long
+_NRF24L01_FountainMask(unsigned char ucBlobId, unsigned char ucSymbols, unsigned short usSymbol)
+{
+	unsigned long long ullMask;
+	unsigned long ulX;
+	unsigned char i;
+
+	if(usSymbol < ucSymbols)
+	{
+		return 1ULL << usSymbol;
+	}
+
+	ullMask = 0;
+
+	/* PS: Each half from its own seed through a multiplying hash. A linear
+	 * generator (ie. xorshift) from one 32 bit seed would leave the masks in
+	 * a 32 dimensional space and the blob could never be solved */
+	for(i = 0; i < 2; i++)
+	{
+		ulX = ((unsigned long)usSymbol << 1) | i | ((unsigned long)ucBlobId << 24);
+
+		ulX ^= ulX >> 16;
+		ulX = (ulX * 0x85EBCA6BUL) & 0xFFFFFFFFUL;
+		ulX ^= ulX >> 13;
+		ulX = (ulX * 0xC2B2AE35UL) & 0xFFFFFFFFUL;
+		ulX ^= ulX >> 16;
+
+		ullMask = (ullMask << 32) | ulX;
+	}
+
+	if(ucSymbols < 64)
+	{
+		ullMask &= (1ULL << ucSymbols) - 1;
+	}
+
+	if(0 == ullMask)
+	{
+		ullMask = 1ULL << (usSymbol % ucSymbols);
+	}
+
+	return ullMask;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_FountainXor
+ *
+ * Arguments	: 	pucDest		:	Accumulator, one symbol
+ * 					pucData		:	Data
+ * 					uiLength	:	Length of the data (up to one symbol)
+ *
+ * Return		: 	None
+ *
+ */
+
+static void
+_NRF24L01_FountainXor(unsigned char *pucDest, const unsigned char *pucData, unsigned int uiLength)
+{
+	unsigned int i;
+
+	for(i = 0; i < uiLength; i++)
+	{
+		pucDest[i] ^= pucData[i];
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_FountainTxInit
+ *
+ * Arguments	: 	psTx		:	Sender
+ * 					pucBlob		:	Blob to send, must stay valid while sending
+ * 					uiLength	:	Length of the blob (Maximum is 1728)
+ * 					ucBlobId	:	Id of the blob, change it for every new blob
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				:	Success
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ *
+ */
+
+int
+NRF24L01_FountainTxInit(NRF24L01_FountainTx *psTx, const unsigned char *pucBlob, unsigned int uiLength, unsigned char ucBlobId)
+{
+	if((NULL == psTx) || (NULL == pucBlob) || (0 == uiLength) ||
+		(uiLength > (PDLIB_NRF24_FOUNTAIN_MAX_SYMBOLS * PDLIB_NRF24_FOUNTAIN_SYMBOL_SIZE)))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	psTx->pucBlob = pucBlob;
+	psTx->usLength = uiLength;
+	psTx->ucBlobId = ucBlobId;
+	psTx->ucSymbols = PDLIB_NRF24_FOUNTAIN_BUFFER_SIZE(uiLength) / PDLIB_NRF24_FOUNTAIN_SYMBOL_SIZE;
+	psTx->usNext = 0;
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_FountainEncode
+ *
+ * Arguments	: 	psTx		:	Sender
+ * 					usSymbol	:	Symbol number
+ * 					pcPacket	:	Packet to send, 32 bytes
+ *
+ * Return		: 	PDLIB_NRF24_FOUNTAIN_PACKET_SIZE	:	Length of the packet
+ * 					PDLIB_NRF24_INVALID_ARGUMENT		:	Invalid input argument
+ *
+ */
+
+int
+NRF24L01_FountainEncode(const NRF24L01_FountainTx *psTx, unsigned short usSymbol, char *pcPacket)
+{
+	unsigned long long ullMask;
+	unsigned int uiOffset;
+	unsigned int uiLength;
+	unsigned char i;
+
+	if((NULL == psTx) || (NULL == pcPacket))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	ullMask = _NRF24L01_FountainMask(psTx->ucBlobId, psTx->ucSymbols, usSymbol);
+
+	pcPacket[0] = psTx->ucBlobId;
+	pcPacket[1] = psTx->usLength & 0xFF;
+	pcPacket[2] = psTx->usLength >> 8;
+	pcPacket[3] = usSymbol & 0xFF;
+	pcPacket[4] = usSymbol >> 8;
+	memset(&pcPacket[PDLIB_NRF24_FOUNTAIN_HEADER_SIZE], 0, PDLIB_NRF24_FOUNTAIN_SYMBOL_SIZE);
+
+	for(i = 0; i < psTx->ucSymbols; i++)
+	{
+		if(ullMask & (1ULL << i))
+		{
+			uiOffset = i * PDLIB_NRF24_FOUNTAIN_SYMBOL_SIZE;
+			uiLength = psTx->usLength - uiOffset;
+
+			if(uiLength > PDLIB_NRF24_FOUNTAIN_SYMBOL_SIZE)
+			{
+				uiLength = PDLIB_NRF24_FOUNTAIN_SYMBOL_SIZE;
+			}
+
+			_NRF24L01_FountainXor((unsigned char *)&pcPacket[PDLIB_NRF24_FOUNTAIN_HEADER_SIZE], &psTx->pucBlob[uiOffset], uiLength);
+		}
+	}
+
+	return PDLIB_NRF24_FOUNTAIN_PACKET_SIZE;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_FountainNext
+ *
+ * Arguments	: 	psTx		:	Sender
+ * 					pcPacket	:	Packet to send, 32 bytes
+ *
+ * Return		: 	Same as NRF24L01_FountainEncode()
+ *
+ * Description	: 	Builds the next symbol. The first K symbols are the source
+ * 					symbols, after that every symbol is a new combination.
+ *
+ */
+
+int
+NRF24L01_FountainNext(NRF24L01_FountainTx *psTx, char *pcPacket)
+{
+	int ret;
+
+	if(NULL == psTx)
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	ret = NRF24L01_FountainEncode(psTx, psTx->usNext, pcPacket);
+
+	/* PS: After wrapping, start again with the combinations */
+	psTx->usNext++;
+
+	if(0 == psTx->usNext)
+	{
+		psTx->usNext = psTx->ucSymbols;
+	}
+
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_FountainRxInit
+ *
+ * Arguments	: 	psRx		:	Receiver
+ * 					pucBlob		:	Buffer for the blob, PDLIB_NRF24_FOUNTAIN_BUFFER_SIZE() of the blob length
+ * 					uiSize		:	Size of the buffer
+ *
+ * Return		: 	None
+ *
+ * Description	: 	The blob id and length are taken from the first packet.
+ *
+ */
+
+void
+NRF24L01_FountainRxInit(NRF24L01_FountainRx *psRx, unsigned char *pucBlob, unsigned int uiSize)
+{
+	if(psRx)
+	{
+		memset(psRx, 0, sizeof(NRF24L01_FountainRx));
+
+		psRx->pucBlob = pucBlob;
+		psRx->uiSize = uiSize;
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_FountainSolve
+ *
+ * Arguments	: 	psRx		:	Receiver with a full rank
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Back substitution. Row c only holds source symbols from c
+ * 					up, so solving from the last row down leaves source symbol
+ * 					c in row c.
+ *
+ */
+
+static void
+_NRF24L01_FountainSolve(NRF24L01_FountainRx *psRx)
+{
+	unsigned char c;
+	unsigned char b;
+
+	for(c = psRx->ucSymbols; c-- > 0; )
+	{
+		for(b = c + 1; b < psRx->ucSymbols; b++)
+		{
+			if(psRx->pullRows[c] & (1ULL << b))
+			{
+				_NRF24L01_FountainXor(&psRx->pucBlob[c * PDLIB_NRF24_FOUNTAIN_SYMBOL_SIZE],
+									&psRx->pucBlob[b * PDLIB_NRF24_FOUNTAIN_SYMBOL_SIZE],
+									PDLIB_NRF24_FOUNTAIN_SYMBOL_SIZE);
+			}
+		}
+
+		psRx->pullRows[c] = 1ULL << c;
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_FountainDecode
+ *
+ * Arguments	: 	psRx		:	Receiver
+ * 					pcPacket	:	Received packet
+ * 					ucLength	:	Length of the packet
+ *
+ * Return		: 	0								:	Blob complete in the buffer
+ * 					Positive						:	Number of symbols still needed
+ * 					PDLIB_NRF24_ERROR				:	Not a valid packet
+ * 					PDLIB_NRF24_BUFFER_TOO_SMALL	:	Buffer is smaller than the blob
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ *
+ * Description	: 	Eliminates the known source symbols from the received symbol
+ * 					and keeps it if something is left. A packet of another blob
+ * 					id starts the new blob.
+ *
+ */
+
+int
+NRF24L01_FountainDecode(NRF24L01_FountainRx *psRx, const char *pcPacket, unsigned char ucLength)
+{
+	unsigned char pucSymbol[PDLIB_NRF24_FOUNTAIN_SYMBOL_SIZE];
+	unsigned long long ullMask;
+	unsigned short usLength;
+	unsigned short usSymbol;
+	unsigned char ucSymbols;
+	unsigned char b;
+
+	if((NULL == psRx) || (NULL == pcPacket) || (NULL == psRx->pucBlob))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	if(PDLIB_NRF24_FOUNTAIN_PACKET_SIZE != ucLength)
+	{
+		return PDLIB_NRF24_ERROR;
+	}
+
+	usLength = (unsigned char)pcPacket[1] | ((unsigned short)(unsigned char)pcPacket[2] << 8);
+	usSymbol = (unsigned char)pcPacket[3] | ((unsigned short)(unsigned char)pcPacket[4] << 8);
+
+	if((0 == usLength) || (usLength > (PDLIB_NRF24_FOUNTAIN_MAX_SYMBOLS * PDLIB_NRF24_FOUNTAIN_SYMBOL_SIZE)))
+	{
+		return PDLIB_NRF24_ERROR;
+	}
+
+	if((0 == psRx->ucStarted) || ((unsigned char)pcPacket[0] != psRx->ucBlobId) || (usLength != psRx->usLength))
+	{
+		if((unsigned int)PDLIB_NRF24_FOUNTAIN_BUFFER_SIZE(usLength) > psRx->uiSize)
+		{
+			return PDLIB_NRF24_BUFFER_TOO_SMALL;
+		}
+
+		memset(psRx->pullRows, 0, sizeof(psRx->pullRows));
+		psRx->ucStarted = 1;
+		psRx->ucBlobId = pcPacket[0];
+		psRx->usLength = usLength;
+		psRx->ucSymbols = PDLIB_NRF24_FOUNTAIN_BUFFER_SIZE(usLength) / PDLIB_NRF24_FOUNTAIN_SYMBOL_SIZE;
+		psRx->ucRank = 0;
+	}
+
+	ucSymbols = psRx->ucSymbols;
+
+	if(psRx->ucRank == ucSymbols)
+	{
+		return 0;
+	}
+
+	psRx->ulReceived++;
+
+	ullMask = _NRF24L01_FountainMask(psRx->ucBlobId, ucSymbols, usSymbol);
+	memcpy(pucSymbol, &pcPacket[PDLIB_NRF24_FOUNTAIN_HEADER_SIZE], PDLIB_NRF24_FOUNTAIN_SYMBOL_SIZE);
+
+	for(b = 0; b < ucSymbols; b++)
+	{
+		if(0 == (ullMask & (1ULL << b)))
+		{
+			continue;
+		}
+
+		if(0 == psRx->pullRows[b])
+		{
+			/* PS: New row with its lowest source symbol b */
+			psRx->pullRows[b] = ullMask;
+			memcpy(&psRx->pucBlob[b * PDLIB_NRF24_FOUNTAIN_SYMBOL_SIZE], pucSymbol, PDLIB_NRF24_FOUNTAIN_SYMBOL_SIZE);
+			psRx->ucRank++;
+
+			if(psRx->ucRank == ucSymbols)
+			{
+				_NRF24L01_FountainSolve(psRx);
+			}
+
+			return ucSymbols - psRx->ucRank;
+		}
+
+		ullMask ^= psRx->pullRows[b];
+		_NRF24L01_FountainXor(pucSymbol, &psRx->pucBlob[b * PDLIB_NRF24_FOUNTAIN_SYMBOL_SIZE], PDLIB_NRF24_FOUNTAIN_SYMBOL_SIZE);
+	}
+
+	psRx->ulRedundant++;
+
+	return ucSymbols - psRx->ucRank;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_FountainGetStatus
+ *
+ * Arguments	: 	psRx		:	Receiver
+ * 					pcStatus	:	Buffer, PDLIB_NRF24_FOUNTAIN_STATUS_SIZE bytes
+ *
+ * Return		: 	PDLIB_NRF24_FOUNTAIN_STATUS_SIZE	:	Length of the status
+ * 					PDLIB_NRF24_INVALID_ARGUMENT		:	Invalid input argument
+ *
+ * Description	: 	Builds the top up status for NRF24L01_SetAckPayload():
+ * 					{'F', blob id, symbols still needed}. Refresh it after
+ * 					each NRF24L01_FountainDecode().
+ *
+ */
+
+int
+NRF24L01_FountainGetStatus(const NRF24L01_FountainRx *psRx, char *pcStatus)
+{
+	if((NULL == psRx) || (NULL == pcStatus))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	pcStatus[0] = FOUNTAIN_STATUS_MAGIC;
+	pcStatus[1] = psRx->ucBlobId;
+	pcStatus[2] = psRx->ucStarted ? (psRx->ucSymbols - psRx->ucRank) : 0xFF;
+
+	return PDLIB_NRF24_FOUNTAIN_STATUS_SIZE;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_FountainParseStatus
+ *
+ * Arguments	: 	psTx		:	Sender
+ * 					pcStatus	:	Ack payload of a receiver
+ * 					ucLength	:	Length of the ack payload
+ *
+ * Return		: 	Positive or 0					:	Symbols the receiver still needs
+ * 					PDLIB_NRF24_ERROR				:	Not a top up status
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ *
+ * Description	: 	A receiver which has no symbol of the blob yet needs K.
+ *
+ */
+
+int
+NRF24L01_FountainParseStatus(const NRF24L01_FountainTx *psTx, const char *pcStatus, unsigned char ucLength)
+{
+	if((NULL == psTx) || (NULL == pcStatus))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	if((ucLength < PDLIB_NRF24_FOUNTAIN_STATUS_SIZE) || (FOUNTAIN_STATUS_MAGIC != pcStatus[0]))
+	{
+		return PDLIB_NRF24_ERROR;
+	}
+
+	if(((unsigned char)pcStatus[1] != psTx->ucBlobId) || ((unsigned char)pcStatus[2] > psTx->ucSymbols))
+	{
+		return psTx->ucSymbols;
+	}
+
+	return (unsigned char)pcStatus[2];
+}
@@ -0,0 +1,60 @@
+#ifndef _PDLIB_NRF24L01_FOUNTAIN
+#define _PDLIB_NRF24L01_FOUNTAIN
+
+#include "pdlib_nrf24l01.h"
+
+/* Configurations */
+
+/* PS: Five bytes of each packet are used for the header */
+#define PDLIB_NRF24_FOUNTAIN_HEADER_SIZE	5
+#define PDLIB_NRF24_FOUNTAIN_SYMBOL_SIZE	27
+#define PDLIB_NRF24_FOUNTAIN_PACKET_SIZE	32
+
+/* PS: Largest blob is 64 symbols (1728 bytes) */
+#define PDLIB_NRF24_FOUNTAIN_MAX_SYMBOLS	64
+
+/* PS: RX buffer size for a blob, the last symbol is decoded in full */
+#define PDLIB_NRF24_FOUNTAIN_BUFFER_SIZE(len)	((((len) + PDLIB_NRF24_FOUNTAIN_SYMBOL_SIZE - 1) / PDLIB_NRF24_FOUNTAIN_SYMBOL_SIZE) * PDLIB_NRF24_FOUNTAIN_SYMBOL_SIZE)
+
+/* PS: Top up status sent in an ack payload */
+#define PDLIB_NRF24_FOUNTAIN_STATUS_SIZE	3
+
+typedef struct
+{
+	const unsigned char *pucBlob;
+	unsigned short usLength;
+	unsigned char ucBlobId;
+	unsigned char ucSymbols;
+	unsigned short usNext;
+} NRF24L01_FountainTx;
+
+typedef struct
+{
+	unsigned char *pucBlob;
+	unsigned int uiSize;
+
+	unsigned char ucStarted;
+	unsigned char ucBlobId;
+	unsigned short usLength;
+	unsigned char ucSymbols;
+	unsigned char ucRank;
+
+	/* PS: Row c holds a symbol with its lowest source symbol c, data in pucBlob */
+	unsigned long long pullRows[PDLIB_NRF24_FOUNTAIN_MAX_SYMBOLS];
+
+	unsigned long ulReceived;
+	unsigned long ulRedundant;
+} NRF24L01_FountainRx;
+
+/* PS: Function prototypes */
+
+int NRF24L01_FountainTxInit(NRF24L01_FountainTx *psTx, const unsigned char *pucBlob, unsigned int uiLength, unsigned char ucBlobId);
+int NRF24L01_FountainEncode(const NRF24L01_FountainTx *psTx, unsigned short usSymbol, char *pcPacket);
+int NRF24L01_FountainNext(NRF24L01_FountainTx *psTx, char *pcPacket);
+
+void NRF24L01_FountainRxInit(NRF24L01_FountainRx *psRx, unsigned char *pucBlob, unsigned int uiSize);
+int NRF24L01_FountainDecode(NRF24L01_FountainRx *psRx, const char *pcPacket, unsigned char ucLength);
+int NRF24L01_FountainGetStatus(const NRF24L01_FountainRx *psRx, char *pcStatus);
+int NRF24L01_FountainParseStatus(const NRF24L01_FountainTx *psTx, const char *pcStatus, unsigned char ucLength);
+
+#endif
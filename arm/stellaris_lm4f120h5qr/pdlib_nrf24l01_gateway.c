@@ -0,0 +1,482 @@
+/*
+ * Please find the license in the GIT repo.
+ *
+ * Description:
+ *
+ * Gateway engine for Linux hosts with several modules, built with
+ * PDLIB_OS and PDLIB_OS_POSIX. Each module gets a worker thread, which
+ * can be pinned to a core. The worker sends the frames queued by the
+ * application, keeps the module in RX mode in between and drains the RX
+ * FIFO.
+ *
+ * Frames are handed over in batches through lock free single producer,
+ * single consumer rings of pool frame pointers, one publish per batch.
+ * Several application threads may send to one radio, they are
+ * serialised by a producer mutex. Only one thread should receive from a
+ * radio.
+ *
+ * The driver keeps its state in globals, so SPI access of all workers is
+ * still serialised by the driver lock (see pdlib_nrf24l01_rtos.c). The
+ * workers overlap the waiting, not the SPI transactions.
+ *
+ * On a host the modules are emulated: build with PDLIB_SPI and
+ * PDLIB_NRF24_EMU and link common/emu/pdlib_nrf24l01_emu.c instead of
+ * pdlib_spi.c. For the IRQ pin, register a handler with
+ * NRF24L01_EmuSetIRQHandler() which calls NRF24L01_OSIRQHandler(), and
+ * pass a non zero ulIRQBase. There is no spidev/GPIO backend for real
+ * modules on Linux yet, it would go behind the same pdlibSPI_* and CE/CSN
+ * calls. Without PDLIB_SPI NRF24L01_GatewayStart() fails.
+ *
+ * Usage:
+ *
+ * [1]. Call NRF24L01_OSInit() and initialize the modules
+ * [2]. NRF24L01_GatewayStart() for each module
+ * [3]. Send with NRF24L01_GatewaySend(), receive with NRF24L01_GatewayReceive()
+ * [4]. Release the received frames with NRF24L01_FrameRelease()
+ *
+ */
+
+#if defined(PDLIB_OS) && defined(PDLIB_OS_POSIX)
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <sched.h>
+#include "pdlib_nrf24l01_gateway.h"
+
+#define RING_MASK	(PDLIB_NRF24_GW_RING_SIZE - 1)
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_RingPush
+ *
+ * Arguments	: 	psRing		:	Ring
+ * 					ppsFrames	:	Frames to add
+ * 					uiCount		:	Number of frames
+ *
+ * Return		: 	Number of frames added, the first ones of ppsFrames
+ *
+ * Description	: 	Producer side. The frames are published with one store.
+ *
+ */
+
+unsigned int
+NRF24L01_RingPush(NRF24L01_Ring *psRing, NRF24L01_Frame **ppsFrames, unsigned int uiCount)
+{
+	unsigned int uiTail = psRing->uiTail;
+	unsigned int uiHead = __atomic_load_n(&psRing->uiHead, __ATOMIC_ACQUIRE);
+	unsigned int uiFree = PDLIB_NRF24_GW_RING_SIZE - (uiTail - uiHead);
+	unsigned int i;
+
+	if(uiCount > uiFree)
+	{
+		uiCount = uiFree;
+	}
+
+	for(i = 0; i < uiCount; i++)
+	{
+		psRing->psSlots[(uiTail + i) & RING_MASK] = ppsFrames[i];
+	}
+
+	__atomic_store_n(&psRing->uiTail, uiTail + uiCount, __ATOMIC_RELEASE);
+
+	return uiCount;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_RingPop
+ *
+ * Arguments	: 	psRing			:	Ring
+ * 					ppsFrames [out]	:	Removed frames
+ * 					uiMax			:	Size of ppsFrames
+ *
+ * Return		: 	Number of frames removed
+ *
+ * Description	: 	Consumer side. The slots are freed with one store.
+ *
+ */
+
+unsigned int
+NRF24L01_RingPop(NRF24L01_Ring *psRing, NRF24L01_Frame **ppsFrames, unsigned int uiMax)
+{
+	unsigned int uiHead = psRing->uiHead;
+	unsigned int uiTail = __atomic_load_n(&psRing->uiTail, __ATOMIC_ACQUIRE);
+	unsigned int uiCount = uiTail - uiHead;
+	unsigned int i;
+
+	if(uiCount > uiMax)
+	{
+		uiCount = uiMax;
+	}
+
+	for(i = 0; i < uiCount; i++)
+	{
+		ppsFrames[i] = psRing->psSlots[(uiHead + i) & RING_MASK];
+	}
+
+	__atomic_store_n(&psRing->uiHead, uiHead + uiCount, __ATOMIC_RELEASE);
+
+	return uiCount;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_GatewayWorker
+ *
+ * Arguments	: 	pvArg		:	NRF24L01_GatewayRadio
+ *
+ * Return		: 	NULL
+ *
+ * Description	: 	Worker thread. Each step sends one batch, returns to RX mode
+ * 					and drains up to one batch from the RX FIFO. Sleeps on the
+ * 					radio semaphore when there was nothing to do, which is given
+ * 					by the IRQ handler and by NRF24L01_GatewaySend(). While the
+ * 					pool is empty the RX FIFO is checked every
+ * 					PDLIB_NRF24_OS_POLL_US.
+ *
+ */
+
+static void *
+_NRF24L01_GatewayWorker(void *pvArg)
+{
+	NRF24L01_GatewayRadio *psGw = (NRF24L01_GatewayRadio*)pvArg;
+	NRF24L01_OSRadio *psRadio = &psGw->sRadio;
+	NRF24L01_Frame *psBatch[PDLIB_NRF24_GW_BATCH];
+	unsigned char ucRxOn = 0;
+	unsigned char ucPending;
+	unsigned char ucFifoStatus;
+	unsigned int uiTx;
+	unsigned int uiRx;
+	unsigned int uiPushed;
+	unsigned int i;
+
+	while(psGw->iRunning)
+	{
+		uiTx = NRF24L01_RingPop(&psGw->sTxRing, psBatch, PDLIB_NRF24_GW_BATCH);
+
+		for(i = 0; i < uiTx; i++)
+		{
+			if(PDLIB_NRF24_SUCCESS == NRF24L01_OSSend(psRadio, psBatch[i]->pcData, psBatch[i]->ucLength, PDLIB_NRF24_GW_TX_TIMEOUT_US))
+			{
+				psGw->ulTxFrames++;
+			}else
+			{
+				psGw->ulTxFailed++;
+			}
+
+			NRF24L01_FrameRelease(psBatch[i]);
+		}
+
+		if(uiTx)
+		{
+			ucRxOn = 0;
+		}
+
+		uiRx = 0;
+
+		NRF24L01_OSLock(psRadio->psDevice);
+
+		if(0 == ucRxOn)
+		{
+			NRF24L01_EnableRxMode();
+			ucRxOn = 1;
+		}
+
+		while((uiRx < PDLIB_NRF24_GW_BATCH) && (NULL != (psBatch[uiRx] = NRF24L01_FrameReceive())))
+		{
+			uiRx++;
+		}
+
+		/* PS: A full batch may have left payloads, RX_DR is cleared only once the RX FIFO is empty */
+		ucPending = (PDLIB_NRF24_GW_BATCH == uiRx) ? 1 : 0;
+		ucFifoStatus = RF24_RX_EMPTY;
+
+		if(0 == ucPending)
+		{
+			ucFifoStatus = NRF24L01_RegisterRead_8(RF24_FIFO_STATUS);
+
+			if(ucFifoStatus & RF24_RX_EMPTY)
+			{
+				NRF24L01_ClearInterruptFlag(PDLIB_INTERRUPT_DATA_READY);
+
+				/* PS: A payload received before the clear would not be signalled again */
+				ucFifoStatus = NRF24L01_RegisterRead_8(RF24_FIFO_STATUS);
+				ucPending = (ucFifoStatus & RF24_RX_EMPTY) ? 0 : 1;
+			}
+		}
+
+		NRF24L01_OSUnlock();
+
+		if(uiRx)
+		{
+			uiPushed = NRF24L01_RingPush(&psGw->sRxRing, psBatch, uiRx);
+
+			for(i = uiPushed; i < uiRx; i++)
+			{
+				NRF24L01_FrameRelease(psBatch[i]);
+			}
+
+			psGw->ulRxFrames += uiPushed;
+			psGw->ulRxDropped += uiRx - uiPushed;
+
+			pdlibOS_SemaphoreGive(psGw->sRxReady);
+		}
+
+		if((0 == uiTx) && (0 == uiRx) && (0 == ucPending))
+		{
+			if(ucFifoStatus & RF24_RX_EMPTY)
+			{
+				NRF24L01_OSSleep(psRadio, PDLIB_NRF24_WAIT_FOREVER);
+			}else
+			{
+				/* PS: Pool empty, the payloads wait in the RX FIFO with RX_DR set. The
+				 * pin interrupt stays off, it would fire at once */
+				pdlibOS_SemaphoreTake(psRadio->sIRQ, PDLIB_NRF24_OS_POLL_US);
+			}
+		}
+	}
+
+	NRF24L01_OSLock(psRadio->psDevice);
+	NRF24L01_DisableRxMode();
+	NRF24L01_PowerDown();
+	NRF24L01_OSUnlock();
+
+	return NULL;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_GatewayRelease
+ *
+ * Arguments	: 	psGw		:	Gateway radio without a worker
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Deletes the OS objects created by NRF24L01_GatewayStart().
+ *
+ */
+
+static void
+_NRF24L01_GatewayRelease(NRF24L01_GatewayRadio *psGw)
+{
+	pdlibOS_MutexDelete(psGw->sTxProducers);
+	pdlibOS_SemaphoreDelete(psGw->sRxReady);
+
+	psGw->sTxProducers = NULL;
+	psGw->sRxReady = NULL;
+
+	NRF24L01_OSRadioDeinit(&psGw->sRadio);
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_GatewayStart
+ *
+ * Arguments	: 	psGw		:	Gateway radio
+ * 					psDevice	:	Initialized module
+ * 					ulIRQBase	:	IRQ pin, 0 if not connected (see NRF24L01_OSRadioInit())
+ * 					ulIRQPin	:	IRQ pin
+ * 					iCore		:	Core of the worker, or PDLIB_NRF24_GW_NO_CORE
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				:	Worker running
+ * 					PDLIB_NRF24_ERROR				:	Out of OS resources or no SPI backend (PDLIB_SPI)
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ *
+ * Description	: 	Starts the worker thread of one module.
+ *
+ */
+
+int
+NRF24L01_GatewayStart(NRF24L01_GatewayRadio *psGw, NRF24L01_Device *psDevice, unsigned long ulIRQBase, unsigned long ulIRQPin, int iCore)
+{
+	pthread_attr_t sAttr;
+	cpu_set_t sCores;
+	int ret;
+
+	if((NULL == psGw) || (NULL == psDevice))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+#ifndef PDLIB_SPI
+	/* PS: No bus backend, the worker would run against no module */
+	return PDLIB_NRF24_ERROR;
+#endif
+
+	memset(psGw, 0, sizeof(NRF24L01_GatewayRadio));
+
+	ret = NRF24L01_OSRadioInit(&psGw->sRadio, psDevice, ulIRQBase, ulIRQPin);
+
+	if(PDLIB_NRF24_SUCCESS != ret)
+	{
+		return ret;
+	}
+
+	if((PDLIB_OS_SUCCESS != pdlibOS_MutexCreate(&psGw->sTxProducers)) ||
+	   (PDLIB_OS_SUCCESS != pdlibOS_SemaphoreCreate(&psGw->sRxReady)))
+	{
+		_NRF24L01_GatewayRelease(psGw);
+		return PDLIB_NRF24_ERROR;
+	}
+
+	psGw->iCore = iCore;
+	psGw->iRunning = 1;
+
+	pthread_attr_init(&sAttr);
+
+	if(PDLIB_NRF24_GW_NO_CORE != iCore)
+	{
+		CPU_ZERO(&sCores);
+		CPU_SET(iCore, &sCores);
+		pthread_attr_setaffinity_np(&sAttr, sizeof(sCores), &sCores);
+	}
+
+	ret = pthread_create(&psGw->sThread, &sAttr, _NRF24L01_GatewayWorker, psGw);
+
+	pthread_attr_destroy(&sAttr);
+
+	if(0 != ret)
+	{
+		psGw->iRunning = 0;
+		_NRF24L01_GatewayRelease(psGw);
+		return PDLIB_NRF24_ERROR;
+	}
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_GatewayStop
+ *
+ * Arguments	: 	psGw		:	Gateway radio
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Stops the worker and powers the module down. Frames still in
+ * 					the rings are released and the OS objects are deleted, so
+ * 					the radio can be started again.
+ *
+ */
+
+void
+NRF24L01_GatewayStop(NRF24L01_GatewayRadio *psGw)
+{
+	NRF24L01_Frame *psFrame;
+
+	if((NULL == psGw) || (0 == psGw->iRunning))
+	{
+		return;
+	}
+
+	psGw->iRunning = 0;
+	pdlibOS_SemaphoreGive(psGw->sRadio.sIRQ);
+	pthread_join(psGw->sThread, NULL);
+
+	while(NRF24L01_RingPop(&psGw->sTxRing, &psFrame, 1))
+	{
+		NRF24L01_FrameRelease(psFrame);
+	}
+
+	while(NRF24L01_RingPop(&psGw->sRxRing, &psFrame, 1))
+	{
+		NRF24L01_FrameRelease(psFrame);
+	}
+
+	_NRF24L01_GatewayRelease(psGw);
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_GatewaySend
+ *
+ * Arguments	: 	psGw		:	Gateway radio
+ * 					ppsFrames	:	Frames to send
+ * 					uiCount		:	Number of frames
+ *
+ * Return		: 	Number of frames queued, the first ones of ppsFrames
+ *
+ * Description	: 	Queues frames for the worker. The references of the queued
+ * 					frames pass to the worker, the caller keeps the rest.
+ *
+ */
+
+unsigned int
+NRF24L01_GatewaySend(NRF24L01_GatewayRadio *psGw, NRF24L01_Frame **ppsFrames, unsigned int uiCount)
+{
+	unsigned int uiQueued;
+
+	pdlibOS_MutexLock(psGw->sTxProducers);
+	uiQueued = NRF24L01_RingPush(&psGw->sTxRing, ppsFrames, uiCount);
+	pdlibOS_MutexUnlock(psGw->sTxProducers);
+
+	if(uiQueued)
+	{
+		pdlibOS_SemaphoreGive(psGw->sRadio.sIRQ);
+	}
+
+	return uiQueued;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_GatewayReceive
+ *
+ * Arguments	: 	psGw			:	Gateway radio
+ * 					ppsFrames [out]	:	Received frames
+ * 					uiMax			:	Size of ppsFrames
+ * 					ulTimeoutUs		:	Timeout in microseconds, 0 to not wait or
+ * 										PDLIB_NRF24_WAIT_FOREVER
+ *
+ * Return		: 	Number of frames, or PDLIB_NRF24_TIMEOUT
+ *
+ * Description	: 	Takes a batch of received frames. The caller releases them.
+ *
+ */
+
+int
+NRF24L01_GatewayReceive(NRF24L01_GatewayRadio *psGw, NRF24L01_Frame **ppsFrames, unsigned int uiMax, unsigned long ulTimeoutUs)
+{
+	unsigned long ulStart = pdlibOS_GetTimeUs();
+	unsigned long ulElapsed;
+	unsigned int uiCount;
+
+	while(1)
+	{
+		uiCount = NRF24L01_RingPop(&psGw->sRxRing, ppsFrames, uiMax);
+
+		if(uiCount)
+		{
+			return (int)uiCount;
+		}
+
+		if(PDLIB_NRF24_WAIT_FOREVER == ulTimeoutUs)
+		{
+			pdlibOS_SemaphoreTake(psGw->sRxReady, PDLIB_OS_WAIT_FOREVER);
+			continue;
+		}
+
+		ulElapsed = pdlibOS_GetTimeUs() - ulStart;
+
+		if(ulElapsed >= ulTimeoutUs)
+		{
+			return PDLIB_NRF24_TIMEOUT;
+		}
+
+		pdlibOS_SemaphoreTake(psGw->sRxReady, ulTimeoutUs - ulElapsed);
+	}
+}
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef _PDLIB_NRF24L01_GATEWAY
+#define _PDLIB_NRF24L01_GATEWAY
+
+#include <pthread.h>
+#include "pdlib_nrf24l01_rtos.h"
+
+/* Configurations */
+
+/* PS: Frames per ring, must be a power of 2 */
+#ifndef PDLIB_NRF24_GW_RING_SIZE
+#define PDLIB_NRF24_GW_RING_SIZE	64
+#endif
+
+/* PS: Frames moved per worker step */
+#ifndef PDLIB_NRF24_GW_BATCH
+#define PDLIB_NRF24_GW_BATCH		8
+#endif
+
+#ifndef PDLIB_NRF24_GW_TX_TIMEOUT_US
+#define PDLIB_NRF24_GW_TX_TIMEOUT_US	10000
+#endif
+
+#define PDLIB_NRF24_GW_NO_CORE		-1
+
+/* PS: Single producer, single consumer ring of frame pointers */
+typedef struct
+{
+	NRF24L01_Frame *psSlots[PDLIB_NRF24_GW_RING_SIZE];
+	unsigned int uiHead;
+	unsigned int uiTail;
+} NRF24L01_Ring;
+
+/* PS: One radio and its worker thread */
+typedef struct
+{
+	NRF24L01_OSRadio sRadio;
+
+	/* PS: Application -> worker and worker -> application */
+	NRF24L01_Ring sTxRing;
+	NRF24L01_Ring sRxRing;
+	pdlibOS_Mutex sTxProducers;
+	pdlibOS_Semaphore sRxReady;
+
+	pthread_t sThread;
+	int iCore;
+	volatile int iRunning;
+
+	unsigned long ulTxFrames;
+	unsigned long ulTxFailed;
+	unsigned long ulRxFrames;
+	unsigned long ulRxDropped;
+} NRF24L01_GatewayRadio;
+
+/* PS: Function prototypes */
+
+unsigned int NRF24L01_RingPush(NRF24L01_Ring *psRing, NRF24L01_Frame **ppsFrames, unsigned int uiCount);
+unsigned int NRF24L01_RingPop(NRF24L01_Ring *psRing, NRF24L01_Frame **ppsFrames, unsigned int uiMax);
+
+int NRF24L01_GatewayStart(NRF24L01_GatewayRadio *psGw, NRF24L01_Device *psDevice, unsigned long ulIRQBase, unsigned long ulIRQPin, int iCore);
+void NRF24L01_GatewayStop(NRF24L01_GatewayRadio *psGw);
+unsigned int NRF24L01_GatewaySend(NRF24L01_GatewayRadio *psGw, NRF24L01_Frame **ppsFrames, unsigned int uiCount);
+int NRF24L01_GatewayReceive(NRF24L01_GatewayRadio *psGw, NRF24L01_Frame **ppsFrames, unsigned int uiMax, unsigned long ulTimeoutUs);
+
+#endif
@@ -0,0 +1,562 @@
+/*
+ * Please find the license in the GIT repo.
+ *
+ * Description:
+ *
+ * Isochronous streaming for fixed rate sample streams. The TX side sends
+ * one frame per period from a timer interrupt, straight to the TX FIFO as
+ * NOACK packets, so every tick costs the same SPI transfers. Each frame
+ * carries a sequence number and the sender time of its samples.
+ *
+ * The RX side keeps the frames in a jitter buffer and gives frame n out
+ * at sender time(n) + offset + delay in local time. The offset between
+ * the two clocks is the smallest transit time seen over the last
+ * PDLIB_NRF24_ISO_DRIFT_WINDOW frames and follows it slowly, so drift
+ * between the clocks neither empties nor fills the buffer. A frame which
+ * is not there at its playout time is concealed: by the conceal hook, or
+ * by repeating the last frame.
+ *
+ * Packet format:
+ *
+ * 		[0..1]	:	Sequence number (LSB first)
+ * 		[2..5]	:	Sender time in microseconds (LSB first)
+ * 		[6..31]	:	Samples
+ *
+ * Usage:
+ *
+ * TX side, with NRF24L01_EnableFeatureNoAckTx(), dynamic payload and
+ * NRF24L01_EnableTxMode() (CE stays high):
+ *
+ * 		NRF24L01_IsoTxInit(&sTx, 1000, FillSamples, NULL);
+ * 		NRF24L01_IsoTxTimerInit(&sTx, TIMER0_BASE, SYSCTL_PERIPH_TIMER0, INT_TIMER0A);
+ *
+ * 		void Timer0AIntHandler() { NRF24L01_IsoTxTimerHandler(&sTx); }
+ *
+ * RX side, in RX mode with a clock source (NRF24L01_SetClockSource()):
+ *
+ * 		NRF24L01_IsoRxInit(&sRx, 1000, 16, 4, NULL, NULL);
+ *
+ * 		NRF24L01_IsoRxService(&sRx, PDLIB_NRF24_PIPE1);
+ * 		if(NRF24L01_IsoRxGet(&sRx, data, &length) >= 0)
+ * 			... play the frame
+ *
+ * The TX tick accesses the module from the interrupt, do not use the
+ * same module from the main loop.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pdlib_nrf24l01_iso.h"
+
+#ifdef PART_LM4F120H5QR
+#include "inc/hw_types.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/rom.h"
+#include "driverlib/interrupt.h"
+#include "driverlib/timer.h"
+#endif
+
+#define ISO_WINDOW_NONE		0x7FFFFFFFL
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_IsoDiff
+ *
+ * Arguments	: 	ulA			:	Time in microseconds
+ * 					ulB			:	Time in microseconds
+ *
+ * Return		: 	ulA - ulB as a signed 32 bit difference
+ *
+ * Description	: 	Sender times are 32 bit, so times are compared modulo 2^32.
+ *
+ */
+
+static long
+_NRF24L01_IsoDiff(unsigned long ulA, unsigned long ulB)
+{
+	unsigned long ulDiff = (ulA - ulB) & 0xFFFFFFFFUL;
+
+	if(ulDiff & 0x80000000UL)
+	{
+		return -(long)((0x100000000ULL - ulDiff) & 0xFFFFFFFFUL);
+	}
+
+	return (long)ulDiff;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_IsoTxInit
+ *
+ * Arguments	: 	psTx		:	Sender
+ * 					ulPeriodUs	:	Frame period in microseconds
+ * 					pfnFill		:	Gives the samples of each frame
+ * 					pvContext	:	Passed to pfnFill
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				:	Success
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ *
+ */
+
+int
+NRF24L01_IsoTxInit(NRF24L01_IsoTx *psTx, unsigned long ulPeriodUs, NRF24L01_IsoFillFn pfnFill, void *pvContext)
+{
+	if((NULL == psTx) || (NULL == pfnFill) || (0 == ulPeriodUs))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	memset(psTx, 0, sizeof(NRF24L01_IsoTx));
+
+	psTx->ulPeriodUs = ulPeriodUs;
+	psTx->pfnFill = pfnFill;
+	psTx->pvContext = pvContext;
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_IsoTxTick
+ *
+ * Arguments	: 	psTx		:	Sender
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				:	Frame written to the TX FIFO
+ * 					PDLIB_NRF24_TX_FIFO_FULL		:	Frame dropped, the FIFO did not drain in time
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ *
+ * Description	: 	Sends the next frame. Call it once per period, ie. from a
+ * 					timer interrupt. The sequence number advances on a drop
+ * 					as well, so the receiver sees the gap. The sender time is
+ * 					the clock source, or the nominal schedule without one.
+ *
+ */
+
+int
+NRF24L01_IsoTxTick(NRF24L01_IsoTx *psTx)
+{
+	char pcPacket[PDLIB_NRF24_ISO_HEADER_SIZE + PDLIB_NRF24_ISO_PAYLOAD_SIZE];
+	unsigned long ulTimestamp;
+	unsigned short usSeq;
+	int iLength;
+
+	if(NULL == psTx)
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	usSeq = psTx->usSeq++;
+
+	ulTimestamp = NRF24L01_GetClockSource() ? NRF24L01_GetTimeUs() : ((unsigned long)usSeq * psTx->ulPeriodUs);
+
+	iLength = psTx->pfnFill(psTx->pvContext, &pcPacket[PDLIB_NRF24_ISO_HEADER_SIZE], PDLIB_NRF24_ISO_PAYLOAD_SIZE);
+
+	if((iLength < 0) || (iLength > PDLIB_NRF24_ISO_PAYLOAD_SIZE))
+	{
+		iLength = 0;
+	}
+
+	NRF24L01_ClearInterruptFlag(PDLIB_INTERRUPT_DATA_SENT);
+
+	if(NRF24L01_IsTxFifoFull())
+	{
+		psTx->ulOverruns++;
+		return PDLIB_NRF24_TX_FIFO_FULL;
+	}
+
+	pcPacket[0] = usSeq & 0xFF;
+	pcPacket[1] = usSeq >> 8;
+	pcPacket[2] = ulTimestamp & 0xFF;
+	pcPacket[3] = (ulTimestamp >> 8) & 0xFF;
+	pcPacket[4] = (ulTimestamp >> 16) & 0xFF;
+	pcPacket[5] = (ulTimestamp >> 24) & 0xFF;
+
+	NRF24L01_SendCommand(RF24_W_TX_PAYLOAD_NOACK, pcPacket, PDLIB_NRF24_ISO_HEADER_SIZE + iLength);
+
+	psTx->ulSent++;
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+
+#ifdef PART_LM4F120H5QR
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_IsoTxTimerInit
+ *
+ * Arguments	: 	psTx			:	Sender
+ * 					ulTimerBase		:	Timer base address (ie. TIMER0_BASE)
+ * 					ulTimerPeriph	:	Timer peripheral (ie. SYSCTL_PERIPH_TIMER0)
+ * 					ulInterrupt		:	Interrupt of timer A (ie. INT_TIMER0A)
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Starts a periodic 32 bit timer at the frame period. Call
+ * 					NRF24L01_IsoTxTimerHandler() from its interrupt handler.
+ *
+ */
+
+void
+NRF24L01_IsoTxTimerInit(NRF24L01_IsoTx *psTx, unsigned long ulTimerBase, unsigned long ulTimerPeriph, unsigned long ulInterrupt)
+{
+	psTx->ulTimerBase = ulTimerBase;
+
+	ROM_SysCtlPeripheralEnable(ulTimerPeriph);
+
+	ROM_TimerConfigure(ulTimerBase, TIMER_CFG_PERIODIC);
+	ROM_TimerLoadSet(ulTimerBase, TIMER_A, (ROM_SysCtlClockGet() / 1000000) * psTx->ulPeriodUs - 1);
+
+	ROM_TimerIntEnable(ulTimerBase, TIMER_TIMA_TIMEOUT);
+	ROM_IntEnable(ulInterrupt);
+
+	ROM_TimerEnable(ulTimerBase, TIMER_A);
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_IsoTxTimerHandler
+ *
+ * Arguments	: 	psTx			:	Sender
+ *
+ * Return		: 	None
+ *
+ */
+
+void
+NRF24L01_IsoTxTimerHandler(NRF24L01_IsoTx *psTx)
+{
+	ROM_TimerIntClear(psTx->ulTimerBase, TIMER_TIMA_TIMEOUT);
+
+	NRF24L01_IsoTxTick(psTx);
+}
+
+#endif
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_IsoRxInit
+ *
+ * Arguments	: 	psRx		:	Receiver
+ * 					ulPeriodUs	:	Frame period in microseconds, same as the TX side
+ * 					ucDepth		:	Jitter buffer depth in frames (power of two, up to PDLIB_NRF24_ISO_MAX_DEPTH)
+ * 					ucDelay		:	Playout delay in frames (1 ~ ucDepth - 1)
+ * 					pfnConceal	:	Fills lost frames, NULL to repeat the last frame
+ * 					pvContext	:	Passed to pfnConceal
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				:	Success
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument or no clock source
+ *
+ */
+
+int
+NRF24L01_IsoRxInit(NRF24L01_IsoRx *psRx, unsigned long ulPeriodUs, unsigned char ucDepth, unsigned char ucDelay, NRF24L01_IsoConcealFn pfnConceal, void *pvContext)
+{
+	if((NULL == psRx) || (0 == ulPeriodUs) || (NULL == NRF24L01_GetClockSource()) ||
+		(ucDepth < 2) || (ucDepth > PDLIB_NRF24_ISO_MAX_DEPTH) || (ucDepth & (ucDepth - 1)) ||
+		(0 == ucDelay) || (ucDelay >= ucDepth))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	memset(psRx, 0, sizeof(NRF24L01_IsoRx));
+
+	psRx->ulPeriodUs = ulPeriodUs;
+	psRx->ucDepth = ucDepth;
+	psRx->ulDelayUs = ucDelay * ulPeriodUs;
+	psRx->pfnConceal = pfnConceal;
+	psRx->pvContext = pvContext;
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_IsoStart
+ *
+ * Arguments	: 	psRx		:	Receiver
+ * 					usSeq		:	Sequence number of the first frame
+ * 					ulTimestamp	:	Sender time of the first frame
+ * 					ulNowUs		:	Local arrival time of the first frame
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Starts the playout at the given frame, ie. on the first
+ * 					frame or when the sender restarted.
+ *
+ */
+
+static void
+_NRF24L01_IsoStart(NRF24L01_IsoRx *psRx, unsigned short usSeq, unsigned long ulTimestamp, unsigned long ulNowUs)
+{
+	unsigned char i;
+
+	if(psRx->ucStarted)
+	{
+		psRx->sStats.ulResyncs++;
+	}
+
+	for(i = 0; i < psRx->ucDepth; i++)
+	{
+		psRx->psSlots[i].ucValid = 0;
+	}
+
+	psRx->usPlaySeq = usSeq;
+	psRx->ulPlayTimestamp = ulTimestamp - psRx->ulPeriodUs;
+	psRx->ulOffsetUs = ulNowUs - ulTimestamp;
+	psRx->lWindowMinUs = ISO_WINDOW_NONE;
+	psRx->ucWindowCount = 0;
+	psRx->ucStarted = 1;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_IsoRxPut
+ *
+ * Arguments	: 	psRx		:	Receiver
+ * 					pcPacket	:	Received packet
+ * 					ucLength	:	Length of the packet
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				:	Frame stored
+ * 					PDLIB_NRF24_ERROR				:	Not a valid packet, or dropped (late or buffer full)
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ *
+ * Description	: 	Stores a received frame, stamped with its arrival time.
+ * 					Call it as soon as the packet is read from the module,
+ * 					the arrival time feeds the drift compensation.
+ *
+ */
+
+int
+NRF24L01_IsoRxPut(NRF24L01_IsoRx *psRx, const char *pcPacket, unsigned char ucLength)
+{
+	NRF24L01_IsoSlot *psSlot;
+	unsigned long ulTimestamp;
+	unsigned short usSeq;
+	unsigned long ulNowUs;
+	long lTransitUs;
+	short sAhead;
+
+	if((NULL == psRx) || (NULL == pcPacket))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	if((ucLength < PDLIB_NRF24_ISO_HEADER_SIZE) || (ucLength > (PDLIB_NRF24_ISO_HEADER_SIZE + PDLIB_NRF24_ISO_PAYLOAD_SIZE)))
+	{
+		return PDLIB_NRF24_ERROR;
+	}
+
+	usSeq = (unsigned char)pcPacket[0] | ((unsigned short)(unsigned char)pcPacket[1] << 8);
+	ulTimestamp = (unsigned char)pcPacket[2] | ((unsigned long)(unsigned char)pcPacket[3] << 8) |
+				((unsigned long)(unsigned char)pcPacket[4] << 16) | ((unsigned long)(unsigned char)pcPacket[5] << 24);
+
+	ulNowUs = NRF24L01_GetTimeUs();
+
+	if(0 == psRx->ucStarted)
+	{
+		_NRF24L01_IsoStart(psRx, usSeq, ulTimestamp, ulNowUs);
+	}
+
+	sAhead = (short)(usSeq - psRx->usPlaySeq);
+
+	/* PS: Far outside the buffer in either direction, the sender restarted */
+	if((sAhead < -2 * psRx->ucDepth) || (sAhead >= 2 * psRx->ucDepth))
+	{
+		_NRF24L01_IsoStart(psRx, usSeq, ulTimestamp, ulNowUs);
+		sAhead = 0;
+	}
+
+	if(sAhead < 0)
+	{
+		psRx->sStats.ulLate++;
+		return PDLIB_NRF24_ERROR;
+	}
+
+	if(sAhead >= psRx->ucDepth)
+	{
+		psRx->sStats.ulOverruns++;
+		return PDLIB_NRF24_ERROR;
+	}
+
+	psSlot = &psRx->psSlots[usSeq & (psRx->ucDepth - 1)];
+
+	if(0 == psSlot->ucValid)
+	{
+		memcpy(psSlot->pcData, &pcPacket[PDLIB_NRF24_ISO_HEADER_SIZE], ucLength - PDLIB_NRF24_ISO_HEADER_SIZE);
+		psSlot->ucLength = ucLength - PDLIB_NRF24_ISO_HEADER_SIZE;
+		psSlot->usSeq = usSeq;
+		psSlot->ulTimestamp = ulTimestamp;
+		psSlot->ucValid = 1;
+	}
+
+	/* PS: Drift compensation, move the offset a quarter of the way to the smallest transit of each window */
+	lTransitUs = _NRF24L01_IsoDiff(ulNowUs, ulTimestamp + psRx->ulOffsetUs);
+
+	if(lTransitUs < psRx->lWindowMinUs)
+	{
+		psRx->lWindowMinUs = lTransitUs;
+	}
+
+	if(++psRx->ucWindowCount >= PDLIB_NRF24_ISO_DRIFT_WINDOW)
+	{
+		psRx->ulOffsetUs += psRx->lWindowMinUs / 4;
+		psRx->lWindowMinUs = ISO_WINDOW_NONE;
+		psRx->ucWindowCount = 0;
+	}
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_IsoRxService
+ *
+ * Arguments	: 	psRx		:	Receiver
+ * 					ucPipe		:	Data pipe of the stream
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Drains the RX FIFO of the active module to the jitter buffer.
+ *
+ */
+
+void
+NRF24L01_IsoRxService(NRF24L01_IsoRx *psRx, unsigned char ucPipe)
+{
+	char pcPacket[PDLIB_NRF24_ISO_HEADER_SIZE + PDLIB_NRF24_ISO_PAYLOAD_SIZE];
+	unsigned char ucLength;
+
+	NRF24L01_ClearInterruptFlag(PDLIB_INTERRUPT_DATA_READY);
+
+	while(0 == (NRF24L01_RegisterRead_8(RF24_FIFO_STATUS) & RF24_RX_EMPTY))
+	{
+		ucLength = NRF24L01_GetRxDataAmount(ucPipe);
+
+		if((ucLength < PDLIB_NRF24_ISO_HEADER_SIZE) || (ucLength > sizeof(pcPacket)))
+		{
+			NRF24L01_FlushRX();
+			break;
+		}
+
+		NRF24L01_ReadRxPayload(pcPacket, ucLength);
+
+		NRF24L01_IsoRxPut(psRx, pcPacket, ucLength);
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_IsoRxGet
+ *
+ * Arguments	: 	psRx		:	Receiver
+ * 					pcData		:	Buffer for the samples
+ * 					length		:	Size of the buffer, returns the length of the samples
+ *
+ * Return		: 	Positive or 0					:	Length of the frame, received or concealed
+ * 					PDLIB_NRF24_WOULD_BLOCK			:	Next frame is not due yet
+ * 					PDLIB_NRF24_BUFFER_TOO_SMALL	:	Buffer is smaller than the frame
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ *
+ * Description	: 	Gives out the next frame once its playout time is reached.
+ * 					A missing frame is concealed and counted as an underrun if
+ * 					the buffer is empty, or as concealed (lost) otherwise.
+ * 					Call it at least once per period.
+ *
+ */
+
+int
+NRF24L01_IsoRxGet(NRF24L01_IsoRx *psRx, char *pcData, char *length)
+{
+	NRF24L01_IsoSlot *psSlot;
+	unsigned long ulTimestamp;
+	unsigned long ulDue;
+	unsigned char ucHave;
+	int iLength;
+	unsigned char i;
+
+	if((NULL == psRx) || (NULL == pcData) || (NULL == length))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	if(0 == psRx->ucStarted)
+	{
+		return PDLIB_NRF24_WOULD_BLOCK;
+	}
+
+	psSlot = &psRx->psSlots[psRx->usPlaySeq & (psRx->ucDepth - 1)];
+	ucHave = psSlot->ucValid && (psSlot->usSeq == psRx->usPlaySeq);
+
+	ulTimestamp = ucHave ? psSlot->ulTimestamp : (psRx->ulPlayTimestamp + psRx->ulPeriodUs);
+	ulDue = ulTimestamp + psRx->ulOffsetUs + psRx->ulDelayUs;
+
+	if(_NRF24L01_IsoDiff(NRF24L01_GetTimeUs(), ulDue) < 0)
+	{
+		return PDLIB_NRF24_WOULD_BLOCK;
+	}
+
+	if(ucHave)
+	{
+		if((unsigned char)(*length) < psSlot->ucLength)
+		{
+			return PDLIB_NRF24_BUFFER_TOO_SMALL;
+		}
+
+		iLength = psSlot->ucLength;
+		memcpy(pcData, psSlot->pcData, iLength);
+		memcpy(psRx->pcLast, psSlot->pcData, iLength);
+		psRx->ucLastLength = iLength;
+
+		psSlot->ucValid = 0;
+		psRx->sStats.ulPlayed++;
+	}else
+	{
+		for(i = 0; i < psRx->ucDepth; i++)
+		{
+			if(psRx->psSlots[i].ucValid)
+			{
+				break;
+			}
+		}
+
+		if(i < psRx->ucDepth)
+		{
+			psRx->sStats.ulConcealed++;
+		}else
+		{
+			psRx->sStats.ulUnderruns++;
+		}
+
+		if(psRx->pfnConceal)
+		{
+			iLength = psRx->pfnConceal(psRx->pvContext, psRx->usPlaySeq, pcData, (unsigned char)(*length));
+
+			if((iLength < 0) || (iLength > (unsigned char)(*length)))
+			{
+				iLength = 0;
+			}
+		}else
+		{
+			iLength = ((unsigned char)(*length) < psRx->ucLastLength) ? (unsigned char)(*length) : psRx->ucLastLength;
+			memcpy(pcData, psRx->pcLast, iLength);
+		}
+	}
+
+	psRx->ulPlayTimestamp = ulTimestamp;
+	psRx->usPlaySeq++;
+
+	(*length) = iLength;
+
+	return iLength;
+}
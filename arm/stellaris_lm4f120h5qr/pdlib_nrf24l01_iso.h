@@ -0,0 +1,100 @@
+#ifndef _PDLIB_NRF24L01_ISO
+#define _PDLIB_NRF24L01_ISO
+
+#include "pdlib_nrf24l01.h"
+
+/* Configurations */
+
+/* PS: Largest jitter buffer in frames. Should be a power of two */
+#ifndef PDLIB_NRF24_ISO_MAX_DEPTH
+#define PDLIB_NRF24_ISO_MAX_DEPTH		16
+#endif
+
+/* PS: Frames over which the smallest transit time is taken for drift compensation */
+#ifndef PDLIB_NRF24_ISO_DRIFT_WINDOW
+#define PDLIB_NRF24_ISO_DRIFT_WINDOW	64
+#endif
+
+/* PS: Six bytes of each packet are used for the sequence number and timestamp */
+#define PDLIB_NRF24_ISO_HEADER_SIZE		6
+#define PDLIB_NRF24_ISO_PAYLOAD_SIZE	26
+
+/* PS: Gives the samples of the next frame, returns their length (0 ~ uiSize) */
+typedef int (*NRF24L01_IsoFillFn)(void *pvContext, char *pcData, unsigned int uiSize);
+
+/* PS: Fills a lost frame, returns its length (0 ~ uiSize) */
+typedef int (*NRF24L01_IsoConcealFn)(void *pvContext, unsigned short usSeq, char *pcData, unsigned int uiSize);
+
+typedef struct
+{
+	unsigned long ulPeriodUs;
+	NRF24L01_IsoFillFn pfnFill;
+	void *pvContext;
+	unsigned short usSeq;
+	unsigned long ulTimerBase;
+
+	unsigned long ulSent;
+	unsigned long ulOverruns;
+} NRF24L01_IsoTx;
+
+typedef struct
+{
+	char pcData[PDLIB_NRF24_ISO_PAYLOAD_SIZE];
+	unsigned char ucLength;
+	unsigned char ucValid;
+	unsigned short usSeq;
+	unsigned long ulTimestamp;
+} NRF24L01_IsoSlot;
+
+typedef struct
+{
+	unsigned long ulPlayed;
+	unsigned long ulConcealed;
+	unsigned long ulUnderruns;
+	unsigned long ulOverruns;
+	unsigned long ulLate;
+	unsigned long ulResyncs;
+} NRF24L01_IsoStats;
+
+typedef struct
+{
+	unsigned long ulPeriodUs;
+	unsigned char ucDepth;
+	unsigned long ulDelayUs;
+
+	NRF24L01_IsoConcealFn pfnConceal;
+	void *pvContext;
+
+	NRF24L01_IsoSlot psSlots[PDLIB_NRF24_ISO_MAX_DEPTH];
+	unsigned char ucStarted;
+	unsigned short usPlaySeq;
+	unsigned long ulPlayTimestamp;
+
+	/* PS: Local time minus sender time (modulo 2^32), tracked for clock drift */
+	unsigned long ulOffsetUs;
+	long lWindowMinUs;
+	unsigned char ucWindowCount;
+
+	/* PS: Last frame given out, repeated when no conceal hook is set */
+	char pcLast[PDLIB_NRF24_ISO_PAYLOAD_SIZE];
+	unsigned char ucLastLength;
+
+	NRF24L01_IsoStats sStats;
+} NRF24L01_IsoRx;
+
+/* PS: Function prototypes */
+
+int NRF24L01_IsoTxInit(NRF24L01_IsoTx *psTx, unsigned long ulPeriodUs, NRF24L01_IsoFillFn pfnFill, void *pvContext);
+int NRF24L01_IsoTxTick(NRF24L01_IsoTx *psTx);
+
+#ifdef PART_LM4F120H5QR
+void NRF24L01_IsoTxTimerInit(NRF24L01_IsoTx *psTx, unsigned long ulTimerBase, unsigned long ulTimerPeriph, unsigned long ulInterrupt);
+void NRF24L01_IsoTxTimerHandler(NRF24L01_IsoTx *psTx);
+#endif
+
+int NRF24L01_IsoRxInit(NRF24L01_IsoRx *psRx, unsigned long ulPeriodUs, unsigned char ucDepth, unsigned char ucDelay, NRF24L01_IsoConcealFn pfnConceal, void *pvContext);
+int NRF24L01_IsoRxPut(NRF24L01_IsoRx *psRx, const char *pcPacket, unsigned char ucLength);
+void NRF24L01_IsoRxService(NRF24L01_IsoRx *psRx, unsigned char ucPipe);
+int NRF24L01_IsoRxGet(NRF24L01_IsoRx *psRx, char *pcData, char *length);
+
+#endif
@@ -0,0 +1,391 @@
+/*
+ * Please find the license in the GIT repo.
+ *
+ * Description:
+ *
+ * Full duplex link made out of two NRF24L01 modules. The nRF24L01 is
+ * half duplex, therefore one module is kept in PTX mode on one channel
+ * and the other one is kept in PRX mode on another channel. Neither
+ * module changes its mode after NRF24L01_LinkInit(), so there is no
+ * TX/RX turnaround.
+ *
+ * The remote side should use the same setup with the channels and
+ * addresses swapped.
+ *
+ * Usage:
+ *
+ * [1]. Initialize both modules using NRF24L01_InitDevice()
+ * [2]. Call NRF24L01_LinkInit()
+ * [3]. Queue data using NRF24L01_LinkSend(), get data using NRF24L01_LinkReceive()
+ * 		(or NRF24L01_LinkSendFrame() / NRF24L01_LinkReceiveFrame() to pass
+ * 		pool frames without copying)
+ * [4]. Call NRF24L01_LinkService() from the main loop (or when the IRQ of either module asserts)
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pdlib_nrf24l01_link.h"
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_LinkInit
+ *
+ * Arguments	: 	psLink			:	Link context
+ * 					psTxDevice		:	Initialized module used for uplink (PTX)
+ * 					psRxDevice		:	Initialized module used for downlink (PRX)
+ * 					ucTxChannel		:	RF channel of the uplink
+ * 					ucRxChannel		:	RF channel of the downlink
+ * 					pucTxAddress	:	Address of the remote PRX (5 bytes)
+ * 					pucRxAddress	:	Address of this PRX (5 bytes)
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Configures both modules and puts them to their permanent modes.
+ * 					Dynamic payload is enabled on both modules.
+ *
+ */
+
+void
+NRF24L01_LinkInit(	NRF24L01_Link *psLink,
+					NRF24L01_Device *psTxDevice,
+					NRF24L01_Device *psRxDevice,
+					unsigned char ucTxChannel,
+					unsigned char ucRxChannel,
+					unsigned char *pucTxAddress,
+					unsigned char *pucRxAddress)
+{
+	memset(psLink, 0, sizeof(NRF24L01_Link));
+
+	psLink->psTxDevice = psTxDevice;
+	psLink->psRxDevice = psRxDevice;
+
+	/* PS: Uplink module, pipe 0 receives the auto acks */
+	NRF24L01_SelectDevice(psTxDevice);
+
+	NRF24L01_SetRFChannel(ucTxChannel);
+	NRF24L01_SetTXAddress(pucTxAddress);
+	NRF24L01_SetRxAddress(PDLIB_NRF24_PIPE0, pucTxAddress);
+	NRF24L01_EnableFeatureDynPL(PDLIB_NRF24_PIPE0);
+
+	/* PS: CE stays high, module goes to Standby II when the TX FIFO is empty */
+	NRF24L01_EnableTxMode();
+
+	/* PS: Downlink module, data is received on pipe 1 */
+	NRF24L01_SelectDevice(psRxDevice);
+
+	NRF24L01_SetRFChannel(ucRxChannel);
+	NRF24L01_SetRxAddress(PDLIB_NRF24_PIPE1, pucRxAddress);
+	NRF24L01_EnableFeatureDynPL(PDLIB_NRF24_PIPE1);
+
+	NRF24L01_EnableRxMode();
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_LinkSend
+ *
+ * Arguments	: 	psLink		:	Link context
+ * 					pcData		:	Data packet to send
+ * 					uiLength	:	Length of the packet (Maximum is 32)
+ *
+ * Return		:	PDLIB_NRF24_SUCCESS				: Packet is queued
+ * 					PDLIB_NRF24_TX_FIFO_FULL 		: TX queue is full
+ * 					PDLIB_NRF24_QUEUE_FULL			: Frame pool is empty
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	: Invalid input argument
+ *
+ * Description	: 	Copies the packet to a pool frame and queues it for the
+ * 					uplink. The packet is written to the module by
+ * 					NRF24L01_LinkService().
+ *
+ */
+
+int
+NRF24L01_LinkSend(	NRF24L01_Link *psLink,
+					char *pcData,
+					unsigned int uiLength)
+{
+	int ret;
+	NRF24L01_Frame *psFrame;
+
+	if((NULL == pcData) || (0 == uiLength) || (uiLength > PDLIB_NRF24_LINK_PAYLOAD_SIZE))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	if(psLink->sTxQueue.ucCount >= PDLIB_NRF24_LINK_QUEUE_DEPTH)
+	{
+		return PDLIB_NRF24_TX_FIFO_FULL;
+	}
+
+	psFrame = NRF24L01_FrameAlloc();
+
+	if(NULL == psFrame)
+	{
+		return PDLIB_NRF24_QUEUE_FULL;
+	}
+
+	memcpy(psFrame->pcData, pcData, uiLength);
+	psFrame->ucLength = uiLength;
+
+	ret = NRF24L01_LinkSendFrame(psLink, psFrame);
+
+	if(PDLIB_NRF24_SUCCESS != ret)
+	{
+		NRF24L01_FrameRelease(psFrame);
+	}
+
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_LinkSendFrame
+ *
+ * Arguments	: 	psLink		:	Link context
+ * 					psFrame		:	Pool frame to send
+ *
+ * Return		:	PDLIB_NRF24_SUCCESS				: Frame is queued, the link owns the reference
+ * 					PDLIB_NRF24_TX_FIFO_FULL 		: TX queue is full, caller keeps the reference
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	: Invalid input argument
+ *
+ * Description	: 	Queues a pool frame for the uplink without copying it. The
+ * 					reference is released once the frame is written to the module.
+ *
+ */
+
+int
+NRF24L01_LinkSendFrame(	NRF24L01_Link *psLink,
+						NRF24L01_Frame *psFrame)
+{
+	NRF24L01_LinkQueue *psQueue = &psLink->sTxQueue;
+
+	if((NULL == psFrame) || (0 == psFrame->ucLength) || (psFrame->ucLength > PDLIB_NRF24_LINK_PAYLOAD_SIZE))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	if(psQueue->ucCount >= PDLIB_NRF24_LINK_QUEUE_DEPTH)
+	{
+		return PDLIB_NRF24_TX_FIFO_FULL;
+	}
+
+	psQueue->psFrames[psQueue->ucTail] = psFrame;
+
+	psQueue->ucTail = (psQueue->ucTail + 1) % PDLIB_NRF24_LINK_QUEUE_DEPTH;
+	psQueue->ucCount++;
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_LinkReceive
+ *
+ * Arguments	: 	psLink				:	Link context
+ * 					pcData [out]		:	Allocated buffer to store the RX data
+ * 					length	[in/out]	:	Length in bytes of pcData
+ *
+ * Return		:	Positive						: Number of bytes read
+ * 					PDLIB_NRF24_ERROR				: RX queue is empty
+ * 					PDLIB_NRF24_BUFFER_TOO_SMALL	: Buffer is smaller than the packet
+ *
+ * Description	: 	Gets the oldest packet received on the downlink. The packet
+ * 					is removed from the queue only if it is read.
+ *
+ */
+
+int
+NRF24L01_LinkReceive(	NRF24L01_Link *psLink,
+						char *pcData,
+						char *length)
+{
+	int ret = PDLIB_NRF24_ERROR;
+	NRF24L01_LinkQueue *psQueue = &psLink->sRxQueue;
+	NRF24L01_Frame *psFrame;
+
+	if((NULL == pcData) || (NULL == length))
+	{
+		ret = PDLIB_NRF24_INVALID_ARGUMENT;
+	}else if(psQueue->ucCount > 0)
+	{
+		psFrame = psQueue->psFrames[psQueue->ucHead];
+
+		if((*length) >= psFrame->ucLength)
+		{
+			(*length) = psFrame->ucLength;
+			memcpy(pcData, psFrame->pcData, psFrame->ucLength);
+
+			ret = psFrame->ucLength;
+
+			NRF24L01_FrameRelease(NRF24L01_LinkReceiveFrame(psLink));
+		}else
+		{
+			ret = PDLIB_NRF24_BUFFER_TOO_SMALL;
+		}
+	}
+
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_LinkReceiveFrame
+ *
+ * Arguments	: 	psLink		:	Link context
+ *
+ * Return		:	Oldest frame received on the downlink, or NULL if the RX
+ * 					queue is empty
+ *
+ * Description	: 	Removes the oldest frame from the RX queue without copying it.
+ * 					The caller owns the reference and should release the frame
+ * 					using NRF24L01_FrameRelease().
+ *
+ */
+
+NRF24L01_Frame *
+NRF24L01_LinkReceiveFrame(NRF24L01_Link *psLink)
+{
+	NRF24L01_LinkQueue *psQueue = &psLink->sRxQueue;
+	NRF24L01_Frame *psFrame = NULL;
+
+	if(psQueue->ucCount > 0)
+	{
+		psFrame = psQueue->psFrames[psQueue->ucHead];
+
+		psQueue->ucHead = (psQueue->ucHead + 1) % PDLIB_NRF24_LINK_QUEUE_DEPTH;
+		psQueue->ucCount--;
+	}
+
+	return psFrame;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_LinkService
+ *
+ * Arguments	: 	psLink		:	Link context
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Moves queued packets to the TX FIFO of the uplink module and
+ * 					drains the RX FIFO of the downlink module to the RX queue.
+ *
+ * 					If the maximum retransmissions are reached, packets in the
+ * 					TX FIFO are dropped and counted in ulTxLost. When TX_DS is
+ * 					pending too, the acknowledged packets are settled first and
+ * 					only the packets known to be left in the FIFO are counted. If the RX queue
+ * 					is full or the frame pool is empty the packets are left in
+ * 					the RX FIFO.
+ *
+ */
+
+void
+NRF24L01_LinkService(NRF24L01_Link *psLink)
+{
+	NRF24L01_LinkQueue *psQueue;
+	NRF24L01_Frame *psFrame;
+	unsigned char ucStatus;
+	unsigned char ucQueued;
+
+	/* PS: Uplink */
+	NRF24L01_SelectDevice(psLink->psTxDevice);
+
+	ucStatus = NRF24L01_GetStatus();
+
+	if(ucStatus & RF24_MAX_RT)
+	{
+		if(NRF24L01_RegisterRead_8(RF24_FIFO_STATUS) & RF24_FIFO_FULL)
+		{
+			ucQueued = 3;
+		}else if(ucStatus & RF24_TX_DS)
+		{
+			/* PS: TX_DS settles the packets before the failed one. If the FIFO
+			 * isn't full it can't tell how many are left, only the failed one
+			 * is sure to be, so the loss is not over counted */
+			ucQueued = 1;
+		}else
+		{
+			/* PS: Nothing completed since the last clear */
+			ucQueued = (psLink->ucTxInFlight > 2) ? 2 : (psLink->ucTxInFlight ? psLink->ucTxInFlight : 1);
+		}
+
+		/* PS: TX is stalled until MAX_RT is cleared. The flush drops the failed
+		 * packet and the ones written after it */
+		NRF24L01_FlushTX();
+		psLink->ulTxLost += ucQueued;
+		psLink->ucTxInFlight = 0;
+	}else if(psLink->ucTxInFlight)
+	{
+		/* PS: TX_DS is one flag for all the packets sent since the last clear */
+		if(ucStatus & RF24_TX_DS)
+		{
+			psLink->ucTxInFlight--;
+		}
+
+		if(NRF24L01_IsTxFifoEmpty())
+		{
+			psLink->ucTxInFlight = 0;
+		}
+	}
+
+	if(ucStatus & (RF24_MAX_RT | RF24_TX_DS))
+	{
+		NRF24L01_ClearInterruptFlag(PDLIB_INTERRUPT_MAX_RT | PDLIB_INTERRUPT_DATA_SENT);
+	}
+
+	psQueue = &psLink->sTxQueue;
+
+	while(psQueue->ucCount > 0)
+	{
+		psFrame = psQueue->psFrames[psQueue->ucHead];
+
+		/* PS: Written straight from the pool frame, which is released on success */
+		if(PDLIB_NRF24_SUCCESS != NRF24L01_FrameSubmit(psFrame))
+		{
+			break;
+		}
+
+		psQueue->ucHead = (psQueue->ucHead + 1) % PDLIB_NRF24_LINK_QUEUE_DEPTH;
+		psQueue->ucCount--;
+
+		psLink->ucTxInFlight++;
+	}
+
+	/* PS: Downlink */
+	NRF24L01_SelectDevice(psLink->psRxDevice);
+
+	/* PS: Clear RX_DR before reading, a packet received while draining will assert it again */
+	NRF24L01_ClearInterruptFlag(PDLIB_INTERRUPT_DATA_READY);
+
+	psQueue = &psLink->sRxQueue;
+
+	while(0 == (NRF24L01_RegisterRead_8(RF24_FIFO_STATUS) & RF24_RX_EMPTY))
+	{
+		if(psQueue->ucCount >= PDLIB_NRF24_LINK_QUEUE_DEPTH)
+		{
+			psLink->ulRxOverruns++;
+			break;
+		}
+
+		/* PS: NULL if the payload is corrupted (RX FIFO is flushed) or the pool is empty */
+		psFrame = NRF24L01_FrameReceive();
+
+		if(NULL == psFrame)
+		{
+			psLink->ulRxOverruns++;
+			break;
+		}
+
+		psQueue->psFrames[psQueue->ucTail] = psFrame;
+
+		psQueue->ucTail = (psQueue->ucTail + 1) % PDLIB_NRF24_LINK_QUEUE_DEPTH;
+		psQueue->ucCount++;
+	}
+}
@@ -0,0 +1,46 @@
+#ifndef _PDLIB_NRF24L01_LINK
+#define _PDLIB_NRF24L01_LINK
+
+#include "pdlib_nrf24l01.h"
+#include "pdlib_nrf24l01_pool.h"
+
+/* Configurations */
+
+#ifndef PDLIB_NRF24_LINK_QUEUE_DEPTH
+#define PDLIB_NRF24_LINK_QUEUE_DEPTH	8
+#endif
+
+#define PDLIB_NRF24_LINK_PAYLOAD_SIZE	PDLIB_NRF24_FRAME_SIZE
+
+/* PS: Queue of pool frames, each entry holds one reference */
+typedef struct
+{
+	NRF24L01_Frame *psFrames[PDLIB_NRF24_LINK_QUEUE_DEPTH];
+	unsigned char ucHead;
+	unsigned char ucTail;
+	unsigned char ucCount;
+} NRF24L01_LinkQueue;
+
+/* PS: Full duplex link made out of two modules. One is always PTX and the other is always PRX */
+typedef struct
+{
+	NRF24L01_Device *psTxDevice;
+	NRF24L01_Device *psRxDevice;
+	NRF24L01_LinkQueue sTxQueue;
+	NRF24L01_LinkQueue sRxQueue;
+	/* PS: Packets in the TX FIFO of the uplink module */
+	unsigned char ucTxInFlight;
+	unsigned long ulTxLost;
+	unsigned long ulRxOverruns;
+} NRF24L01_Link;
+
+/* PS: Function prototypes */
+
+void NRF24L01_LinkInit(NRF24L01_Link *psLink, NRF24L01_Device *psTxDevice, NRF24L01_Device *psRxDevice, unsigned char ucTxChannel, unsigned char ucRxChannel, unsigned char *pucTxAddress, unsigned char *pucRxAddress);
+int NRF24L01_LinkSend(NRF24L01_Link *psLink, char *pcData, unsigned int uiLength);
+int NRF24L01_LinkReceive(NRF24L01_Link *psLink, char *pcData, char *length);
+int NRF24L01_LinkSendFrame(NRF24L01_Link *psLink, NRF24L01_Frame *psFrame);
+NRF24L01_Frame *NRF24L01_LinkReceiveFrame(NRF24L01_Link *psLink);
+void NRF24L01_LinkService(NRF24L01_Link *psLink);
+
+#endif
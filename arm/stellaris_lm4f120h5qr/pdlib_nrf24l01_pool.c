@@ -0,0 +1,368 @@
+/*
+ * Please find the license in the GIT repo.
+ *
+ * Description:
+ *
+ * Statically allocated pool of 32 byte frames with reference counts.
+ * Queues and protocol layers pass NRF24L01_Frame pointers around instead
+ * of copying payloads. A frame is returned to the pool when the last
+ * holder calls NRF24L01_FrameRelease().
+ *
+ * NRF24L01_FrameReceive() reads the RX payload straight into a frame and
+ * NRF24L01_FrameSubmit() writes the TX payload straight from a frame.
+ *
+ * Alloc, retain and release can be called from an ISR. On a host build
+ * with PDLIB_OS they are protected by the driver lock instead.
+ *
+ * Usage:
+ *
+ * 		NRF24L01_Frame *psFrame = NRF24L01_FrameAlloc();
+ *
+ * 		if(psFrame)
+ * 		{
+ * 			memcpy(psFrame->pcData, data, 23);
+ * 			psFrame->ucLength = 23;
+ *
+ * 			if(PDLIB_NRF24_SUCCESS != NRF24L01_FrameSubmit(psFrame))
+ * 			{
+ * 				NRF24L01_FrameRelease(psFrame);
+ * 			}
+ * 		}
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pdlib_nrf24l01_pool.h"
+
+#ifdef PART_LM4F120H5QR
+#include "inc/hw_types.h"
+#include "driverlib/rom.h"
+#include "driverlib/interrupt.h"
+
+#define POOL_ENTER_CRITICAL(x)	x = ROM_IntMasterDisable()
+#define POOL_EXIT_CRITICAL(x)	do{ if(!(x)) ROM_IntMasterEnable(); }while(0)
+#elif defined(PDLIB_OS)
+#include "pdlib_nrf24l01_rtos.h"
+
+/* PS: No interrupts on the host, frames are shared between threads */
+#define POOL_ENTER_CRITICAL(x)	do{ x = 0; NRF24L01_OSLock(NULL); }while(0)
+#define POOL_EXIT_CRITICAL(x)	do{ (void)x; NRF24L01_OSUnlock(); }while(0)
+#else
+#define POOL_ENTER_CRITICAL(x)	x = 0
+#define POOL_EXIT_CRITICAL(x)	(void)x
+#endif
+
+#define POOL_END	0xFF
+
+static NRF24L01_Frame g_psFrames[PDLIB_NRF24_POOL_SIZE];
+static unsigned char g_ucFreeHead = POOL_END;
+static unsigned char g_ucReady = 0;
+static NRF24L01_PoolStats g_sStats;
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_PoolReset
+ *
+ * Arguments	: 	None
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Puts all the frames to the free list. Called with the
+ * 					interrupts disabled.
+ *
+ */
+
+static void
+_NRF24L01_PoolReset()
+{
+	unsigned char i;
+
+	for(i = 0; i < PDLIB_NRF24_POOL_SIZE; i++)
+	{
+		g_psFrames[i].ucRefCount = 0;
+		g_psFrames[i].ucNext = ((i + 1) < PDLIB_NRF24_POOL_SIZE) ? (i + 1) : POOL_END;
+	}
+
+	g_ucFreeHead = 0;
+	memset(&g_sStats, 0, sizeof(g_sStats));
+
+	g_ucReady = 1;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_PoolInit
+ *
+ * Arguments	: 	None
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Frees all the frames and resets the statistics. The pool is
+ * 					also initialized on the first allocation, so calling this is
+ * 					only needed to reset the pool.
+ *
+ * 					Frames still referenced become invalid.
+ *
+ */
+
+void
+NRF24L01_PoolInit()
+{
+	unsigned char ucMasked;
+
+	POOL_ENTER_CRITICAL(ucMasked);
+	_NRF24L01_PoolReset();
+	POOL_EXIT_CRITICAL(ucMasked);
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_FrameAlloc
+ *
+ * Arguments	: 	None
+ *
+ * Return		: 	Frame with one reference, or NULL if the pool is empty
+ *
+ * Description	: 	Takes a frame from the pool. Length and pipe are cleared.
+ *
+ */
+
+NRF24L01_Frame *
+NRF24L01_FrameAlloc()
+{
+	NRF24L01_Frame *psFrame = NULL;
+	unsigned char ucMasked;
+
+	POOL_ENTER_CRITICAL(ucMasked);
+
+	if(0 == g_ucReady)
+	{
+		_NRF24L01_PoolReset();
+	}
+
+	if(POOL_END != g_ucFreeHead)
+	{
+		psFrame = &g_psFrames[g_ucFreeHead];
+		g_ucFreeHead = psFrame->ucNext;
+
+		psFrame->ucRefCount = 1;
+		psFrame->ucLength = 0;
+		psFrame->ucPipe = 0;
+
+		g_sStats.ucInUse++;
+
+		if(g_sStats.ucInUse > g_sStats.ucHighWater)
+		{
+			g_sStats.ucHighWater = g_sStats.ucInUse;
+		}
+	}else
+	{
+		g_sStats.ulAllocFailures++;
+	}
+
+	POOL_EXIT_CRITICAL(ucMasked);
+
+	return psFrame;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_FrameRetain
+ *
+ * Arguments	: 	psFrame		:	Frame
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Adds a reference, ie. before putting the same frame to a
+ * 					second queue.
+ *
+ */
+
+void
+NRF24L01_FrameRetain(NRF24L01_Frame *psFrame)
+{
+	unsigned char ucMasked;
+
+	if(psFrame)
+	{
+		POOL_ENTER_CRITICAL(ucMasked);
+		psFrame->ucRefCount++;
+		POOL_EXIT_CRITICAL(ucMasked);
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_FrameRelease
+ *
+ * Arguments	: 	psFrame		:	Frame
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Drops a reference. The frame goes back to the pool when the
+ * 					last reference is dropped.
+ *
+ */
+
+void
+NRF24L01_FrameRelease(NRF24L01_Frame *psFrame)
+{
+	unsigned char ucMasked;
+
+	if(psFrame)
+	{
+		POOL_ENTER_CRITICAL(ucMasked);
+
+		if(psFrame->ucRefCount > 0)
+		{
+			psFrame->ucRefCount--;
+
+			if(0 == psFrame->ucRefCount)
+			{
+				psFrame->ucNext = g_ucFreeHead;
+				g_ucFreeHead = (unsigned char)(psFrame - g_psFrames);
+
+				g_sStats.ucInUse--;
+			}
+		}
+
+		POOL_EXIT_CRITICAL(ucMasked);
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_PoolGetStats
+ *
+ * Arguments	: 	psStats [out]	:	Statistics
+ * 					ucReset			:	1 to restart the high water mark from the
+ * 										current occupancy and clear the failures
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Gets the pool occupancy. If the high water mark reaches
+ * 					PDLIB_NRF24_POOL_SIZE or allocations fail, the pool is too small.
+ *
+ */
+
+void
+NRF24L01_PoolGetStats(NRF24L01_PoolStats *psStats, unsigned char ucReset)
+{
+	unsigned char ucMasked;
+
+	POOL_ENTER_CRITICAL(ucMasked);
+
+	if(psStats)
+	{
+		*psStats = g_sStats;
+	}
+
+	if(ucReset)
+	{
+		g_sStats.ucHighWater = g_sStats.ucInUse;
+		g_sStats.ulAllocFailures = 0;
+	}
+
+	POOL_EXIT_CRITICAL(ucMasked);
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_FrameSubmit
+ *
+ * Arguments	: 	psFrame		:	Frame to send (ucLength bytes of pcData)
+ *
+ * Return		:	PDLIB_NRF24_SUCCESS				: Payload is in the TX FIFO, reference is released
+ * 					PDLIB_NRF24_TX_FIFO_FULL 		: Tx FIFO full, caller keeps the reference
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	: Invalid input argument
+ *
+ * Description	: 	Writes the frame to the TX FIFO of the active module, same as
+ * 					NRF24L01_SetTxPayload(). On success the caller's reference is
+ * 					released, so a queue can hand its frame over without a copy.
+ *
+ */
+
+int
+NRF24L01_FrameSubmit(NRF24L01_Frame *psFrame)
+{
+	int ret;
+
+	if((NULL == psFrame) || (0 == psFrame->ucLength) || (psFrame->ucLength > PDLIB_NRF24_FRAME_SIZE))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	ret = NRF24L01_SetTxPayload(psFrame->pcData, psFrame->ucLength);
+
+	if(PDLIB_NRF24_SUCCESS == ret)
+	{
+		NRF24L01_FrameRelease(psFrame);
+	}
+
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_FrameReceive
+ *
+ * Arguments	: 	None
+ *
+ * Return		: 	Frame with one reference, or NULL if the RX FIFO is empty,
+ * 					the payload is corrupted or the pool is empty
+ *
+ * Description	: 	Reads the top most payload of the RX FIFO of the active module
+ * 					into a new frame. ucPipe is set from the STATUS register.
+ *
+ * 					If the pool is empty the payload is left in the RX FIFO and
+ * 					ulAllocFailures is incremented.
+ *
+ */
+
+NRF24L01_Frame *
+NRF24L01_FrameReceive()
+{
+	NRF24L01_Frame *psFrame;
+	unsigned char ucPipe;
+	unsigned char ucLength;
+
+	if(NRF24L01_RegisterRead_8(RF24_FIFO_STATUS) & RF24_RX_EMPTY)
+	{
+		return NULL;
+	}
+
+	ucPipe = (NRF24L01_GetStatus() >> 1) & 0x07;
+
+	if(ucPipe > PDLIB_NRF24_PIPE5)
+	{
+		return NULL;
+	}
+
+	ucLength = NRF24L01_GetRxDataAmount(ucPipe);
+
+	if((0 == ucLength) || (ucLength > PDLIB_NRF24_FRAME_SIZE))
+	{
+		return NULL;
+	}
+
+	psFrame = NRF24L01_FrameAlloc();
+
+	if(psFrame)
+	{
+		NRF24L01_ReadRxPayload(psFrame->pcData, ucLength);
+
+		psFrame->ucLength = ucLength;
+		psFrame->ucPipe = ucPipe;
+	}
+
+	return psFrame;
+}
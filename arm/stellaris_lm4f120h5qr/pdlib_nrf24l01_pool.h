@@ -0,0 +1,44 @@
+#ifndef _PDLIB_NRF24L01_POOL
+#define _PDLIB_NRF24L01_POOL
+
+#include "pdlib_nrf24l01.h"
+
+/* Configurations */
+
+/* PS: Number of frames in the pool. Maximum is 254 */
+#ifndef PDLIB_NRF24_POOL_SIZE
+#define PDLIB_NRF24_POOL_SIZE		16
+#endif
+
+#define PDLIB_NRF24_FRAME_SIZE		32
+
+/* PS: One payload. Owned by whoever holds a reference, freed when the last reference is released */
+typedef struct
+{
+	char pcData[PDLIB_NRF24_FRAME_SIZE];
+	unsigned char ucLength;
+	unsigned char ucPipe;
+	unsigned char ucRefCount;
+	unsigned char ucNext;
+} NRF24L01_Frame;
+
+typedef struct
+{
+	unsigned char ucInUse;
+	unsigned char ucHighWater;
+	unsigned long ulAllocFailures;
+} NRF24L01_PoolStats;
+
+/* PS: Function prototypes */
+
+void NRF24L01_PoolInit();
+NRF24L01_Frame *NRF24L01_FrameAlloc();
+void NRF24L01_FrameRetain(NRF24L01_Frame *psFrame);
+void NRF24L01_FrameRelease(NRF24L01_Frame *psFrame);
+void NRF24L01_PoolGetStats(NRF24L01_PoolStats *psStats, unsigned char ucReset);
+
+/* PS: Driver access straight from/to pool memory */
+int NRF24L01_FrameSubmit(NRF24L01_Frame *psFrame);
+NRF24L01_Frame *NRF24L01_FrameReceive();
+
+#endif
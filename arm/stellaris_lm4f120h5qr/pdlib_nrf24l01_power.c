@@ -0,0 +1,257 @@
+/*
+ * Please find the license in the GIT repo.
+ *
+ * Description:
+ *
+ * Closed loop PA control per destination. A new destination starts at
+ * 0 dBm. After PDLIB_NRF24_POWER_STEP_DOWN sends without a retransmission
+ * the PA is lowered one step (6 dB). When the average retransmission
+ * count (ARC_CNT of OBSERVE_TX) rises above PDLIB_NRF24_POWER_RETRY_HIGH,
+ * or a packet is lost, the PA is raised one step and the next step down
+ * needs twice as many clean sends. So the PA settles at the lowest level
+ * that does not cost retransmissions.
+ *
+ * Needs auto acknowledgement, without it ARC_CNT is always 0.
+ *
+ * Usage:
+ *
+ * 		NRF24L01_PowerControlSelect(&sControl, address);
+ * 		ret = NRF24L01_SendDataTo(address, data, 23);
+ * 		NRF24L01_PowerControlUpdate(&sControl, ret);
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pdlib_nrf24l01_power.h"
+
+/* PS: Longest hold off after a back off */
+#define POWER_STEP_DOWN_MAX		128
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_PowerControlInit
+ *
+ * Arguments	: 	psControl	:	Controller
+ *
+ * Return		: 	None
+ *
+ */
+
+void
+NRF24L01_PowerControlInit(NRF24L01_PowerControl *psControl)
+{
+	if(psControl)
+	{
+		memset(psControl, 0, sizeof(NRF24L01_PowerControl));
+		psControl->ucLevel = 0xFF;
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_PowerFind
+ *
+ * Arguments	: 	psControl	:	Controller
+ * 					pucAddress	:	Destination address
+ * 					ucCreate	:	1 to take an entry if the destination is new
+ *
+ * Return		: 	Entry, or NULL
+ *
+ * Description	: 	When all the entries are used the oldest one is replaced.
+ *
+ */
+
+static NRF24L01_PowerEntry *
+_NRF24L01_PowerFind(NRF24L01_PowerControl *psControl, const unsigned char *pucAddress, unsigned char ucCreate)
+{
+	NRF24L01_PowerEntry *psEntry;
+	unsigned char ucWidth = NRF24L01_GetAddressWidth();
+	unsigned char i;
+
+	for(i = 0; i < PDLIB_NRF24_POWER_DESTINATIONS; i++)
+	{
+		psEntry = &psControl->psEntries[i];
+
+		if(psEntry->ucUsed && (0 == memcmp(psEntry->pucAddress, pucAddress, ucWidth)))
+		{
+			return psEntry;
+		}
+	}
+
+	if(0 == ucCreate)
+	{
+		return NULL;
+	}
+
+	psEntry = &psControl->psEntries[psControl->ucNext];
+	psControl->ucNext = (psControl->ucNext + 1) % PDLIB_NRF24_POWER_DESTINATIONS;
+
+	memset(psEntry, 0, sizeof(NRF24L01_PowerEntry));
+	memcpy(psEntry->pucAddress, pucAddress, ucWidth);
+	psEntry->ucUsed = 1;
+	psEntry->ucLevel = PDLIB_NRF24_POWER_LEVEL_MAX;
+	psEntry->ucStepDown = PDLIB_NRF24_POWER_STEP_DOWN;
+
+	return psEntry;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_PowerControlSelect
+ *
+ * Arguments	: 	psControl	:	Controller
+ * 					pucAddress	:	Address of the next destination
+ *
+ * Return		: 	PA gain in dBm set for the destination
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ *
+ * Description	: 	Sets the PA level of the destination on the active module.
+ * 					RF_SETUP is only written when the level changes. Call it
+ * 					before every send to the destination.
+ *
+ */
+
+int
+NRF24L01_PowerControlSelect(NRF24L01_PowerControl *psControl, const unsigned char *pucAddress)
+{
+	NRF24L01_PowerEntry *psEntry;
+
+	if((NULL == psControl) || (NULL == pucAddress))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	psEntry = _NRF24L01_PowerFind(psControl, pucAddress, 1);
+
+	if(psEntry->ucLevel != psControl->ucLevel)
+	{
+		NRF24L01_SetPAGain(-6 * (PDLIB_NRF24_POWER_LEVEL_MAX - psEntry->ucLevel));
+		psControl->ucLevel = psEntry->ucLevel;
+	}
+
+	psControl->psActive = psEntry;
+
+	return -6 * (PDLIB_NRF24_POWER_LEVEL_MAX - psEntry->ucLevel);
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_PowerControlUpdate
+ *
+ * Arguments	: 	psControl	:	Controller
+ * 					iResult		:	Result of the send to the selected destination
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Reads the retransmission count of the last packet from
+ * 					OBSERVE_TX and adjusts the PA level of the destination
+ * 					for the next send. Sends which did not reach the air (ie.
+ * 					TX FIFO full) are ignored.
+ *
+ */
+
+void
+NRF24L01_PowerControlUpdate(NRF24L01_PowerControl *psControl, int iResult)
+{
+	NRF24L01_PowerEntry *psEntry;
+	unsigned char ucRetries;
+	unsigned char ucRaise = 0;
+
+	if((NULL == psControl) || (NULL == psControl->psActive))
+	{
+		return;
+	}
+
+	psEntry = psControl->psActive;
+
+	if(PDLIB_NRF24_TX_ARC_REACHED == iResult)
+	{
+		psEntry->ulSent++;
+		psEntry->ulLost++;
+		ucRaise = 1;
+	}else if(PDLIB_NRF24_SUCCESS == iResult)
+	{
+		psEntry->ulSent++;
+
+		ucRetries = NRF24L01_RegisterRead_8(RF24_OBSERVE_TX) & 0x0F;
+
+		/* PS: Moving average over ~4 sends */
+		psEntry->usRetryAvg = psEntry->usRetryAvg - (psEntry->usRetryAvg >> 2) + ((unsigned short)ucRetries << 2);
+
+		if(psEntry->usRetryAvg > PDLIB_NRF24_POWER_RETRY_HIGH)
+		{
+			ucRaise = 1;
+		}else if(0 == ucRetries)
+		{
+			psEntry->ucClean++;
+
+			if((psEntry->ucClean >= psEntry->ucStepDown) && (psEntry->ucLevel > PDLIB_NRF24_POWER_LEVEL_MIN))
+			{
+				psEntry->ucLevel--;
+				psEntry->ucClean = 0;
+			}
+		}else
+		{
+			psEntry->ucClean = 0;
+		}
+	}else
+	{
+		return;
+	}
+
+	if(ucRaise)
+	{
+		if(psEntry->ucLevel < PDLIB_NRF24_POWER_LEVEL_MAX)
+		{
+			psEntry->ucLevel++;
+		}
+
+		/* PS: The level below did not work, wait longer before trying it again */
+		if(psEntry->ucStepDown < POWER_STEP_DOWN_MAX)
+		{
+			psEntry->ucStepDown <<= 1;
+		}
+
+		psEntry->ucClean = 0;
+		psEntry->usRetryAvg = 0;
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_PowerControlGetGain
+ *
+ * Arguments	: 	psControl	:	Controller
+ * 					pucAddress	:	Destination address
+ *
+ * Return		: 	PA gain in dBm of the destination
+ * 					PDLIB_NRF24_ERROR				:	Unknown destination
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ *
+ */
+
+int
+NRF24L01_PowerControlGetGain(NRF24L01_PowerControl *psControl, const unsigned char *pucAddress)
+{
+	NRF24L01_PowerEntry *psEntry;
+
+	if((NULL == psControl) || (NULL == pucAddress))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	psEntry = _NRF24L01_PowerFind(psControl, pucAddress, 0);
+
+	if(NULL == psEntry)
+	{
+		return PDLIB_NRF24_ERROR;
+	}
+
+	return -6 * (PDLIB_NRF24_POWER_LEVEL_MAX - psEntry->ucLevel);
+}
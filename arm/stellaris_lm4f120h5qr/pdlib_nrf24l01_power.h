@@ -0,0 +1,62 @@
+#ifndef _PDLIB_NRF24L01_POWER
+#define _PDLIB_NRF24L01_POWER
+
+#include "pdlib_nrf24l01.h"
+
+/* Configurations */
+
+/* PS: Destinations with their own PA level */
+#ifndef PDLIB_NRF24_POWER_DESTINATIONS
+#define PDLIB_NRF24_POWER_DESTINATIONS	8
+#endif
+
+/* PS: Sends without retransmission before the PA is lowered one step */
+#ifndef PDLIB_NRF24_POWER_STEP_DOWN
+#define PDLIB_NRF24_POWER_STEP_DOWN		16
+#endif
+
+/* PS: Average retransmissions per send (x16) which raise the PA one step */
+#ifndef PDLIB_NRF24_POWER_RETRY_HIGH
+#define PDLIB_NRF24_POWER_RETRY_HIGH	16
+#endif
+
+/* PS: PA levels, value of RF_PWR */
+#define PDLIB_NRF24_POWER_LEVEL_MIN		0
+#define PDLIB_NRF24_POWER_LEVEL_MAX		3
+
+typedef struct
+{
+	unsigned char pucAddress[5];
+	unsigned char ucUsed;
+	unsigned char ucLevel;
+
+	/* PS: Consecutive sends without retransmission, and the number needed to step down */
+	unsigned char ucClean;
+	unsigned char ucStepDown;
+
+	/* PS: Average retransmissions per send, x16 */
+	unsigned short usRetryAvg;
+
+	unsigned long ulSent;
+	unsigned long ulLost;
+} NRF24L01_PowerEntry;
+
+/* PS: PA controller for several destinations */
+typedef struct
+{
+	NRF24L01_PowerEntry psEntries[PDLIB_NRF24_POWER_DESTINATIONS];
+	NRF24L01_PowerEntry *psActive;
+	unsigned char ucNext;
+
+	/* PS: Level in RF_SETUP, 0xFF if not known */
+	unsigned char ucLevel;
+} NRF24L01_PowerControl;
+
+/* PS: Function prototypes */
+
+void NRF24L01_PowerControlInit(NRF24L01_PowerControl *psControl);
+int NRF24L01_PowerControlSelect(NRF24L01_PowerControl *psControl, const unsigned char *pucAddress);
+void NRF24L01_PowerControlUpdate(NRF24L01_PowerControl *psControl, int iResult);
+int NRF24L01_PowerControlGetGain(NRF24L01_PowerControl *psControl, const unsigned char *pucAddress);
+
+#endif
@@ -0,0 +1,822 @@
+/*
+ * Please find the license in the GIT repo.
+ *
+ * Description:
+ *
+ * Radio configuration profiles kept outside the firmware. A profile holds
+ * the register values of channel, data rate, power, addresses, pipes,
+ * features and retransmission settings. It is serialized to a versioned
+ * blob protected by NRF24L01_CRC16() and stored through a storage backend,
+ * ie. the on chip EEPROM (NRF24L01_EEPROMStorageInit()).
+ *
+ * At start up the profile is loaded and applied as one write list. A
+ * commissioning tool can send a new blob over the air, which is checked
+ * with NRF24L01_ProfileDecode() and stored with NRF24L01_ProfileSave().
+ *
+ * Usage:
+ *
+ * 		NRF24L01_Storage sStorage;
+ * 		NRF24L01_Profile sProfile;
+ *
+ * 		NRF24L01_EEPROMStorageInit(&sStorage, 0);
+ *
+ * 		if(PDLIB_NRF24_SUCCESS == NRF24L01_ProfileLoad(&sStorage, &sProfile))
+ * 		{
+ * 			NRF24L01_ProfileApply(&sProfile);
+ * 		}
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pdlib_nrf24l01_profile.h"
+
+#ifdef PART_LM4F120H5QR
+#include "inc/hw_types.h"
+#include "driverlib/sysctl.h"
+#include "driverlib/rom.h"
+#include "driverlib/eeprom.h"
+#endif
+
+#define PROFILE_MAGIC0		'n'
+#define PROFILE_MAGIC1		'P'
+#define PROFILE_HEADER		4
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_ProfileCapture
+ *
+ * Arguments	: 	psProfile [out]	:	Profile
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Reads the configuration of the active module, ie. after it
+ * 					was set up with the driver API during commissioning. PWR_UP
+ * 					is not kept, an applied profile leaves the module powered
+ * 					down.
+ *
+ */
+
+void
+NRF24L01_ProfileCapture(NRF24L01_Profile *psProfile)
+{
+	unsigned char i;
+
+	if(NULL == psProfile)
+	{
+		return;
+	}
+
+	memset(psProfile, 0, sizeof(NRF24L01_Profile));
+
+	psProfile->ucConfig = NRF24L01_RegisterRead_8(RF24_CONFIG) & ~(RF24_PWR_UP);
+	psProfile->ucEnAA = NRF24L01_RegisterRead_8(RF24_EN_AA);
+	psProfile->ucEnRxAddr = NRF24L01_RegisterRead_8(RF24_EN_RXADDR);
+	psProfile->ucSetupAW = NRF24L01_RegisterRead_8(RF24_SETUP_AW);
+	psProfile->ucSetupRetr = NRF24L01_RegisterRead_8(RF24_SETUP_RETR);
+	psProfile->ucChannel = NRF24L01_RegisterRead_8(RF24_RF_CH);
+	psProfile->ucRFSetup = NRF24L01_RegisterRead_8(RF24_RF_SETUP);
+	psProfile->ucFeature = NRF24L01_RegisterRead_8(RF24_FEATURE);
+	psProfile->ucDynPD = NRF24L01_RegisterRead_8(RF24_DYNPD);
+
+	NRF24L01_RegisterRead_Multi(RF24_TX_ADDR, psProfile->pucTxAddress, 5);
+	NRF24L01_RegisterRead_Multi(RF24_RX_ADDR_P0, psProfile->pucRxAddressP0, 5);
+	NRF24L01_RegisterRead_Multi(RF24_RX_ADDR_P1, psProfile->pucRxAddressP1, 5);
+
+	for(i = 0; i < 4; i++)
+	{
+		psProfile->pucRxAddressP2[i] = NRF24L01_RegisterRead_8(RF24_RX_ADDR_P2 + i);
+	}
+
+	for(i = 0; i < 6; i++)
+	{
+		psProfile->pucRxPayloadWidth[i] = NRF24L01_RegisterRead_8(RF24_RX_PW_P0 + i);
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_ProfileEncode
+ *
+ * Arguments	: 	psProfile		:	Profile
+ * 					pucBlob [out]	:	Buffer for the blob
+ * 					uiSize			:	Size of pucBlob, at least PDLIB_NRF24_PROFILE_BLOB_SIZE
+ *
+ * Return		: 	Length of the blob (PDLIB_NRF24_PROFILE_BLOB_SIZE)
+ * 					PDLIB_NRF24_BUFFER_TOO_SMALL	:	pucBlob is too small
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ *
+ * Description	: 	Serializes the profile. The layout does not depend on the
+ * 					structure layout of the compiler.
+ *
+ */
+
+int
+NRF24L01_ProfileEncode(const NRF24L01_Profile *psProfile, unsigned char *pucBlob, unsigned int uiSize)
+{
+	unsigned char *pucBody;
+
+	if((NULL == psProfile) || (NULL == pucBlob))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	if(uiSize < PDLIB_NRF24_PROFILE_BLOB_SIZE)
+	{
+		return PDLIB_NRF24_BUFFER_TOO_SMALL;
+	}
+
+	pucBlob[0] = PROFILE_MAGIC0;
+	pucBlob[1] = PROFILE_MAGIC1;
+	pucBlob[2] = PDLIB_NRF24_PROFILE_VERSION;
+	pucBlob[3] = PDLIB_NRF24_PROFILE_BODY_SIZE;
+
+	pucBody = &pucBlob[PROFILE_HEADER];
+
+	pucBody[0] = psProfile->ucConfig;
+	pucBody[1] = psProfile->ucEnAA;
+	pucBody[2] = psProfile->ucEnRxAddr;
+	pucBody[3] = psProfile->ucSetupAW;
+	pucBody[4] = psProfile->ucSetupRetr;
+	pucBody[5] = psProfile->ucChannel;
+	pucBody[6] = psProfile->ucRFSetup;
+	pucBody[7] = psProfile->ucFeature;
+	pucBody[8] = psProfile->ucDynPD;
+	memcpy(&pucBody[9], psProfile->pucTxAddress, 5);
+	memcpy(&pucBody[14], psProfile->pucRxAddressP0, 5);
+	memcpy(&pucBody[19], psProfile->pucRxAddressP1, 5);
+	memcpy(&pucBody[24], psProfile->pucRxAddressP2, 4);
+	memcpy(&pucBody[28], psProfile->pucRxPayloadWidth, 6);
+
+	return NRF24L01_AppendCRC16((char*)pucBlob, PROFILE_HEADER + PDLIB_NRF24_PROFILE_BODY_SIZE, uiSize);
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_ProfileDecode
+ *
+ * Arguments	: 	psProfile [out]	:	Profile
+ * 					pucBlob			:	Blob
+ * 					uiLength		:	Length of pucBlob
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				:	Profile decoded
+ * 					PDLIB_NRF24_CRC_ERROR			:	Blob is corrupted
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	No profile or unknown version
+ *
+ * Description	: 	Checks and deserializes a blob, ie. read from the storage
+ * 					or received from a commissioning tool. psProfile is only
+ * 					changed on success.
+ *
+ */
+
+int
+NRF24L01_ProfileDecode(NRF24L01_Profile *psProfile, const unsigned char *pucBlob, unsigned int uiLength)
+{
+	const unsigned char *pucBody;
+
+	if((NULL == psProfile) || (NULL == pucBlob) || (uiLength < PROFILE_HEADER))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	if((PROFILE_MAGIC0 != pucBlob[0]) || (PROFILE_MAGIC1 != pucBlob[1]) ||
+	   (PDLIB_NRF24_PROFILE_VERSION != pucBlob[2]) || (PDLIB_NRF24_PROFILE_BODY_SIZE != pucBlob[3]) ||
+	   (uiLength < (PROFILE_HEADER + PDLIB_NRF24_PROFILE_BODY_SIZE + 2)))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	if(NRF24L01_CheckCRC16((const char*)pucBlob, PROFILE_HEADER + PDLIB_NRF24_PROFILE_BODY_SIZE + 2) < 0)
+	{
+		return PDLIB_NRF24_CRC_ERROR;
+	}
+
+	pucBody = &pucBlob[PROFILE_HEADER];
+
+	psProfile->ucConfig = pucBody[0];
+	psProfile->ucEnAA = pucBody[1];
+	psProfile->ucEnRxAddr = pucBody[2];
+	psProfile->ucSetupAW = pucBody[3];
+	psProfile->ucSetupRetr = pucBody[4];
+	psProfile->ucChannel = pucBody[5];
+	psProfile->ucRFSetup = pucBody[6];
+	psProfile->ucFeature = pucBody[7];
+	psProfile->ucDynPD = pucBody[8];
+	memcpy(psProfile->pucTxAddress, &pucBody[9], 5);
+	memcpy(psProfile->pucRxAddressP0, &pucBody[14], 5);
+	memcpy(psProfile->pucRxAddressP1, &pucBody[19], 5);
+	memcpy(psProfile->pucRxAddressP2, &pucBody[24], 4);
+	memcpy(psProfile->pucRxPayloadWidth, &pucBody[28], 6);
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_ListAdd
+ *
+ * Arguments	: 	pucList		:	Write list
+ * 					uiIndex		:	Current length of the list
+ * 					ucRegister	:	Register
+ * 					pucData		:	Value
+ * 					ucCount		:	Length of the value
+ *
+ * Return		: 	New length of the list
+ *
+ * Description	: 	Caller checked the space.
+ *
+ */
+
+static unsigned int
+_NRF24L01_ListAdd(unsigned char *pucList, unsigned int uiIndex, unsigned char ucRegister, const unsigned char *pucData, unsigned char ucCount)
+{
+	pucList[uiIndex++] = ucRegister;
+	pucList[uiIndex++] = ucCount;
+
+	memcpy(&pucList[uiIndex], pucData, ucCount);
+
+	return uiIndex + ucCount;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_ProfileMakeList
+ *
+ * Arguments	: 	psProfile		:	Profile
+ * 					pucList [out]	:	Buffer for the write list
+ * 					uiSize			:	Size of pucList, PDLIB_NRF24_PROFILE_LIST_SIZE is enough
+ *
+ * Return		: 	Length of the write list
+ * 					PDLIB_NRF24_BUFFER_TOO_SMALL	:	pucList is too small
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ *
+ * Description	: 	Builds the write list for NRF24L01_RegisterWriteList(), or
+ * 					for NRF24L01_WarmInit() to skip the registers which already
+ * 					match. CONFIG comes first so the module is powered down
+ * 					while the rest is written, FEATURE comes before DYNPD.
+ *
+ */
+
+int
+NRF24L01_ProfileMakeList(const NRF24L01_Profile *psProfile, unsigned char *pucList, unsigned int uiSize)
+{
+	unsigned char ucWidth;
+	unsigned int uiIndex = 0;
+	unsigned char i;
+
+	if((NULL == psProfile) || (NULL == pucList))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	if(uiSize < PDLIB_NRF24_PROFILE_LIST_SIZE)
+	{
+		return PDLIB_NRF24_BUFFER_TOO_SMALL;
+	}
+
+	ucWidth = (psProfile->ucSetupAW & 0x03) ? ((psProfile->ucSetupAW & 0x03) + 2) : 5;
+
+	uiIndex = _NRF24L01_ListAdd(pucList, uiIndex, RF24_CONFIG, &psProfile->ucConfig, 1);
+	uiIndex = _NRF24L01_ListAdd(pucList, uiIndex, RF24_EN_AA, &psProfile->ucEnAA, 1);
+	uiIndex = _NRF24L01_ListAdd(pucList, uiIndex, RF24_EN_RXADDR, &psProfile->ucEnRxAddr, 1);
+	uiIndex = _NRF24L01_ListAdd(pucList, uiIndex, RF24_SETUP_AW, &psProfile->ucSetupAW, 1);
+	uiIndex = _NRF24L01_ListAdd(pucList, uiIndex, RF24_SETUP_RETR, &psProfile->ucSetupRetr, 1);
+	uiIndex = _NRF24L01_ListAdd(pucList, uiIndex, RF24_RF_CH, &psProfile->ucChannel, 1);
+	uiIndex = _NRF24L01_ListAdd(pucList, uiIndex, RF24_RF_SETUP, &psProfile->ucRFSetup, 1);
+	uiIndex = _NRF24L01_ListAdd(pucList, uiIndex, RF24_RX_ADDR_P0, psProfile->pucRxAddressP0, ucWidth);
+	uiIndex = _NRF24L01_ListAdd(pucList, uiIndex, RF24_RX_ADDR_P1, psProfile->pucRxAddressP1, ucWidth);
+
+	for(i = 0; i < 4; i++)
+	{
+		uiIndex = _NRF24L01_ListAdd(pucList, uiIndex, RF24_RX_ADDR_P2 + i, &psProfile->pucRxAddressP2[i], 1);
+	}
+
+	uiIndex = _NRF24L01_ListAdd(pucList, uiIndex, RF24_TX_ADDR, psProfile->pucTxAddress, ucWidth);
+
+	for(i = 0; i < 6; i++)
+	{
+		uiIndex = _NRF24L01_ListAdd(pucList, uiIndex, RF24_RX_PW_P0 + i, &psProfile->pucRxPayloadWidth[i], 1);
+	}
+
+	uiIndex = _NRF24L01_ListAdd(pucList, uiIndex, RF24_FEATURE, &psProfile->ucFeature, 1);
+	uiIndex = _NRF24L01_ListAdd(pucList, uiIndex, RF24_DYNPD, &psProfile->ucDynPD, 1);
+
+	return (int)uiIndex;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_ProfileApply
+ *
+ * Arguments	: 	psProfile	:	Profile
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				:	Profile written to the module
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ *
+ * Description	: 	Writes the profile to the active module with one write list.
+ * 					The module is powered down afterwards.
+ *
+ */
+
+int
+NRF24L01_ProfileApply(const NRF24L01_Profile *psProfile)
+{
+	unsigned char pucList[PDLIB_NRF24_PROFILE_LIST_SIZE];
+	int iLength;
+
+	iLength = NRF24L01_ProfileMakeList(psProfile, pucList, sizeof(pucList));
+
+	if(iLength < 0)
+	{
+		return iLength;
+	}
+
+	NRF24L01_RegisterWriteList(pucList, iLength);
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_ProfileMakeDelta
+ *
+ * Arguments	: 	psFrom			:	Profile the module has, NULL for a full list
+ * 					psTo			:	Profile to switch to
+ * 					pucList [out]	:	Buffer for the write list
+ * 					uiSize			:	Size of pucList, PDLIB_NRF24_PROFILE_LIST_SIZE is enough
+ *
+ * Return		: 	Length of the write list, 0 if the profiles are the same
+ * 					PDLIB_NRF24_BUFFER_TOO_SMALL	:	pucList is too small
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ *
+ * Description	: 	Builds the write list of the registers which differ between
+ * 					the profiles, in the order of NRF24L01_ProfileMakeList().
+ * 					A multi byte register is written whole.
+ *
+ */
+
+int
+NRF24L01_ProfileMakeDelta(const NRF24L01_Profile *psFrom, const NRF24L01_Profile *psTo, unsigned char *pucList, unsigned int uiSize)
+{
+	unsigned char pucFromList[PDLIB_NRF24_PROFILE_LIST_SIZE];
+	unsigned char pucToList[PDLIB_NRF24_PROFILE_LIST_SIZE];
+	unsigned int uiFrom = 0;
+	unsigned int uiTo = 0;
+	unsigned int uiIndex = 0;
+	unsigned char ucCount;
+	int iFromLength;
+	int iToLength;
+
+	if(NULL == psFrom)
+	{
+		return NRF24L01_ProfileMakeList(psTo, pucList, uiSize);
+	}
+
+	if(NULL == pucList)
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	iFromLength = NRF24L01_ProfileMakeList(psFrom, pucFromList, sizeof(pucFromList));
+	iToLength = NRF24L01_ProfileMakeList(psTo, pucToList, sizeof(pucToList));
+
+	if((iFromLength < 0) || (iToLength < 0))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	/* PS: Both lists have the registers in the same order, only the address lengths can differ */
+	while((uiTo + 2) <= (unsigned int)iToLength)
+	{
+		ucCount = pucToList[uiTo + 1];
+
+		if(((uiFrom + 2) > (unsigned int)iFromLength) ||
+		   (pucFromList[uiFrom + 1] != ucCount) ||
+		   (0 != memcmp(&pucFromList[uiFrom + 2], &pucToList[uiTo + 2], ucCount)))
+		{
+			if((uiIndex + ucCount + 2) > uiSize)
+			{
+				return PDLIB_NRF24_BUFFER_TOO_SMALL;
+			}
+
+			memcpy(&pucList[uiIndex], &pucToList[uiTo], ucCount + 2);
+			uiIndex += ucCount + 2;
+		}
+
+		if((uiFrom + 2) <= (unsigned int)iFromLength)
+		{
+			uiFrom += pucFromList[uiFrom + 1] + 2;
+		}
+
+		uiTo += ucCount + 2;
+	}
+
+	return (int)uiIndex;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_ProfileSetInit
+ *
+ * Arguments	: 	psSet		:	Profile set
+ * 					psProfiles	:	Profiles, must stay valid
+ * 					ppcNames	:	Names of the profiles, may be NULL
+ * 					ucCount		:	Number of profiles, up to PDLIB_NRF24_PROFILE_SET_SIZE
+ * 					ucCurrent	:	Profile the module has now
+ * 					pucStore	:	Buffer for the delta lists
+ * 					uiSize		:	Size of pucStore
+ *
+ * Return		: 	Bytes of pucStore used
+ * 					PDLIB_NRF24_BUFFER_TOO_SMALL	:	pucStore is too small
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ *
+ * Description	: 	Precomputes the delta write list of every pair of profiles,
+ * 					ie. at start up, so a switch only streams the list.
+ *
+ */
+
+int
+NRF24L01_ProfileSetInit(NRF24L01_ProfileSet *psSet,
+						const NRF24L01_Profile *psProfiles,
+						const char * const *ppcNames,
+						unsigned char ucCount,
+						unsigned char ucCurrent,
+						unsigned char *pucStore,
+						unsigned int uiSize)
+{
+	unsigned char pucDelta[PDLIB_NRF24_PROFILE_LIST_SIZE];
+	unsigned int uiUsed = 0;
+	unsigned char ucFrom;
+	unsigned char ucTo;
+	int iLength;
+
+	if((NULL == psSet) || (NULL == psProfiles) || (NULL == pucStore) ||
+	   (0 == ucCount) || (ucCount > PDLIB_NRF24_PROFILE_SET_SIZE) || (ucCurrent >= ucCount))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	memset(psSet, 0, sizeof(NRF24L01_ProfileSet));
+
+	psSet->psProfiles = psProfiles;
+	psSet->ppcNames = ppcNames;
+	psSet->ucCount = ucCount;
+	psSet->ucCurrent = ucCurrent;
+	psSet->pucStore = pucStore;
+
+	for(ucFrom = 0; ucFrom < ucCount; ucFrom++)
+	{
+		for(ucTo = 0; ucTo < ucCount; ucTo++)
+		{
+			if(ucFrom == ucTo)
+			{
+				continue;
+			}
+
+			iLength = NRF24L01_ProfileMakeDelta(&psProfiles[ucFrom], &psProfiles[ucTo], pucDelta, sizeof(pucDelta));
+
+			if(iLength < 0)
+			{
+				return iLength;
+			}
+
+			if((uiUsed + iLength) > uiSize)
+			{
+				return PDLIB_NRF24_BUFFER_TOO_SMALL;
+			}
+
+			memcpy(&pucStore[uiUsed], pucDelta, iLength);
+
+			psSet->pusOffset[ucFrom][ucTo] = (unsigned short)uiUsed;
+			psSet->pucLength[ucFrom][ucTo] = (unsigned char)iLength;
+
+			uiUsed += iLength;
+		}
+	}
+
+	return (int)uiUsed;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_ProfileFind
+ *
+ * Arguments	: 	psSet		:	Profile set
+ * 					pcName		:	Name of the profile
+ *
+ * Return		: 	Index of the profile
+ * 					PDLIB_NRF24_ERROR				:	No profile with the name
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ *
+ */
+
+int
+NRF24L01_ProfileFind(const NRF24L01_ProfileSet *psSet, const char *pcName)
+{
+	unsigned char i;
+
+	if((NULL == psSet) || (NULL == psSet->ppcNames) || (NULL == pcName))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	for(i = 0; i < psSet->ucCount; i++)
+	{
+		if(psSet->ppcNames[i] && (0 == strcmp(psSet->ppcNames[i], pcName)))
+		{
+			return i;
+		}
+	}
+
+	return PDLIB_NRF24_ERROR;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_ProfileSwitch
+ *
+ * Arguments	: 	psSet		:	Profile set
+ * 					ucProfile	:	Index of the profile to switch to
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				:	Module has the profile
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ *
+ * Description	: 	Streams the precomputed delta list of the transition to the
+ * 					active module. Call it in Standby or Power Down mode. The
+ * 					power state is kept, so a powered module can enter RX/TX
+ * 					mode right after the switch.
+ *
+ * 					The time of the switch is measured with the clock source of
+ * 					the driver (NRF24L01_SetClockSource()), see
+ * 					NRF24L01_ProfileGetSwitchStats().
+ *
+ */
+
+int
+NRF24L01_ProfileSwitch(NRF24L01_ProfileSet *psSet, unsigned char ucProfile)
+{
+	NRF24L01_SwitchStats *psStats;
+	const unsigned char *pucList;
+	unsigned int uiLength;
+	unsigned long ulStart;
+	unsigned long ulTime;
+	unsigned char ucFrom;
+
+	if((NULL == psSet) || (ucProfile >= psSet->ucCount))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	ucFrom = psSet->ucCurrent;
+
+	if(ucFrom == ucProfile)
+	{
+		return PDLIB_NRF24_SUCCESS;
+	}
+
+	ulStart = NRF24L01_GetTimeUs();
+
+	pucList = &psSet->pucStore[psSet->pusOffset[ucFrom][ucProfile]];
+	uiLength = psSet->pucLength[ucFrom][ucProfile];
+
+	/* PS: CONFIG is the first entry when it changes. Profiles have PWR_UP clear */
+	if((uiLength >= 3) && (RF24_CONFIG == pucList[0]))
+	{
+		NRF24L01_RegisterWrite_8(RF24_CONFIG, pucList[2] | (NRF24L01_IsPoweredUp() ? RF24_PWR_UP : 0));
+
+		pucList += 3;
+		uiLength -= 3;
+	}
+
+	NRF24L01_RegisterWriteList(pucList, uiLength);
+
+	ulTime = NRF24L01_GetTimeUs() - ulStart;
+
+	psStats = &psSet->psStats[ucFrom][ucProfile];
+	psStats->ulCount++;
+	psStats->ulLastUs = ulTime;
+
+	if(ulTime > psStats->ulMaxUs)
+	{
+		psStats->ulMaxUs = ulTime;
+	}
+
+	psSet->ucCurrent = ucProfile;
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_ProfileGetSwitchStats
+ *
+ * Arguments	: 	psSet			:	Profile set
+ * 					ucFrom			:	Index of the profile switched from
+ * 					ucTo			:	Index of the profile switched to
+ * 					psStats [out]	:	Number of switches, last and longest time
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS or PDLIB_NRF24_INVALID_ARGUMENT
+ *
+ */
+
+int
+NRF24L01_ProfileGetSwitchStats(const NRF24L01_ProfileSet *psSet, unsigned char ucFrom, unsigned char ucTo, NRF24L01_SwitchStats *psStats)
+{
+	if((NULL == psSet) || (NULL == psStats) || (ucFrom >= psSet->ucCount) || (ucTo >= psSet->ucCount))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	*psStats = psSet->psStats[ucFrom][ucTo];
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_ProfileLoad
+ *
+ * Arguments	: 	psStorage		:	Storage backend
+ * 					psProfile [out]	:	Profile
+ *
+ * Return		: 	Same as NRF24L01_ProfileDecode(), or the error of the backend
+ *
+ * Description	: 	Reads and checks the stored profile. An erased storage
+ * 					returns PDLIB_NRF24_INVALID_ARGUMENT, then use the built in
+ * 					configuration.
+ *
+ */
+
+int
+NRF24L01_ProfileLoad(const NRF24L01_Storage *psStorage, NRF24L01_Profile *psProfile)
+{
+	unsigned char pucBlob[PDLIB_NRF24_PROFILE_BLOB_SIZE];
+	int ret;
+
+	if((NULL == psStorage) || (NULL == psStorage->pfnRead))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	ret = psStorage->pfnRead(psStorage->pvContext, psStorage->ulOffset, pucBlob, sizeof(pucBlob));
+
+	if(PDLIB_NRF24_SUCCESS == ret)
+	{
+		ret = NRF24L01_ProfileDecode(psProfile, pucBlob, sizeof(pucBlob));
+	}
+
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_ProfileSave
+ *
+ * Arguments	: 	psStorage	:	Storage backend
+ * 					psProfile	:	Profile
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS or the error of the backend
+ *
+ * Description	: 	Encodes and stores the profile.
+ *
+ */
+
+int
+NRF24L01_ProfileSave(const NRF24L01_Storage *psStorage, const NRF24L01_Profile *psProfile)
+{
+	unsigned char pucBlob[PDLIB_NRF24_PROFILE_BLOB_SIZE];
+	int ret;
+
+	if((NULL == psStorage) || (NULL == psStorage->pfnWrite))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	ret = NRF24L01_ProfileEncode(psProfile, pucBlob, sizeof(pucBlob));
+
+	if(ret < 0)
+	{
+		return ret;
+	}
+
+	return psStorage->pfnWrite(psStorage->pvContext, psStorage->ulOffset, pucBlob, sizeof(pucBlob));
+}
+
+
+#ifdef PART_LM4F120H5QR
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_EEPROMRead
+ *
+ * Arguments	: 	See NRF24L01_Storage
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS or PDLIB_NRF24_INVALID_ARGUMENT
+ *
+ * Description	: 	EEPROM access is in 32 bit words. The bytes are copied
+ * 					through a word, so pucData needs no alignment.
+ *
+ */
+
+static int
+_NRF24L01_EEPROMRead(void *pvContext, unsigned long ulOffset, unsigned char *pucData, unsigned int uiLength)
+{
+	unsigned long ulWord;
+	unsigned int i;
+
+	(void)pvContext;
+
+	if((ulOffset & 0x03) || (uiLength & 0x03))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	for(i = 0; i < uiLength; i += 4)
+	{
+		ROM_EEPROMRead(&ulWord, ulOffset + i, 4);
+		memcpy(&pucData[i], &ulWord, 4);
+	}
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+static int
+_NRF24L01_EEPROMWrite(void *pvContext, unsigned long ulOffset, const unsigned char *pucData, unsigned int uiLength)
+{
+	unsigned long ulWord;
+	unsigned int i;
+
+	(void)pvContext;
+
+	if((ulOffset & 0x03) || (uiLength & 0x03))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	for(i = 0; i < uiLength; i += 4)
+	{
+		memcpy(&ulWord, &pucData[i], 4);
+
+		if(0 != ROM_EEPROMProgram(&ulWord, ulOffset + i, 4))
+		{
+			return PDLIB_NRF24_ERROR;
+		}
+	}
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_EEPROMStorageInit
+ *
+ * Arguments	: 	psStorage [out]	:	Storage backend
+ * 					ulAddress		:	EEPROM byte address of the blob, multiple of 4
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				:	EEPROM ready
+ * 					PDLIB_NRF24_ERROR				:	EEPROM failed to initialize
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ *
+ * Description	: 	Enables the EEPROM and fills the backend. The blob uses
+ * 					PDLIB_NRF24_PROFILE_BLOB_SIZE bytes from ulAddress.
+ *
+ */
+
+int
+NRF24L01_EEPROMStorageInit(NRF24L01_Storage *psStorage, unsigned long ulAddress)
+{
+	if((NULL == psStorage) || (ulAddress & 0x03))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	ROM_SysCtlPeripheralEnable(SYSCTL_PERIPH_EEPROM0);
+
+	if(EEPROM_INIT_OK != ROM_EEPROMInit())
+	{
+		return PDLIB_NRF24_ERROR;
+	}
+
+	psStorage->pfnRead = _NRF24L01_EEPROMRead;
+	psStorage->pfnWrite = _NRF24L01_EEPROMWrite;
+	psStorage->pvContext = NULL;
+	psStorage->ulOffset = ulAddress;
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+#endif
@@ -0,0 +1,93 @@
+#ifndef _PDLIB_NRF24L01_PROFILE
+#define _PDLIB_NRF24L01_PROFILE
+
+#include "pdlib_nrf24l01.h"
+
+/* Configurations */
+
+#define PDLIB_NRF24_PROFILE_VERSION		1
+
+/* PS: Blob is {'n', 'P', version, body length, body, CRC16}, a whole number of words */
+#define PDLIB_NRF24_PROFILE_BODY_SIZE	34
+#define PDLIB_NRF24_PROFILE_BLOB_SIZE	40
+
+/* PS: Largest write list built from a profile */
+#define PDLIB_NRF24_PROFILE_LIST_SIZE	80
+
+/* PS: Profiles of one NRF24L01_ProfileSet */
+#ifndef PDLIB_NRF24_PROFILE_SET_SIZE
+#define PDLIB_NRF24_PROFILE_SET_SIZE	4
+#endif
+
+/* PS: Register values of one module configuration */
+typedef struct
+{
+	unsigned char ucConfig;
+	unsigned char ucEnAA;
+	unsigned char ucEnRxAddr;
+	unsigned char ucSetupAW;
+	unsigned char ucSetupRetr;
+	unsigned char ucChannel;
+	unsigned char ucRFSetup;
+	unsigned char ucFeature;
+	unsigned char ucDynPD;
+	unsigned char pucTxAddress[5];
+	unsigned char pucRxAddressP0[5];
+	unsigned char pucRxAddressP1[5];
+	unsigned char pucRxAddressP2[4];
+	unsigned char pucRxPayloadWidth[6];
+} NRF24L01_Profile;
+
+/* PS: Storage backend. Offsets and lengths are multiples of 4. Functions return PDLIB_NRF24_SUCCESS or an error */
+typedef struct
+{
+	int (*pfnRead)(void *pvContext, unsigned long ulOffset, unsigned char *pucData, unsigned int uiLength);
+	int (*pfnWrite)(void *pvContext, unsigned long ulOffset, const unsigned char *pucData, unsigned int uiLength);
+	void *pvContext;
+	unsigned long ulOffset;
+} NRF24L01_Storage;
+
+typedef struct
+{
+	unsigned long ulCount;
+	unsigned long ulLastUs;
+	unsigned long ulMaxUs;
+} NRF24L01_SwitchStats;
+
+/* PS: Named profiles with the precompiled delta write list of every transition */
+typedef struct
+{
+	const NRF24L01_Profile *psProfiles;
+	const char * const *ppcNames;
+	unsigned char ucCount;
+	unsigned char ucCurrent;
+
+	/* PS: Delta lists live in the caller's buffer */
+	unsigned char *pucStore;
+	unsigned short pusOffset[PDLIB_NRF24_PROFILE_SET_SIZE][PDLIB_NRF24_PROFILE_SET_SIZE];
+	unsigned char pucLength[PDLIB_NRF24_PROFILE_SET_SIZE][PDLIB_NRF24_PROFILE_SET_SIZE];
+
+	NRF24L01_SwitchStats psStats[PDLIB_NRF24_PROFILE_SET_SIZE][PDLIB_NRF24_PROFILE_SET_SIZE];
+} NRF24L01_ProfileSet;
+
+/* PS: Function prototypes */
+
+void NRF24L01_ProfileCapture(NRF24L01_Profile *psProfile);
+int NRF24L01_ProfileEncode(const NRF24L01_Profile *psProfile, unsigned char *pucBlob, unsigned int uiSize);
+int NRF24L01_ProfileDecode(NRF24L01_Profile *psProfile, const unsigned char *pucBlob, unsigned int uiLength);
+int NRF24L01_ProfileMakeList(const NRF24L01_Profile *psProfile, unsigned char *pucList, unsigned int uiSize);
+int NRF24L01_ProfileApply(const NRF24L01_Profile *psProfile);
+int NRF24L01_ProfileMakeDelta(const NRF24L01_Profile *psFrom, const NRF24L01_Profile *psTo, unsigned char *pucList, unsigned int uiSize);
+
+int NRF24L01_ProfileSetInit(NRF24L01_ProfileSet *psSet, const NRF24L01_Profile *psProfiles, const char * const *ppcNames, unsigned char ucCount, unsigned char ucCurrent, unsigned char *pucStore, unsigned int uiSize);
+int NRF24L01_ProfileFind(const NRF24L01_ProfileSet *psSet, const char *pcName);
+int NRF24L01_ProfileSwitch(NRF24L01_ProfileSet *psSet, unsigned char ucProfile);
+int NRF24L01_ProfileGetSwitchStats(const NRF24L01_ProfileSet *psSet, unsigned char ucFrom, unsigned char ucTo, NRF24L01_SwitchStats *psStats);
+
+int NRF24L01_ProfileLoad(const NRF24L01_Storage *psStorage, NRF24L01_Profile *psProfile);
+int NRF24L01_ProfileSave(const NRF24L01_Storage *psStorage, const NRF24L01_Profile *psProfile);
+
+/* PS: On chip EEPROM backend */
+int NRF24L01_EEPROMStorageInit(NRF24L01_Storage *psStorage, unsigned long ulAddress);
+
+#endif
@@ -0,0 +1,449 @@
+/*
+ * Please find the license in the GIT repo.
+ *
+ * Description:
+ *
+ * Request / response in one ESB transaction. The server (PRX) keeps the
+ * response of each request type preloaded as the ack payload of its own
+ * pipe, so the client (PTX) gets the response with the ack of its
+ * request, without switching to RX mode. A round trip is one packet and
+ * one ack.
+ *
+ * Request type t uses pipe t + 1 with the address LSB increased by t.
+ * The TX FIFO holds three ack payloads, so up to three types are
+ * supported. After each request the handler gives the response to preload
+ * for the next request of the type: responses are state that the server
+ * keeps up to date (ie. the latest sensor reading), and a response which
+ * depends on the request arrives with the next call.
+ *
+ * Usage:
+ *
+ * Server, with a clock source, before entering RX mode:
+ *
+ * 		NRF24L01_RPCServerInit(&sServer, address, 2, Handler, NULL);
+ * 		NRF24L01_RPCServerService(&sServer);		// from the main loop
+ * 		NRF24L01_RPCServerUpdate(&sServer, 0, reading, 4);	// new state
+ *
+ * Client, with a clock source:
+ *
+ * 		NRF24L01_RPCClientInit(&sClient, address);
+ * 		ret = NRF24L01_RPCCall(&sClient, 0, request, 1, response, &length, 2000);
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pdlib_nrf24l01_rpc.h"
+#include "pdlib_nrf24l01_async.h"
+
+/* PS: RX_P_NO of the status when the RX FIFO is empty */
+#define RPC_RX_EMPTY_PIPE		7
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_RPCAddress
+ *
+ * Arguments	: 	pucBase		:	Address of type 0
+ * 					ucType		:	Request type
+ * 					pucAddress	:	Buffer for the address of the type
+ *
+ * Return		: 	None
+ *
+ */
+
+static void
+_NRF24L01_RPCAddress(const unsigned char *pucBase, unsigned char ucType, unsigned char *pucAddress)
+{
+	memcpy(pucAddress, pucBase, NRF24L01_GetAddressWidth());
+	pucAddress[0] += ucType;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_RPCRxPipe
+ *
+ * Arguments	: 	None
+ *
+ * Return		: 	Pipe of the next payload in the RX FIFO, RPC_RX_EMPTY_PIPE if empty
+ *
+ */
+
+static unsigned char
+_NRF24L01_RPCRxPipe()
+{
+	return (NRF24L01_GetStatus() >> 1) & 0x07;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_RPCPreload
+ *
+ * Arguments	: 	psServer	:	Server
+ * 					ucType		:	Request type
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Writes the kept response of the type to the TX FIFO. An
+ * 					empty response is not preloaded, the ack has no payload.
+ *
+ */
+
+static void
+_NRF24L01_RPCPreload(NRF24L01_RPCServer *psServer, unsigned char ucType)
+{
+	if(psServer->pucResponseLength[ucType])
+	{
+		if(PDLIB_NRF24_SUCCESS != NRF24L01_SetAckPayload(psServer->pcResponse[ucType], ucType + 1, psServer->pucResponseLength[ucType]))
+		{
+			psServer->ulReloadFailures++;
+		}
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_RPCHandle
+ *
+ * Arguments	: 	psServer	:	Server
+ * 					ucType		:	Request type
+ * 					pcRequest	:	Request, NULL for the first response
+ * 					uiLength	:	Length of the request
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Gets the next response of the type from the handler and
+ * 					preloads it.
+ *
+ */
+
+static void
+_NRF24L01_RPCHandle(NRF24L01_RPCServer *psServer, unsigned char ucType, const char *pcRequest, unsigned int uiLength)
+{
+	int iLength = psServer->pfnHandler(psServer->pvContext, ucType, pcRequest, uiLength, psServer->pcResponse[ucType], 32);
+
+	psServer->pucResponseLength[ucType] = ((iLength > 0) && (iLength <= 32)) ? iLength : 0;
+
+	_NRF24L01_RPCPreload(psServer, ucType);
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_RPCServerInit
+ *
+ * Arguments	: 	psServer	:	Server
+ * 					pucAddress	:	Address of request type 0
+ * 					ucTypes		:	Number of request types (1 ~ PDLIB_NRF24_RPC_MAX_TYPES)
+ * 					pfnHandler	:	Gives the responses
+ * 					pvContext	:	Passed to pfnHandler
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				:	Success
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ *
+ * Description	: 	Sets up pipes 1 ~ ucTypes with dynamic and ack payloads,
+ * 					preloads the first response of each type and enters RX
+ * 					mode. Call it while the module is not in RX or TX mode.
+ *
+ */
+
+int
+NRF24L01_RPCServerInit(NRF24L01_RPCServer *psServer, unsigned char *pucAddress, unsigned char ucTypes, NRF24L01_RPCHandlerFn pfnHandler, void *pvContext)
+{
+	unsigned char pucTypeAddress[5];
+	unsigned char ucEnabled;
+	unsigned char i;
+
+	if((NULL == psServer) || (NULL == pucAddress) || (NULL == pfnHandler) ||
+		(0 == ucTypes) || (ucTypes > PDLIB_NRF24_RPC_MAX_TYPES))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	memset(psServer, 0, sizeof(NRF24L01_RPCServer));
+
+	psServer->pfnHandler = pfnHandler;
+	psServer->pvContext = pvContext;
+	psServer->ucTypes = ucTypes;
+
+	ucEnabled = NRF24L01_RegisterRead_8(RF24_EN_RXADDR);
+
+	for(i = 0; i < ucTypes; i++)
+	{
+		_NRF24L01_RPCAddress(pucAddress, i, pucTypeAddress);
+		NRF24L01_SetRxAddress(i + 1, pucTypeAddress);
+		NRF24L01_EnableFeatureDynPL(i + 1);
+
+		ucEnabled |= (1 << (i + 1));
+	}
+
+	NRF24L01_RegisterWrite_8(RF24_EN_RXADDR, ucEnabled);
+
+	NRF24L01_EnableFeatureAckPL();
+
+	NRF24L01_FlushTX();
+
+	for(i = 0; i < ucTypes; i++)
+	{
+		_NRF24L01_RPCHandle(psServer, i, NULL, 0);
+	}
+
+	NRF24L01_EnableRxMode();
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_RPCServerUpdate
+ *
+ * Arguments	: 	psServer	:	Server
+ * 					ucType		:	Request type
+ * 					pcResponse	:	New response
+ * 					uiLength	:	Length of the response (Maximum is 32)
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				:	Success
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ *
+ * Description	: 	Replaces the preloaded response of a type. A payload can't
+ * 					be taken out of the TX FIFO alone, so the FIFO is flushed
+ * 					and all the responses are preloaded again. A request
+ * 					arriving in between gets an ack without payload.
+ *
+ */
+
+int
+NRF24L01_RPCServerUpdate(NRF24L01_RPCServer *psServer, unsigned char ucType, const char *pcResponse, unsigned int uiLength)
+{
+	unsigned char i;
+
+	if((NULL == psServer) || (ucType >= psServer->ucTypes) || (uiLength > 32) || ((NULL == pcResponse) && uiLength))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	memcpy(psServer->pcResponse[ucType], pcResponse, uiLength);
+	psServer->pucResponseLength[ucType] = uiLength;
+
+	NRF24L01_FlushTX();
+
+	for(i = 0; i < psServer->ucTypes; i++)
+	{
+		_NRF24L01_RPCPreload(psServer, i);
+	}
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_RPCServerService
+ *
+ * Arguments	: 	psServer	:	Server
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Takes the requests from the RX FIFO. Each one was already
+ * 					answered by the ack; the handler gives the response for
+ * 					the next request of the type, which is preloaded at once.
+ *
+ */
+
+void
+NRF24L01_RPCServerService(NRF24L01_RPCServer *psServer)
+{
+	char pcRequest[32];
+	unsigned char ucLength;
+	unsigned char ucPipe;
+
+	NRF24L01_ClearInterruptFlag(PDLIB_INTERRUPT_DATA_READY);
+
+	while(RPC_RX_EMPTY_PIPE != (ucPipe = _NRF24L01_RPCRxPipe()))
+	{
+		ucLength = NRF24L01_GetRxDataAmount(ucPipe);
+
+		if((0 == ucLength) || (ucLength > sizeof(pcRequest)))
+		{
+			NRF24L01_FlushRX();
+			break;
+		}
+
+		NRF24L01_ReadRxPayload(pcRequest, ucLength);
+
+		if((ucPipe >= 1) && (ucPipe <= psServer->ucTypes))
+		{
+			psServer->ulRequests++;
+			_NRF24L01_RPCHandle(psServer, ucPipe - 1, pcRequest, ucLength);
+		}
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_RPCClientInit
+ *
+ * Arguments	: 	psClient	:	Client
+ * 					pucAddress	:	Address of request type 0 of the server
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				:	Success
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument or no clock source
+ *
+ * Description	: 	Enables ack payloads and powers the module up. The module
+ * 					is left in Standby I between calls, so a call does not
+ * 					wait for the power up (1.5 ms).
+ *
+ */
+
+int
+NRF24L01_RPCClientInit(NRF24L01_RPCClient *psClient, unsigned char *pucAddress)
+{
+	unsigned long ulStart;
+
+	if((NULL == psClient) || (NULL == pucAddress) || (NULL == NRF24L01_GetClockSource()))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	memset(psClient, 0, sizeof(NRF24L01_RPCClient));
+
+	memcpy(psClient->pucAddress, pucAddress, NRF24L01_GetAddressWidth());
+	psClient->ucType = 0xFF;
+	psClient->sStats.ulMinUs = 0xFFFFFFFFUL;
+
+	NRF24L01_EnableFeatureAckPL();
+
+	if(0 == NRF24L01_IsPoweredUp())
+	{
+		NRF24L01_PowerUp();
+
+		ulStart = NRF24L01_GetTimeUs();
+		while((NRF24L01_GetTimeUs() - ulStart) < PDLIB_NRF24_TPD2STBY_US);
+	}
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_RPCCall
+ *
+ * Arguments	: 	psClient	:	Client
+ * 					ucType		:	Request type
+ * 					pcRequest	:	Request
+ * 					uiLength	:	Length of the request (1 ~ 32)
+ * 					pcResponse	:	Buffer for the response
+ * 					length		:	Size of the buffer, returns the length of the response
+ * 					ulTimeoutUs	:	Timeout, longer than the retransmit time (ARD x ARC)
+ *
+ * Return		: 	Positive						:	Length of the response
+ * 					PDLIB_NRF24_ERROR				:	Request delivered, no response was preloaded
+ * 					PDLIB_NRF24_TX_ARC_REACHED		:	Request not acknowledged
+ * 					PDLIB_NRF24_TIMEOUT				:	TX not completed within the timeout
+ * 					PDLIB_NRF24_BUFFER_TOO_SMALL	:	Buffer is smaller than the response, response dropped
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ *
+ * Description	: 	Sends the request and returns the response carried by its
+ * 					ack. The addresses are only written when the type changes.
+ * 					The round trip is measured in sStats.
+ *
+ */
+
+int
+NRF24L01_RPCCall(NRF24L01_RPCClient *psClient, unsigned char ucType, char *pcRequest, unsigned int uiLength, char *pcResponse, char *length, unsigned long ulTimeoutUs)
+{
+	unsigned char pucAddress[5];
+	char pcDrop[32];
+	unsigned long ulStart;
+	unsigned long ulTime;
+	unsigned char ucAck;
+	int ret;
+
+	if((NULL == psClient) || (NULL == pcRequest) || (NULL == pcResponse) || (NULL == length) ||
+		(ucType >= PDLIB_NRF24_RPC_MAX_TYPES) || (0 == uiLength) || (uiLength > 32))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	if(ucType != psClient->ucType)
+	{
+		_NRF24L01_RPCAddress(psClient->pucAddress, ucType, pucAddress);
+		NRF24L01_SetTXAddress(pucAddress);
+		NRF24L01_SetRxAddress(PDLIB_NRF24_PIPE0, pucAddress);
+		psClient->ucType = ucType;
+	}
+
+	ulStart = NRF24L01_GetTimeUs();
+
+	ret = NRF24L01_SetTxPayload(pcRequest, uiLength);
+
+	if(PDLIB_NRF24_SUCCESS != ret)
+	{
+		return ret;
+	}
+
+	NRF24L01_EnableTxMode();
+
+	ret = NRF24L01_WaitForTxCompleteTimeout(ulTimeoutUs);
+
+	NRF24L01_DisableTxMode();
+
+	psClient->sStats.ulCalls++;
+
+	if(PDLIB_NRF24_SUCCESS != ret)
+	{
+		/* PS: MAX_RT leaves the request in the TX FIFO */
+		NRF24L01_FlushTX();
+		psClient->sStats.ulFailed++;
+		return ret;
+	}
+
+	if(PDLIB_NRF24_PIPE0 != _NRF24L01_RPCRxPipe())
+	{
+		psClient->sStats.ulEmpty++;
+		return PDLIB_NRF24_ERROR;
+	}
+
+	ucAck = NRF24L01_GetAckDataAmount();
+
+	if((0 == ucAck) || (ucAck > 32))
+	{
+		NRF24L01_FlushRX();
+		psClient->sStats.ulEmpty++;
+		ret = PDLIB_NRF24_ERROR;
+	}else if((unsigned char)(*length) < ucAck)
+	{
+		NRF24L01_ReadRxPayload(pcDrop, ucAck);
+		ret = PDLIB_NRF24_BUFFER_TOO_SMALL;
+	}else
+	{
+		NRF24L01_ReadRxPayload(pcResponse, ucAck);
+		(*length) = ucAck;
+		ret = ucAck;
+	}
+
+	NRF24L01_ClearInterruptFlag(PDLIB_INTERRUPT_DATA_READY);
+
+	ulTime = NRF24L01_GetTimeUs() - ulStart;
+
+	psClient->sStats.ulLastUs = ulTime;
+	psClient->sStats.ulTotalUs += ulTime;
+
+	if(ulTime < psClient->sStats.ulMinUs)
+	{
+		psClient->sStats.ulMinUs = ulTime;
+	}
+
+	if(ulTime > psClient->sStats.ulMaxUs)
+	{
+		psClient->sStats.ulMaxUs = ulTime;
+	}
+
+	return ret;
+}
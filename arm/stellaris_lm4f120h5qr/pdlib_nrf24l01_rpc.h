@@ -0,0 +1,58 @@
+#ifndef _PDLIB_NRF24L01_RPC
+#define _PDLIB_NRF24L01_RPC
+
+#include "pdlib_nrf24l01.h"
+
+/* Configurations */
+
+/* PS: One preloaded response per request type, the TX FIFO holds three */
+#define PDLIB_NRF24_RPC_MAX_TYPES		3
+
+/* PS: Gives the response to preload for the next request of the type. pcRequest is NULL for the first one */
+typedef int (*NRF24L01_RPCHandlerFn)(void *pvContext, unsigned char ucType, const char *pcRequest, unsigned int uiLength, char *pcResponse, unsigned int uiSize);
+
+typedef struct
+{
+	NRF24L01_RPCHandlerFn pfnHandler;
+	void *pvContext;
+	unsigned char ucTypes;
+
+	/* PS: Responses in the TX FIFO, kept to reload them after a flush */
+	char pcResponse[PDLIB_NRF24_RPC_MAX_TYPES][32];
+	unsigned char pucResponseLength[PDLIB_NRF24_RPC_MAX_TYPES];
+
+	unsigned long ulRequests;
+	unsigned long ulReloadFailures;
+} NRF24L01_RPCServer;
+
+typedef struct
+{
+	unsigned long ulCalls;
+	unsigned long ulFailed;
+	unsigned long ulEmpty;
+	unsigned long ulLastUs;
+	unsigned long ulMinUs;
+	unsigned long ulMaxUs;
+	unsigned long ulTotalUs;
+} NRF24L01_RPCStats;
+
+typedef struct
+{
+	unsigned char pucAddress[5];
+
+	/* PS: Type the TX and pipe 0 addresses are set for, 0xFF if none */
+	unsigned char ucType;
+
+	NRF24L01_RPCStats sStats;
+} NRF24L01_RPCClient;
+
+/* PS: Function prototypes */
+
+int NRF24L01_RPCServerInit(NRF24L01_RPCServer *psServer, unsigned char *pucAddress, unsigned char ucTypes, NRF24L01_RPCHandlerFn pfnHandler, void *pvContext);
+int NRF24L01_RPCServerUpdate(NRF24L01_RPCServer *psServer, unsigned char ucType, const char *pcResponse, unsigned int uiLength);
+void NRF24L01_RPCServerService(NRF24L01_RPCServer *psServer);
+
+int NRF24L01_RPCClientInit(NRF24L01_RPCClient *psClient, unsigned char *pucAddress);
+int NRF24L01_RPCCall(NRF24L01_RPCClient *psClient, unsigned char ucType, char *pcRequest, unsigned int uiLength, char *pcResponse, char *length, unsigned long ulTimeoutUs);
+
+#endif
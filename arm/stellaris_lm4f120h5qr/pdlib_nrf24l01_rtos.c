@@ -0,0 +1,630 @@
+/*
+ * Please find the license in the GIT repo.
+ *
+ * Description:
+ *
+ * Driver use from RTOS tasks, built when PDLIB_OS is defined. The OS
+ * calls go through pdlib_os.h, link one of the ports in common/os.
+ *
+ * The driver keeps the active module in globals, so every driver call
+ * made from a task must be inside NRF24L01_OSLock()/NRF24L01_OSUnlock().
+ * The lock is recursive and selects the module, a task can hold it
+ * across several driver calls.
+ *
+ * The blocking functions hold the lock only for the SPI transactions.
+ * While waiting the task sleeps on the radio's semaphore, which is given
+ * by NRF24L01_OSIRQHandler() from the IRQ pin interrupt. Without an IRQ
+ * pin the STATUS register is checked every PDLIB_NRF24_OS_POLL_US.
+ *
+ * Usage:
+ *
+ * [1]. Call NRF24L01_OSInit() before the scheduler starts
+ * [2]. Initialize the module inside the lock, and the IRQ pin with
+ * 		NRF24L01_InterruptInit() if it is connected
+ * [3]. Call NRF24L01_OSRadioInit() with the same IRQ pin
+ * [4]. Call NRF24L01_OSIRQHandler() from the GPIO interrupt handler
+ * [5]. Use NRF24L01_OSSend()/NRF24L01_OSReceive() from the tasks
+ *
+ */
+
+#ifdef PDLIB_OS
+
+#include <stdio.h>
+#include <string.h>
+#include "pdlib_nrf24l01_rtos.h"
+
+#ifdef PART_LM4F120H5QR
+#include "inc/hw_types.h"
+#include "driverlib/rom.h"
+#include "driverlib/gpio.h"
+#endif
+
+static pdlibOS_Mutex g_sDriverLock = NULL;
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_OSInit
+ *
+ * Arguments	: 	None
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS	:	Lock created
+ * 					PDLIB_NRF24_ERROR	:	Out of OS resources
+ *
+ * Description	: 	Creates the driver lock and sets the OS time as the clock
+ * 					source of the driver. Call once, before the tasks use the
+ * 					driver.
+ *
+ */
+
+int
+NRF24L01_OSInit()
+{
+	if(NULL == g_sDriverLock)
+	{
+		if(PDLIB_OS_SUCCESS != pdlibOS_MutexCreate(&g_sDriverLock))
+		{
+			g_sDriverLock = NULL;
+			return PDLIB_NRF24_ERROR;
+		}
+	}
+
+	NRF24L01_SetClockSource(pdlibOS_GetTimeUs);
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_OSLock
+ *
+ * Arguments	: 	psDevice	:	Module to select, NULL to keep the active one
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Takes the driver lock and selects the module. Calls can be
+ * 					nested in the same task. Must not be called from an ISR.
+ *
+ */
+
+void
+NRF24L01_OSLock(NRF24L01_Device *psDevice)
+{
+	if(g_sDriverLock)
+	{
+		pdlibOS_MutexLock(g_sDriverLock);
+	}
+
+	if(psDevice)
+	{
+		NRF24L01_SelectDevice(psDevice);
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_OSUnlock
+ *
+ * Arguments	: 	None
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Releases the driver lock taken by NRF24L01_OSLock().
+ *
+ */
+
+void
+NRF24L01_OSUnlock()
+{
+	if(g_sDriverLock)
+	{
+		pdlibOS_MutexUnlock(g_sDriverLock);
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_OSRadioInit
+ *
+ * Arguments	: 	psRadio		:	Radio to initialize
+ * 					psDevice	:	Initialized module
+ * 					ulIRQBase	:	GPIO base of the IRQ pin, 0 if not connected
+ * 					ulIRQPin	:	IRQ pin
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				:	Radio ready
+ * 					PDLIB_NRF24_ERROR				:	Out of OS resources
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ *
+ * Description	: 	Creates the radio's mutex and IRQ semaphore.
+ *
+ */
+
+int
+NRF24L01_OSRadioInit(NRF24L01_OSRadio *psRadio, NRF24L01_Device *psDevice, unsigned long ulIRQBase, unsigned long ulIRQPin)
+{
+	if((NULL == psRadio) || (NULL == psDevice))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	memset(psRadio, 0, sizeof(NRF24L01_OSRadio));
+
+	if((PDLIB_OS_SUCCESS != pdlibOS_MutexCreate(&psRadio->sOwner)) ||
+	   (PDLIB_OS_SUCCESS != pdlibOS_SemaphoreCreate(&psRadio->sIRQ)))
+	{
+		NRF24L01_OSRadioDeinit(psRadio);
+		return PDLIB_NRF24_ERROR;
+	}
+
+	psRadio->psDevice = psDevice;
+	psRadio->ulIRQBase = ulIRQBase;
+	psRadio->ulIRQPin = ulIRQPin;
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_OSRadioDeinit
+ *
+ * Arguments	: 	psRadio		:	Radio, no task may use it any more
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Deletes the radio's mutex and IRQ semaphore. The module is
+ * 					not accessed.
+ *
+ */
+
+void
+NRF24L01_OSRadioDeinit(NRF24L01_OSRadio *psRadio)
+{
+	if(psRadio)
+	{
+		pdlibOS_MutexDelete(psRadio->sOwner);
+		pdlibOS_SemaphoreDelete(psRadio->sIRQ);
+
+		psRadio->sOwner = NULL;
+		psRadio->sIRQ = NULL;
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_OSIRQHandler
+ *
+ * Arguments	: 	psRadio		:	Radio of the IRQ pin
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Call from the GPIO interrupt handler. The IRQ pin is a level
+ * 					interrupt and stays low until the task clears the STATUS bits,
+ * 					so the pin interrupt is disabled here and enabled again by the
+ * 					waiting task. No SPI access is made from the ISR.
+ *
+ */
+
+void
+NRF24L01_OSIRQHandler(NRF24L01_OSRadio *psRadio)
+{
+#ifdef PART_LM4F120H5QR
+	if(psRadio->ulIRQBase)
+	{
+		ROM_GPIOPinIntDisable(psRadio->ulIRQBase, psRadio->ulIRQPin);
+		ROM_GPIOPinIntClear(psRadio->ulIRQBase, psRadio->ulIRQPin);
+	}
+#endif
+
+	pdlibOS_SemaphoreGiveFromISR(psRadio->sIRQ);
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_OSSleep
+ *
+ * Arguments	: 	psRadio		:	Radio
+ * 					ulTimeoutUs	:	Timeout in microseconds, or PDLIB_NRF24_WAIT_FOREVER
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Sleeps on the radio's semaphore until the IRQ handler gives it
+ * 					or the timeout elapses. Call without the driver lock, after
+ * 					checking STATUS. The pin interrupt disabled by the IRQ handler
+ * 					is enabled again, an IRQ asserted since the check fires at
+ * 					once. Without an IRQ pin the sleep is limited to
+ * 					PDLIB_NRF24_OS_POLL_US.
+ *
+ */
+
+void
+NRF24L01_OSSleep(NRF24L01_OSRadio *psRadio, unsigned long ulTimeoutUs)
+{
+	if(0 == psRadio->ulIRQBase)
+	{
+		if(ulTimeoutUs > PDLIB_NRF24_OS_POLL_US)
+		{
+			ulTimeoutUs = PDLIB_NRF24_OS_POLL_US;
+		}
+	}
+#ifdef PART_LM4F120H5QR
+	else
+	{
+		ROM_GPIOPinIntEnable(psRadio->ulIRQBase, psRadio->ulIRQPin);
+	}
+#endif
+
+	pdlibOS_SemaphoreTake(psRadio->sIRQ, (PDLIB_NRF24_WAIT_FOREVER == ulTimeoutUs) ? PDLIB_OS_WAIT_FOREVER : ulTimeoutUs);
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_OSWait
+ *
+ * Arguments	: 	psRadio		:	Radio
+ * 					ucMask		:	STATUS interrupt bits to wait for
+ * 					ulStart		:	Start of the operation (pdlibOS_GetTimeUs())
+ * 					ulTimeoutUs	:	Timeout from ulStart, or PDLIB_NRF24_WAIT_FOREVER
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS or PDLIB_NRF24_TIMEOUT
+ *
+ * Description	: 	Sleeps until one of the bits is set. Called without the
+ * 					driver lock. The pin interrupt is enabled after the STATUS
+ * 					check, an IRQ asserted in between fires at once.
+ *
+ */
+
+static int
+_NRF24L01_OSWait(NRF24L01_OSRadio *psRadio, unsigned char ucMask, unsigned long ulStart, unsigned long ulTimeoutUs)
+{
+	unsigned char ucStatus;
+	unsigned long ulElapsed;
+	unsigned long ulWaitUs;
+
+	while(1)
+	{
+		NRF24L01_OSLock(psRadio->psDevice);
+		ucStatus = NRF24L01_GetStatus();
+		NRF24L01_OSUnlock();
+
+		if(ucStatus & ucMask)
+		{
+			return PDLIB_NRF24_SUCCESS;
+		}
+
+		ulWaitUs = PDLIB_NRF24_WAIT_FOREVER;
+
+		if(PDLIB_NRF24_WAIT_FOREVER != ulTimeoutUs)
+		{
+			ulElapsed = pdlibOS_GetTimeUs() - ulStart;
+
+			if(ulElapsed >= ulTimeoutUs)
+			{
+				return PDLIB_NRF24_TIMEOUT;
+			}
+
+			ulWaitUs = ulTimeoutUs - ulElapsed;
+		}
+
+		NRF24L01_OSSleep(psRadio, ulWaitUs);
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_OSRead
+ *
+ * Arguments	: 	pcData [out]		:	Buffer for the payload
+ * 					pcLength [in/out]	:	Size of pcData, set to the payload length
+ * 					pcPipeNo [out]		:	Pipe of the payload
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS			:	Payload read
+ * 					PDLIB_NRF24_WOULD_BLOCK		:	RX FIFO empty
+ * 					PDLIB_NRF24_BUFFER_TOO_SMALL:	Payload left in the RX FIFO
+ * 					PDLIB_NRF24_ERROR			:	Corrupted payload was flushed
+ *
+ * Description	: 	Reads the top most RX payload of the active module. Called
+ * 					with the driver lock held.
+ *
+ */
+
+static int
+_NRF24L01_OSRead(char *pcData, char *pcLength, char *pcPipeNo)
+{
+	unsigned char ucPipe;
+	unsigned char ucLength;
+
+	if(NRF24L01_RegisterRead_8(RF24_FIFO_STATUS) & RF24_RX_EMPTY)
+	{
+		return PDLIB_NRF24_WOULD_BLOCK;
+	}
+
+	ucPipe = (NRF24L01_GetStatus() >> 1) & 0x07;
+
+	if(ucPipe > PDLIB_NRF24_PIPE5)
+	{
+		return PDLIB_NRF24_WOULD_BLOCK;
+	}
+
+	ucLength = NRF24L01_GetRxDataAmount(ucPipe);
+
+	if(0 == ucLength)
+	{
+		return PDLIB_NRF24_ERROR;
+	}
+
+	if(ucLength > (unsigned char)(*pcLength))
+	{
+		return PDLIB_NRF24_BUFFER_TOO_SMALL;
+	}
+
+	NRF24L01_ReadRxPayload(pcData, ucLength);
+	NRF24L01_ClearInterruptFlag(PDLIB_INTERRUPT_DATA_READY);
+
+	*pcLength = ucLength;
+	*pcPipeNo = ucPipe;
+
+	return PDLIB_NRF24_SUCCESS;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_OSSend
+ *
+ * Arguments	: 	psRadio		:	Radio
+ * 					pcData		:	Payload
+ * 					uiLength	:	Payload length
+ * 					ulTimeoutUs	:	Timeout in microseconds, or PDLIB_NRF24_WAIT_FOREVER
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				:	Payload sent
+ * 					PDLIB_NRF24_TX_ARC_REACHED		:	Maximum retransmissions elapsed
+ * 					PDLIB_NRF24_TX_FIFO_FULL		:	TX FIFO full
+ * 					PDLIB_NRF24_TIMEOUT				:	Not sent within the timeout, TX FIFO flushed
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ *
+ * Description	: 	Blocking send, same as NRF24L01_SendDataTimeout(). The task
+ * 					sleeps while the module transmits, other tasks can use the
+ * 					driver in the meantime.
+ *
+ */
+
+int
+NRF24L01_OSSend(NRF24L01_OSRadio *psRadio, char *pcData, unsigned int uiLength, unsigned long ulTimeoutUs)
+{
+	unsigned long ulStart = pdlibOS_GetTimeUs();
+	int ret;
+
+	if((NULL == psRadio) || (NULL == pcData))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	pdlibOS_MutexLock(psRadio->sOwner);
+
+	NRF24L01_OSLock(psRadio->psDevice);
+
+	ret = NRF24L01_SubmitData(pcData, uiLength);
+
+	if(PDLIB_NRF24_SUCCESS == ret)
+	{
+		NRF24L01_EnableTxMode();
+		psRadio->ucRxActive = 0;
+	}
+
+	NRF24L01_OSUnlock();
+
+	if(PDLIB_NRF24_SUCCESS == ret)
+	{
+		ret = _NRF24L01_OSWait(psRadio, RF24_TX_DS | RF24_MAX_RT, ulStart, ulTimeoutUs);
+
+		NRF24L01_OSLock(psRadio->psDevice);
+
+		if((PDLIB_NRF24_SUCCESS == ret) && (NRF24L01_GetStatus() & RF24_MAX_RT))
+		{
+			ret = PDLIB_NRF24_TX_ARC_REACHED;
+		}
+
+		NRF24L01_DisableTxMode();
+
+		if(PDLIB_NRF24_TIMEOUT == ret)
+		{
+			NRF24L01_FlushTX();
+		}
+
+		/* PS: Release the IRQ line, so it does not wake the next wait */
+		NRF24L01_ClearInterruptFlag(PDLIB_INTERRUPT_MAX_RT | PDLIB_INTERRUPT_DATA_SENT);
+		NRF24L01_PowerDown();
+
+		NRF24L01_OSUnlock();
+	}
+
+	pdlibOS_MutexUnlock(psRadio->sOwner);
+
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_OSReceive
+ *
+ * Arguments	: 	psRadio				:	Radio
+ * 					pcData [out]		:	Buffer for the payload
+ * 					pcLength [in/out]	:	Size of pcData, set to the payload length
+ * 					pcPipeNo [out]		:	Pipe of the payload
+ * 					ulTimeoutUs			:	Timeout in microseconds, 0 to only read
+ * 											the RX FIFO or PDLIB_NRF24_WAIT_FOREVER
+ *
+ * Return		: 	PDLIB_NRF24_SUCCESS				:	Payload read
+ * 					PDLIB_NRF24_TIMEOUT				:	No payload within the timeout
+ * 					PDLIB_NRF24_WOULD_BLOCK			:	RX FIFO empty (ulTimeoutUs = 0)
+ * 					PDLIB_NRF24_BUFFER_TOO_SMALL	:	Payload is larger than pcData
+ * 					PDLIB_NRF24_ERROR				:	Corrupted payload was flushed
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ *
+ * Description	: 	Returns a payload already in the RX FIFO, otherwise puts the
+ * 					module to RX mode and sleeps until one arrives. The module is
+ * 					in Standby I mode when the function returns.
+ *
+ */
+
+int
+NRF24L01_OSReceive(NRF24L01_OSRadio *psRadio, char *pcData, char *pcLength, char *pcPipeNo, unsigned long ulTimeoutUs)
+{
+	unsigned long ulStart = pdlibOS_GetTimeUs();
+	int ret;
+
+	if((NULL == psRadio) || (NULL == pcData) || (NULL == pcLength) || (NULL == pcPipeNo))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	pdlibOS_MutexLock(psRadio->sOwner);
+
+	NRF24L01_OSLock(psRadio->psDevice);
+
+	ret = _NRF24L01_OSRead(pcData, pcLength, pcPipeNo);
+
+	if((PDLIB_NRF24_WOULD_BLOCK == ret) && (0 != ulTimeoutUs))
+	{
+		NRF24L01_EnableRxMode();
+		NRF24L01_OSUnlock();
+
+		ret = _NRF24L01_OSWait(psRadio, RF24_RX_DR, ulStart, ulTimeoutUs);
+
+		NRF24L01_OSLock(psRadio->psDevice);
+
+		NRF24L01_DisableRxMode();
+		psRadio->ucRxActive = 0;
+
+		if(PDLIB_NRF24_SUCCESS == ret)
+		{
+			ret = _NRF24L01_OSRead(pcData, pcLength, pcPipeNo);
+
+			/* PS: RX_DR without a payload, ie. read by another task */
+			if(PDLIB_NRF24_WOULD_BLOCK == ret)
+			{
+				NRF24L01_ClearInterruptFlag(PDLIB_INTERRUPT_DATA_READY);
+				ret = PDLIB_NRF24_TIMEOUT;
+			}
+		}
+	}
+
+	NRF24L01_OSUnlock();
+
+	pdlibOS_MutexUnlock(psRadio->sOwner);
+
+	return ret;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_OSRxPump
+ *
+ * Arguments	: 	psRadio		:	Radio
+ * 					sQueue		:	Queue of NRF24L01_Frame pointers
+ * 					ulTimeoutUs	:	Timeout in microseconds, or PDLIB_NRF24_WAIT_FOREVER
+ *
+ * Return		: 	Number of frames queued
+ * 					PDLIB_NRF24_TIMEOUT				:	No payload within the timeout
+ * 					PDLIB_NRF24_INVALID_ARGUMENT	:	Invalid input argument
+ *
+ * Description	: 	Body of a receive task. Keeps the module in RX mode, waits for
+ * 					payloads and moves the whole RX FIFO to pool frames, which are
+ * 					sent to the queue. The queue is created with an item size of
+ * 					sizeof(NRF24L01_Frame *) and the consumers release the frames.
+ *
+ * 					If the queue is full the frame is dropped and ulRxDropped
+ * 					is incremented. If the pool is empty the payloads stay in
+ * 					the RX FIFO and the next call takes them without waiting.
+ * 					RX_DR is cleared only once the RX FIFO is empty.
+ *
+ */
+
+int
+NRF24L01_OSRxPump(NRF24L01_OSRadio *psRadio, pdlibOS_Queue sQueue, unsigned long ulTimeoutUs)
+{
+	unsigned long ulStart = pdlibOS_GetTimeUs();
+	NRF24L01_Frame *psFrame;
+	unsigned char ucFifoStatus;
+	int ret;
+
+	if((NULL == psRadio) || (NULL == sQueue))
+	{
+		return PDLIB_NRF24_INVALID_ARGUMENT;
+	}
+
+	pdlibOS_MutexLock(psRadio->sOwner);
+
+	NRF24L01_OSLock(psRadio->psDevice);
+
+	/* PS: EnableRxMode() clears RX_DR, only call it when entering RX mode */
+	if(0 == psRadio->ucRxActive)
+	{
+		NRF24L01_EnableRxMode();
+		psRadio->ucRxActive = 1;
+	}
+
+	ucFifoStatus = NRF24L01_RegisterRead_8(RF24_FIFO_STATUS);
+
+	NRF24L01_OSUnlock();
+
+	if(ucFifoStatus & RF24_RX_EMPTY)
+	{
+		ret = _NRF24L01_OSWait(psRadio, RF24_RX_DR, ulStart, ulTimeoutUs);
+	}else
+	{
+		ret = PDLIB_NRF24_SUCCESS;
+	}
+
+	if(PDLIB_NRF24_SUCCESS == ret)
+	{
+		NRF24L01_OSLock(psRadio->psDevice);
+
+		while(1)
+		{
+			while(NULL != (psFrame = NRF24L01_FrameReceive()))
+			{
+				if(PDLIB_OS_SUCCESS == pdlibOS_QueueSend(sQueue, &psFrame, 0))
+				{
+					ret++;
+				}else
+				{
+					NRF24L01_FrameRelease(psFrame);
+					psRadio->ulRxDropped++;
+				}
+			}
+
+			/* PS: Payloads left (ie. pool empty) keep RX_DR set for the next call */
+			if(0 == (NRF24L01_RegisterRead_8(RF24_FIFO_STATUS) & RF24_RX_EMPTY))
+			{
+				break;
+			}
+
+			NRF24L01_ClearInterruptFlag(PDLIB_INTERRUPT_DATA_READY);
+
+			/* PS: A payload received before the clear would not be signalled again */
+			if(NRF24L01_RegisterRead_8(RF24_FIFO_STATUS) & RF24_RX_EMPTY)
+			{
+				break;
+			}
+		}
+
+		NRF24L01_OSUnlock();
+	}
+
+	pdlibOS_MutexUnlock(psRadio->sOwner);
+
+	return ret;
+}
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef _PDLIB_NRF24L01_RTOS
+#define _PDLIB_NRF24L01_RTOS
+
+#include "pdlib_nrf24l01.h"
+#include "pdlib_nrf24l01_pool.h"
+#include "pdlib_os.h"
+
+/* Configurations */
+
+/* PS: Status check period of a radio without an IRQ pin */
+#ifndef PDLIB_NRF24_OS_POLL_US
+#define PDLIB_NRF24_OS_POLL_US		1000
+#endif
+
+/* PS: One module used from tasks. Operations on the same radio are serialised by sOwner */
+typedef struct
+{
+	NRF24L01_Device *psDevice;
+	pdlibOS_Mutex sOwner;
+	pdlibOS_Semaphore sIRQ;
+
+	/* PS: IRQ pin, base 0 if not connected */
+	unsigned long ulIRQBase;
+	unsigned long ulIRQPin;
+
+	/* PS: Module left in RX mode by NRF24L01_OSRxPump() */
+	unsigned char ucRxActive;
+
+	unsigned long ulRxDropped;
+} NRF24L01_OSRadio;
+
+/* PS: Function prototypes */
+
+int NRF24L01_OSInit();
+void NRF24L01_OSLock(NRF24L01_Device *psDevice);
+void NRF24L01_OSUnlock();
+
+int NRF24L01_OSRadioInit(NRF24L01_OSRadio *psRadio, NRF24L01_Device *psDevice, unsigned long ulIRQBase, unsigned long ulIRQPin);
+void NRF24L01_OSRadioDeinit(NRF24L01_OSRadio *psRadio);
+void NRF24L01_OSIRQHandler(NRF24L01_OSRadio *psRadio);
+void NRF24L01_OSSleep(NRF24L01_OSRadio *psRadio, unsigned long ulTimeoutUs);
+
+int NRF24L01_OSSend(NRF24L01_OSRadio *psRadio, char *pcData, unsigned int uiLength, unsigned long ulTimeoutUs);
+int NRF24L01_OSReceive(NRF24L01_OSRadio *psRadio, char *pcData, char *pcLength, char *pcPipeNo, unsigned long ulTimeoutUs);
+int NRF24L01_OSRxPump(NRF24L01_OSRadio *psRadio, pdlibOS_Queue sQueue, unsigned long ulTimeoutUs);
+
+#endif
@@ -68,6 +68,18 @@ static const unsigned long g_GPIOConfigure[5][7] =
 	 {SYSCTL_PERIPH_GPIOD, GPIO_PD0_SSI1CLK, GPIO_PD1_SSI1FSS, GPIO_PD2_SSI1RX, GPIO_PD3_SSI1TX, GPIO_PORTD_BASE, GPIO_PIN_0 | GPIO_PIN_1 | GPIO_PIN_2 | GPIO_PIN_3}
 };
 
+/* PS: Default SPI bit rate */
+#define SSIBITRATE	500000
+
+/* PS: SPI bit rate of each SSI module */
+static unsigned long g_ulBitRate[5] = {SSIBITRATE, SSIBITRATE, SSIBITRATE, SSIBITRATE, SSIBITRATE};
+
+/* PS: Tracks which SSI modules are configured */
+static unsigned char g_ucConfigured[5];
+
+/* PS: Number of bytes transferred through each SSI module */
+static unsigned long g_ulByteCount[5];
+
 /* PS: RX data */
 char g_plRxData[256];
 
@@ -92,7 +104,7 @@ pdlibSPI_ConfigureSPIInterface(unsigned char ucSSI)
 	g_SSI = ucSSI;
 
 #ifdef PART_LM4F120H5QR
-	if(g_SSI < 6)
+	if(g_SSI < 5)
 	{
 		 /* Enable clock for SSI */
 		ROM_SysCtlPeripheralEnable(g_SSIModule[ucSSI][SSIPERIPH]);
@@ -114,11 +126,13 @@ pdlibSPI_ConfigureSPIInterface(unsigned char ucSSI)
 		/* Configure SSI */
 		ROM_SSIClockSourceSet(g_SSIModule[ucSSI][SSIBASE], SSI_CLOCK_SYSTEM);
 		ROM_SSIConfigSetExpClk(g_SSIModule[ucSSI][SSIBASE], SysCtlClockGet(), SSI_FRF_MOTO_MODE_0,
-								SSI_MODE_MASTER, 500000, 8);
+								SSI_MODE_MASTER, g_ulBitRate[ucSSI], 8);
 		ROM_SSIEnable(g_SSIModule[ucSSI][SSIBASE]);
 		
 		/* Clear initial data */
 		while(ROM_SSIDataGetNonBlocking(g_SSIModule[ucSSI][SSIBASE], (unsigned long*)&g_plRxData[0]));
+
+		g_ucConfigured[ucSSI] = 1;
 /*
 		HWREG(g_SSIModule[ucSSI][SSIBASE] + SSI_O_CPSR) = 8;
 
@@ -132,7 +146,28 @@ pdlibSPI_ConfigureSPIInterface(unsigned char ucSSI)
 
 
 /* PS:
- * 
+ *
+ * Function		: 	pdlibSPI_SelectInterface
+ *
+ * Arguments	: 	ucSSI - SSI module index which is already configured
+ *
+ * Return		: 	None
+ *
+ * Description	: 	The function will make the specified SSI module the one used
+ * 					by the transfer functions. The module is not re-configured,
+ * 					pdlibSPI_ConfigureSPIInterface() should be called once for it.
+ *
+ */
+
+void
+pdlibSPI_SelectInterface(unsigned char ucSSI)
+{
+	g_SSI = ucSSI;
+}
+
+
+/* PS:
+ *
  * Function		: 	pdlibSPI_SendData
  * 
  * Arguments	: 	pucData 		- Char array of data to be sent. 
@@ -201,12 +236,107 @@ pdlibSPI_TransferByte(unsigned char ucData)
 			/* Wait until current transmission is over */
 			while(ROM_SSIBusy(g_SSIModule[g_SSI][SSIBASE]));
 #endif
+			g_ulByteCount[g_SSI]++;
 	}
 
 	return ((unsigned char)(ulRxData & 0xFF));
 }
 
 
+/* PS:
+ *
+ * Function		: 	pdlibSPI_GetBitRate
+ *
+ * Arguments	: 	ucSSI	:	SSI module index
+ *
+ * Return		: 	SPI bit rate of the module in bits per second
+ *
+ * Description	: 	Gets the bit rate the SSI module is configured with.
+ *
+ */
+
+unsigned long
+pdlibSPI_GetBitRate(unsigned char ucSSI)
+{
+	return (ucSSI < 5) ? g_ulBitRate[ucSSI] : 0;
+}
+
+
+/* PS:
+ *
+ * Function		: 	pdlibSPI_SetBitRate
+ *
+ * Arguments	: 	ucSSI		:	SSI module index
+ * 					ulBitRate	:	SPI bit rate in bits per second. Maximum is half of the system clock.
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Changes the bit rate of the SSI module. If the module is already
+ * 					configured it is re-configured immediately, otherwise the bit rate is
+ * 					used by pdlibSPI_ConfigureSPIInterface().
+ *
+ */
+
+void
+pdlibSPI_SetBitRate(unsigned char ucSSI, unsigned long ulBitRate)
+{
+	if((ucSSI < 5) && (ulBitRate > 0))
+	{
+#ifdef PART_LM4F120H5QR
+		if(ulBitRate > (SysCtlClockGet() / 2))
+		{
+			ulBitRate = SysCtlClockGet() / 2;
+		}
+
+		g_ulBitRate[ucSSI] = ulBitRate;
+
+		if(g_ucConfigured[ucSSI])
+		{
+			/* Wait until current transmission is over */
+			while(ROM_SSIBusy(g_SSIModule[ucSSI][SSIBASE]));
+
+			ROM_SSIDisable(g_SSIModule[ucSSI][SSIBASE]);
+			ROM_SSIConfigSetExpClk(g_SSIModule[ucSSI][SSIBASE], SysCtlClockGet(), SSI_FRF_MOTO_MODE_0,
+									SSI_MODE_MASTER, ulBitRate, 8);
+			ROM_SSIEnable(g_SSIModule[ucSSI][SSIBASE]);
+		}
+#endif
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	pdlibSPI_GetByteCount
+ *
+ * Arguments	: 	ucSSI	:	SSI module index
+ * 					ucReset	:	1 to reset the count after reading
+ *
+ * Return		: 	Number of bytes transferred through the SSI module
+ *
+ * Description	: 	Can be used to calculate the bus utilisation.
+ *
+ */
+
+unsigned long
+pdlibSPI_GetByteCount(unsigned char ucSSI, unsigned char ucReset)
+{
+	unsigned long ulCount = 0;
+
+	if(ucSSI < 5)
+	{
+		ulCount = g_ulByteCount[ucSSI];
+
+		if(ucReset)
+		{
+			g_ulByteCount[ucSSI] = 0;
+		}
+	}
+
+	return ulCount;
+}
+
+
 /* PS:
  *
  * Function		: 	pdlibSPI_ReceiveDataBlocking
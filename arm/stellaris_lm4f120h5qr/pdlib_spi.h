@@ -4,9 +4,13 @@
 
 
 void pdlibSPI_ConfigureSPIInterface(unsigned char ucSSI);
+void pdlibSPI_SelectInterface(unsigned char ucSSI);
 unsigned char pdlibSPI_ReceiveDataBlocking();
 unsigned int pdlibSPI_ReceiveDataNonBlocking(char *pcData);
 unsigned char pdlibSPI_TransferByte(unsigned char ucData);
 int pdlibSPI_SendData(unsigned char *pucData, unsigned int uiLength);
+void pdlibSPI_SetBitRate(unsigned char ucSSI, unsigned long ulBitRate);
+unsigned long pdlibSPI_GetBitRate(unsigned char ucSSI);
+unsigned long pdlibSPI_GetByteCount(unsigned char ucSSI, unsigned char ucReset);
 
 #endif
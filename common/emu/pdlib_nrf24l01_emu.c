@@ -0,0 +1,1064 @@
+/*
+ * Please find the license in the GIT repo.
+ *
+ * Description:
+ *
+ * Register level emulator of NRF24L01+ modules for host builds, so the
+ * driver and the layers on top of it (gateway, link, RTOS) run without
+ * hardware. Define PDLIB_NRF24_EMU and PDLIB_SPI, and link this file
+ * instead of pdlib_spi.c.
+ *
+ * Each SSI index is one module with its registers, a 3 level TX FIFO
+ * and a 3 level RX FIFO. The SPI commands of the datasheet are decoded
+ * byte by byte between CSN low and CSN high. ACTIVATE is accepted and
+ * ignored, the features are always available as on the NRF24L01+.
+ *
+ * The air is ideal and instant: when CE or CSN changes, every module in
+ * PTX mode with CE high sends its TX FIFO to the modules in RX mode on
+ * the same channel and data rate with a matching pipe address. Auto
+ * acknowledgement, ACK payloads, retransmissions up to ARC, duplicate
+ * (PID) detection, NO_ACK and dynamic payloads are emulated. Packets and
+ * ACKs are lost with the probability set by NRF24L01_EmuSetLoss(). No
+ * time passes on the air, ARD is ignored.
+ *
+ * The IRQ pin is computed from STATUS and the CONFIG masks. A handler
+ * registered with NRF24L01_EmuSetIRQHandler() is called on the falling
+ * edge, for example to call NRF24L01_OSIRQHandler().
+ *
+ * The emulator has no lock of its own. Like the SPI bus it is only
+ * accessed by the driver, which is serialised by the driver lock in
+ * RTOS builds.
+ *
+ */
+
+#ifdef PDLIB_NRF24_EMU
+
+#include <stdio.h>
+#include <string.h>
+#include "nRF24L01.h"
+#include "pdlib_spi.h"
+#include "pdlib_nrf24l01_emu.h"
+
+/* PS: Default SPI bit rate, same as pdlib_spi.c */
+#define EMU_BITRATE			500000
+
+/* PS: Maximum SPI clock of the module */
+#define EMU_BITRATE_MAX		10000000
+
+#define EMU_FIFO_DEPTH		3
+#define EMU_PAYLOAD_MAX		32
+
+/* PS: Address slots, RX_ADDR_P0 to P5 and TX_ADDR */
+#define EMU_ADDR_TX			6
+
+/* PS: Pipe of a TX payload which is not an ACK payload */
+#define EMU_NO_PIPE			0xFF
+
+typedef struct
+{
+	unsigned char pucData[EMU_PAYLOAD_MAX];
+	unsigned char ucLength;
+	unsigned char ucPipe;
+	unsigned char ucNoAck;
+	unsigned char ucPID;
+} _NRF24L01_EmuPayload;
+
+typedef struct
+{
+	unsigned char ucPowered;
+	unsigned char pucReg[RF24_FEATURE + 1];
+	unsigned char pucAddr[EMU_ADDR_TX + 1][5];
+
+	_NRF24L01_EmuPayload psTx[EMU_FIFO_DEPTH];
+	unsigned char ucTxCount;
+	_NRF24L01_EmuPayload psRx[EMU_FIFO_DEPTH];
+	unsigned char ucRxCount;
+
+	/* PS: Pins */
+	unsigned char ucCE;
+	unsigned char ucCSN;
+	unsigned char ucIRQ;
+
+	/* PS: SPI transaction in progress */
+	unsigned char ucCommand;
+	unsigned char ucPosition;
+	_NRF24L01_EmuPayload sWrite;
+
+	/* PS: PID of the next TX payload */
+	unsigned char ucPID;
+
+	/* PS: Last packet of each pipe for the duplicate detection, sender is index + 1 */
+	unsigned char pucLastPID[6];
+	unsigned char pucLastSender[6];
+
+	NRF24L01_EmuIRQHandler pfnIRQ;
+	void *pvIRQArg;
+
+	unsigned long ulBitRate;
+	unsigned long ulByteCount;
+} _NRF24L01_EmuModule;
+
+static _NRF24L01_EmuModule g_psModules[PDLIB_NRF24_EMU_MODULES];
+
+/* PS: Selected module, same as g_SSI of pdlib_spi.c */
+static unsigned char g_ucSelected = PDLIB_NRF24_EMU_MODULES;
+
+/* PS: Loss probability in 1/1000 and the random state */
+static unsigned int g_uiLoss = 0;
+static unsigned long g_ulRandom = 1;
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_EmuPowerOn
+ *
+ * Arguments	: 	psModule	:	Module
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Sets the reset values of the registers and empties the FIFOs.
+ *
+ */
+
+static void
+_NRF24L01_EmuPowerOn(_NRF24L01_EmuModule *psModule)
+{
+	unsigned char i;
+
+	memset(psModule->pucReg, 0, sizeof(psModule->pucReg));
+
+	psModule->pucReg[RF24_CONFIG] = 0x08;
+	psModule->pucReg[RF24_EN_AA] = 0x3F;
+	psModule->pucReg[RF24_EN_RXADDR] = 0x03;
+	psModule->pucReg[RF24_SETUP_AW] = 0x03;
+	psModule->pucReg[RF24_SETUP_RETR] = 0x03;
+	psModule->pucReg[RF24_RF_CH] = 0x02;
+	psModule->pucReg[RF24_RF_SETUP] = 0x0F;
+
+	memset(psModule->pucAddr[0], 0xE7, 5);
+	memset(psModule->pucAddr[1], 0xC2, 5);
+	memset(psModule->pucAddr[EMU_ADDR_TX], 0xE7, 5);
+
+	for(i = 2; i < 6; i++)
+	{
+		psModule->pucAddr[i][0] = 0xC1 + i;
+	}
+
+	psModule->ucTxCount = 0;
+	psModule->ucRxCount = 0;
+	psModule->ucIRQ = 0;
+	psModule->ucPosition = 0;
+	memset(psModule->pucLastSender, 0, sizeof(psModule->pucLastSender));
+
+	psModule->ucPowered = 1;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_EmuGetModule
+ *
+ * Arguments	: 	ucSSI		:	SSI index
+ *
+ * Return		: 	Module, NULL for an invalid index
+ *
+ * Description	: 	Modules get their supply on first use.
+ *
+ */
+
+static _NRF24L01_EmuModule *
+_NRF24L01_EmuGetModule(unsigned char ucSSI)
+{
+	_NRF24L01_EmuModule *psModule;
+
+	if(ucSSI >= PDLIB_NRF24_EMU_MODULES)
+	{
+		return NULL;
+	}
+
+	psModule = &g_psModules[ucSSI];
+
+	if(0 == psModule->ucPowered)
+	{
+		psModule->ulBitRate = EMU_BITRATE;
+		_NRF24L01_EmuPowerOn(psModule);
+	}
+
+	return psModule;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_EmuLost
+ *
+ * Arguments	: 	None
+ *
+ * Return		: 	1 if the packet or ACK is lost, otherwise 0
+ *
+ * Description	: 	Draws the loss with a xorshift generator.
+ *
+ */
+
+static unsigned char
+_NRF24L01_EmuLost()
+{
+	unsigned long ulX;
+
+	if(0 == g_uiLoss)
+	{
+		return 0;
+	}
+
+	ulX = g_ulRandom & 0xFFFFFFFFUL;
+	ulX ^= (ulX << 13) & 0xFFFFFFFFUL;
+	ulX ^= ulX >> 17;
+	ulX ^= (ulX << 5) & 0xFFFFFFFFUL;
+	g_ulRandom = ulX;
+
+	return ((ulX % 1000) < g_uiLoss) ? 1 : 0;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_EmuStatus
+ *
+ * Arguments	: 	psModule	:	Module
+ *
+ * Return		: 	STATUS register
+ *
+ */
+
+static unsigned char
+_NRF24L01_EmuStatus(_NRF24L01_EmuModule *psModule)
+{
+	unsigned char ucStatus = psModule->pucReg[RF24_STATUS] & (RF24_RX_DR | RF24_TX_DS | RF24_MAX_RT);
+
+	ucStatus |= psModule->ucRxCount ? (psModule->psRx[0].ucPipe << 1) : 0x0E;
+
+	if(EMU_FIFO_DEPTH == psModule->ucTxCount)
+	{
+		ucStatus |= RF24_TX_FULL;
+	}
+
+	return ucStatus;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_EmuAddressWidth
+ *
+ * Arguments	: 	psModule	:	Module
+ *
+ * Return		: 	Address width in bytes
+ *
+ */
+
+static unsigned char
+_NRF24L01_EmuAddressWidth(_NRF24L01_EmuModule *psModule)
+{
+	unsigned char ucAW = psModule->pucReg[RF24_SETUP_AW] & 0x03;
+
+	return ucAW ? (ucAW + 2) : 5;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_EmuRegisterRead
+ *
+ * Arguments	: 	psModule	:	Module
+ * 					ucRegister	:	Register
+ * 					ucIndex		:	Byte of the register
+ *
+ * Return		: 	Register byte
+ *
+ */
+
+static unsigned char
+_NRF24L01_EmuRegisterRead(_NRF24L01_EmuModule *psModule, unsigned char ucRegister, unsigned char ucIndex)
+{
+	unsigned char ucData = 0;
+
+	switch(ucRegister)
+	{
+		case RF24_STATUS:
+			ucData = _NRF24L01_EmuStatus(psModule);
+			break;
+
+		case RF24_FIFO_STATUS:
+			ucData |= (0 == psModule->ucRxCount) ? RF24_RX_EMPTY : 0;
+			ucData |= (EMU_FIFO_DEPTH == psModule->ucRxCount) ? RF24_RX_FULL : 0;
+			ucData |= (0 == psModule->ucTxCount) ? RF24_TX_EMPTY : 0;
+			ucData |= (EMU_FIFO_DEPTH == psModule->ucTxCount) ? RF24_FIFO_FULL : 0;
+			break;
+
+		case RF24_RX_ADDR_P0:
+		case RF24_RX_ADDR_P1:
+			ucData = (ucIndex < 5) ? psModule->pucAddr[ucRegister - RF24_RX_ADDR_P0][ucIndex] : 0;
+			break;
+
+		case RF24_TX_ADDR:
+			ucData = (ucIndex < 5) ? psModule->pucAddr[EMU_ADDR_TX][ucIndex] : 0;
+			break;
+
+		case RF24_RX_ADDR_P2:
+		case RF24_RX_ADDR_P3:
+		case RF24_RX_ADDR_P4:
+		case RF24_RX_ADDR_P5:
+			ucData = (0 == ucIndex) ? psModule->pucAddr[ucRegister - RF24_RX_ADDR_P0][0] : 0;
+			break;
+
+		default:
+			if((0 == ucIndex) && (ucRegister <= RF24_FEATURE))
+			{
+				ucData = psModule->pucReg[ucRegister];
+			}
+			break;
+	}
+
+	return ucData;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_EmuRegisterWrite
+ *
+ * Arguments	: 	psModule	:	Module
+ * 					ucRegister	:	Register
+ * 					ucIndex		:	Byte of the register
+ * 					ucData		:	Value
+ *
+ * Return		: 	None
+ *
+ */
+
+static void
+_NRF24L01_EmuRegisterWrite(_NRF24L01_EmuModule *psModule, unsigned char ucRegister, unsigned char ucIndex, unsigned char ucData)
+{
+	switch(ucRegister)
+	{
+		case RF24_STATUS:
+			if(0 == ucIndex)
+			{
+				/* PS: Interrupt bits are cleared by writing 1 */
+				psModule->pucReg[RF24_STATUS] &= ~(ucData & (RF24_RX_DR | RF24_TX_DS | RF24_MAX_RT));
+			}
+			break;
+
+		case RF24_OBSERVE_TX:
+		case RF24_CD:
+		case RF24_FIFO_STATUS:
+			/* PS: Read only */
+			break;
+
+		case RF24_RX_ADDR_P0:
+		case RF24_RX_ADDR_P1:
+			if(ucIndex < 5)
+			{
+				psModule->pucAddr[ucRegister - RF24_RX_ADDR_P0][ucIndex] = ucData;
+			}
+			break;
+
+		case RF24_TX_ADDR:
+			if(ucIndex < 5)
+			{
+				psModule->pucAddr[EMU_ADDR_TX][ucIndex] = ucData;
+			}
+			break;
+
+		case RF24_RX_ADDR_P2:
+		case RF24_RX_ADDR_P3:
+		case RF24_RX_ADDR_P4:
+		case RF24_RX_ADDR_P5:
+			if(0 == ucIndex)
+			{
+				psModule->pucAddr[ucRegister - RF24_RX_ADDR_P0][0] = ucData;
+			}
+			break;
+
+		case RF24_RF_CH:
+			if(0 == ucIndex)
+			{
+				/* PS: Writing RF_CH resets PLOS_CNT */
+				psModule->pucReg[RF24_RF_CH] = ucData & 0x7F;
+				psModule->pucReg[RF24_OBSERVE_TX] &= 0x0F;
+			}
+			break;
+
+		default:
+			if((0 == ucIndex) && (ucRegister <= RF24_FEATURE))
+			{
+				psModule->pucReg[ucRegister] = ucData;
+			}
+			break;
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_EmuPipe
+ *
+ * Arguments	: 	psModule	:	Receiving module
+ * 					pucAddress	:	Address on the air
+ * 					ucWidth		:	Address width of the sender
+ *
+ * Return		: 	Enabled pipe with the address, 0xFF if none
+ *
+ */
+
+static unsigned char
+_NRF24L01_EmuPipe(_NRF24L01_EmuModule *psModule, const unsigned char *pucAddress, unsigned char ucWidth)
+{
+	unsigned char ucPipe;
+
+	if(_NRF24L01_EmuAddressWidth(psModule) != ucWidth)
+	{
+		return EMU_NO_PIPE;
+	}
+
+	for(ucPipe = 0; ucPipe < 6; ucPipe++)
+	{
+		if(0 == (psModule->pucReg[RF24_EN_RXADDR] & (1 << ucPipe)))
+		{
+			continue;
+		}
+
+		if(ucPipe < 2)
+		{
+			if(0 == memcmp(psModule->pucAddr[ucPipe], pucAddress, ucWidth))
+			{
+				return ucPipe;
+			}
+		}else
+		{
+			/* PS: Pipes 2 to 5 share the upper bytes of pipe 1 */
+			if((psModule->pucAddr[ucPipe][0] == pucAddress[0]) &&
+			   (0 == memcmp(&psModule->pucAddr[1][1], &pucAddress[1], ucWidth - 1)))
+			{
+				return ucPipe;
+			}
+		}
+	}
+
+	return EMU_NO_PIPE;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_EmuDeliver
+ *
+ * Arguments	: 	psSender	:	Module in PTX mode
+ * 					ucSender	:	Index of the sender
+ * 					psReceiver	:	Module in RX mode
+ * 					ucAck		:	Sender waits for an ACK
+ *
+ * Return		: 	1 if the sender got an ACK, otherwise 0
+ *
+ * Description	: 	One attempt to send the top most TX payload of the sender
+ * 					to one receiver.
+ *
+ */
+
+static unsigned char
+_NRF24L01_EmuDeliver(_NRF24L01_EmuModule *psSender, unsigned char ucSender, _NRF24L01_EmuModule *psReceiver, unsigned char ucAck)
+{
+	_NRF24L01_EmuPayload *psPayload = &psSender->psTx[0];
+	_NRF24L01_EmuPayload *psSlot;
+	unsigned char ucWidth = _NRF24L01_EmuAddressWidth(psSender);
+	unsigned char ucPipe;
+	unsigned char ucLength;
+	unsigned char i;
+
+	if((psSender->pucReg[RF24_RF_CH] != psReceiver->pucReg[RF24_RF_CH]) ||
+	   ((psSender->pucReg[RF24_RF_SETUP] & (RF24_RF_DR_LOW | RF24_RF_DR_HIGH)) != (psReceiver->pucReg[RF24_RF_SETUP] & (RF24_RF_DR_LOW | RF24_RF_DR_HIGH))))
+	{
+		return 0;
+	}
+
+	ucPipe = _NRF24L01_EmuPipe(psReceiver, psSender->pucAddr[EMU_ADDR_TX], ucWidth);
+
+	if((EMU_NO_PIPE == ucPipe) || _NRF24L01_EmuLost())
+	{
+		return 0;
+	}
+
+	if((psReceiver->pucReg[RF24_FEATURE] & RF24_EN_DPL) && (psReceiver->pucReg[RF24_DYNPD] & (1 << ucPipe)))
+	{
+		ucLength = psPayload->ucLength;
+	}else
+	{
+		ucLength = psReceiver->pucReg[RF24_RX_PW_P0 + ucPipe] & 0x3F;
+
+		if((0 == ucLength) || (ucLength > EMU_PAYLOAD_MAX))
+		{
+			return 0;
+		}
+	}
+
+	/* PS: A retransmission of the last packet is acknowledged but not stored again */
+	if((psReceiver->pucLastSender[ucPipe] != (ucSender + 1)) || (psReceiver->pucLastPID[ucPipe] != psPayload->ucPID))
+	{
+		if(EMU_FIFO_DEPTH == psReceiver->ucRxCount)
+		{
+			/* PS: RX FIFO full, the packet is dropped without an ACK */
+			return 0;
+		}
+
+		psSlot = &psReceiver->psRx[psReceiver->ucRxCount++];
+		memset(psSlot->pucData, 0, EMU_PAYLOAD_MAX);
+		memcpy(psSlot->pucData, psPayload->pucData, (ucLength < psPayload->ucLength) ? ucLength : psPayload->ucLength);
+		psSlot->ucLength = ucLength;
+		psSlot->ucPipe = ucPipe;
+
+		psReceiver->pucLastSender[ucPipe] = ucSender + 1;
+		psReceiver->pucLastPID[ucPipe] = psPayload->ucPID;
+		psReceiver->pucReg[RF24_STATUS] |= RF24_RX_DR;
+	}
+
+	if((0 == ucAck) || (0 == (psReceiver->pucReg[RF24_EN_AA] & (1 << ucPipe))))
+	{
+		return 0;
+	}
+
+	/* PS: The sender receives the ACK on pipe 0 */
+	if((0 != memcmp(psSender->pucAddr[0], psSender->pucAddr[EMU_ADDR_TX], ucWidth)) || _NRF24L01_EmuLost())
+	{
+		return 0;
+	}
+
+	if(psReceiver->pucReg[RF24_FEATURE] & RF24_EN_ACK_PAY)
+	{
+		for(i = 0; i < psReceiver->ucTxCount; i++)
+		{
+			if(psReceiver->psTx[i].ucPipe == ucPipe)
+			{
+				break;
+			}
+		}
+
+		if((i < psReceiver->ucTxCount) && (psSender->ucRxCount < EMU_FIFO_DEPTH))
+		{
+			psSlot = &psSender->psRx[psSender->ucRxCount++];
+			*psSlot = psReceiver->psTx[i];
+			psSlot->ucPipe = 0;
+			psSender->pucReg[RF24_STATUS] |= RF24_RX_DR;
+
+			psReceiver->ucTxCount--;
+			memmove(&psReceiver->psTx[i], &psReceiver->psTx[i + 1], (psReceiver->ucTxCount - i) * sizeof(_NRF24L01_EmuPayload));
+			psReceiver->pucReg[RF24_STATUS] |= RF24_TX_DS;
+		}
+	}
+
+	return 1;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_EmuTransmit
+ *
+ * Arguments	: 	ucSender	:	Index of a module in PTX mode with a TX payload
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Sends the top most TX payload with the retransmissions.
+ * 					Sets TX_DS and removes the payload, or sets MAX_RT and
+ * 					keeps it.
+ *
+ */
+
+static void
+_NRF24L01_EmuTransmit(unsigned char ucSender)
+{
+	_NRF24L01_EmuModule *psSender = &g_psModules[ucSender];
+	_NRF24L01_EmuModule *psReceiver;
+	unsigned char ucRetries = psSender->pucReg[RF24_SETUP_RETR] & 0x0F;
+	unsigned char ucAck;
+	unsigned char ucAcked = 0;
+	unsigned char ucAttempt;
+	unsigned char ucLost;
+	unsigned char i;
+
+	ucAck = (psSender->pucReg[RF24_EN_AA] & RF24_ENAA_P0) &&
+			!(psSender->psTx[0].ucNoAck && (psSender->pucReg[RF24_FEATURE] & RF24_EN_DYN_ACK));
+
+	for(ucAttempt = 0; ucAttempt <= (ucAck ? ucRetries : 0); ucAttempt++)
+	{
+		for(i = 0; i < PDLIB_NRF24_EMU_MODULES; i++)
+		{
+			psReceiver = &g_psModules[i];
+
+			if((i != ucSender) &&
+			   psReceiver->ucPowered && psReceiver->ucCE &&
+			   ((psReceiver->pucReg[RF24_CONFIG] & (RF24_PWR_UP | RF24_PRIM_RX)) == (RF24_PWR_UP | RF24_PRIM_RX)))
+			{
+				ucAcked |= _NRF24L01_EmuDeliver(psSender, ucSender, psReceiver, ucAck);
+			}
+		}
+
+		if((0 == ucAck) || ucAcked)
+		{
+			break;
+		}
+	}
+
+	if((0 == ucAck) || ucAcked)
+	{
+		psSender->ucTxCount--;
+		memmove(&psSender->psTx[0], &psSender->psTx[1], psSender->ucTxCount * sizeof(_NRF24L01_EmuPayload));
+
+		psSender->pucReg[RF24_OBSERVE_TX] = (psSender->pucReg[RF24_OBSERVE_TX] & 0xF0) | ucAttempt;
+		psSender->pucReg[RF24_STATUS] |= RF24_TX_DS;
+	}else
+	{
+		ucLost = psSender->pucReg[RF24_OBSERVE_TX] >> 4;
+
+		if(ucLost < 15)
+		{
+			ucLost++;
+		}
+
+		psSender->pucReg[RF24_OBSERVE_TX] = (ucLost << 4) | ucRetries;
+		psSender->pucReg[RF24_STATUS] |= RF24_MAX_RT;
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_EmuUpdate
+ *
+ * Arguments	: 	None
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Runs the air until no module can send and updates the IRQ
+ * 					pins. A module in PTX mode stops at MAX_RT until it is
+ * 					cleared.
+ *
+ */
+
+static void
+_NRF24L01_EmuUpdate()
+{
+	_NRF24L01_EmuModule *psModule;
+	unsigned char ucSent;
+	unsigned char ucIRQ;
+	unsigned char i;
+
+	do
+	{
+		ucSent = 0;
+
+		for(i = 0; i < PDLIB_NRF24_EMU_MODULES; i++)
+		{
+			psModule = &g_psModules[i];
+
+			if(psModule->ucPowered && psModule->ucCE && psModule->ucTxCount &&
+			   ((psModule->pucReg[RF24_CONFIG] & (RF24_PWR_UP | RF24_PRIM_RX)) == RF24_PWR_UP) &&
+			   (0 == (psModule->pucReg[RF24_STATUS] & RF24_MAX_RT)))
+			{
+				_NRF24L01_EmuTransmit(i);
+				ucSent = 1;
+			}
+		}
+	}while(ucSent);
+
+	for(i = 0; i < PDLIB_NRF24_EMU_MODULES; i++)
+	{
+		psModule = &g_psModules[i];
+		ucIRQ = (psModule->pucReg[RF24_STATUS] & ~(psModule->pucReg[RF24_CONFIG]) & (RF24_RX_DR | RF24_TX_DS | RF24_MAX_RT)) ? 1 : 0;
+
+		if(ucIRQ && (0 == psModule->ucIRQ) && psModule->pfnIRQ)
+		{
+			psModule->pfnIRQ(psModule->pvIRQArg);
+		}
+
+		psModule->ucIRQ = ucIRQ;
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	_NRF24L01_EmuEndCommand
+ *
+ * Arguments	: 	psModule	:	Module
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Completes the command at CSN high.
+ *
+ */
+
+static void
+_NRF24L01_EmuEndCommand(_NRF24L01_EmuModule *psModule)
+{
+	unsigned char ucCommand = psModule->ucCommand;
+
+	if(psModule->ucPosition < 2)
+	{
+		return;
+	}
+
+	if(RF24_R_RX_PAYLOAD == ucCommand)
+	{
+		if(psModule->ucRxCount)
+		{
+			psModule->ucRxCount--;
+			memmove(&psModule->psRx[0], &psModule->psRx[1], psModule->ucRxCount * sizeof(_NRF24L01_EmuPayload));
+		}
+	}else if((RF24_W_TX_PAYLOAD == ucCommand) || (RF24_W_TX_PAYLOAD_NOACK == ucCommand) ||
+			 (RF24_W_ACK_PAYLOAD == (ucCommand & 0xF8)))
+	{
+		if(psModule->ucTxCount < EMU_FIFO_DEPTH)
+		{
+			psModule->sWrite.ucNoAck = (RF24_W_TX_PAYLOAD_NOACK == ucCommand) ? 1 : 0;
+			psModule->sWrite.ucPipe = (RF24_W_ACK_PAYLOAD == (ucCommand & 0xF8)) ? (ucCommand & 0x07) : EMU_NO_PIPE;
+			psModule->sWrite.ucPID = psModule->ucPID;
+			psModule->ucPID = (psModule->ucPID + 1) & 0x03;
+
+			psModule->psTx[psModule->ucTxCount++] = psModule->sWrite;
+		}
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_EmuReset
+ *
+ * Arguments	: 	None
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Power cycles all the modules. IRQ handlers are kept.
+ *
+ */
+
+void
+NRF24L01_EmuReset()
+{
+	unsigned char i;
+
+	for(i = 0; i < PDLIB_NRF24_EMU_MODULES; i++)
+	{
+		if(g_psModules[i].ucPowered)
+		{
+			_NRF24L01_EmuPowerOn(&g_psModules[i]);
+		}
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_EmuSetLoss
+ *
+ * Arguments	: 	uiPermille	:	Probability to lose a packet or an ACK, in 1/1000
+ * 					ulSeed		:	Seed of the loss pattern, not 0
+ *
+ * Return		: 	None
+ *
+ * Description	: 	Each attempt of a packet and each ACK is lost independently.
+ * 					The same seed gives the same loss pattern.
+ *
+ */
+
+void
+NRF24L01_EmuSetLoss(unsigned int uiPermille, unsigned long ulSeed)
+{
+	g_uiLoss = (uiPermille > 1000) ? 1000 : uiPermille;
+	g_ulRandom = ulSeed ? ulSeed : 1;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_EmuSetIRQHandler
+ *
+ * Arguments	: 	ucSSI		:	Module
+ * 					pfnHandler	:	Handler, NULL to remove
+ * 					pvArg		:	Argument of the handler
+ *
+ * Return		: 	None
+ *
+ * Description	: 	The handler is called when the IRQ pin of the module goes
+ * 					low, from the driver call which caused it.
+ *
+ */
+
+void
+NRF24L01_EmuSetIRQHandler(unsigned char ucSSI, NRF24L01_EmuIRQHandler pfnHandler, void *pvArg)
+{
+	_NRF24L01_EmuModule *psModule = _NRF24L01_EmuGetModule(ucSSI);
+
+	if(psModule)
+	{
+		psModule->pfnIRQ = pfnHandler;
+		psModule->pvIRQArg = pvArg;
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_EmuIRQAsserted
+ *
+ * Arguments	: 	ucSSI		:	Module
+ *
+ * Return		: 	1 if the IRQ pin is low, otherwise 0
+ *
+ */
+
+unsigned char
+NRF24L01_EmuIRQAsserted(unsigned char ucSSI)
+{
+	return (ucSSI < PDLIB_NRF24_EMU_MODULES) ? g_psModules[ucSSI].ucIRQ : 0;
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_EmuSetCE
+ *
+ * Arguments	: 	ucLevel		:	0 for low, otherwise high
+ *
+ * Return		: 	None
+ *
+ * Description	: 	CE pin of the selected module.
+ *
+ */
+
+void
+NRF24L01_EmuSetCE(unsigned char ucLevel)
+{
+	_NRF24L01_EmuModule *psModule = _NRF24L01_EmuGetModule(g_ucSelected);
+
+	if(psModule)
+	{
+		psModule->ucCE = ucLevel ? 1 : 0;
+		_NRF24L01_EmuUpdate();
+	}
+}
+
+
+/* PS:
+ *
+ * Function		: 	NRF24L01_EmuSetCSN
+ *
+ * Arguments	: 	ucLevel		:	0 for low, otherwise high
+ *
+ * Return		: 	None
+ *
+ * Description	: 	CSN pin of the selected module. Low starts a command, high
+ * 					completes it.
+ *
+ */
+
+void
+NRF24L01_EmuSetCSN(unsigned char ucLevel)
+{
+	_NRF24L01_EmuModule *psModule = _NRF24L01_EmuGetModule(g_ucSelected);
+
+	if(NULL == psModule)
+	{
+		return;
+	}
+
+	if(ucLevel)
+	{
+		if(0 == psModule->ucCSN)
+		{
+			_NRF24L01_EmuEndCommand(psModule);
+		}
+
+		psModule->ucCSN = 1;
+		_NRF24L01_EmuUpdate();
+	}else
+	{
+		psModule->ucCSN = 0;
+		psModule->ucPosition = 0;
+	}
+}
+
+
+/* PS:
+ *
+ * pdlib_spi.h functions
+ *
+ */
+
+void
+pdlibSPI_ConfigureSPIInterface(unsigned char ucSSI)
+{
+	/* PS: Registers are kept, the module has its own supply */
+	if(_NRF24L01_EmuGetModule(ucSSI))
+	{
+		g_ucSelected = ucSSI;
+		g_psModules[ucSSI].ucCSN = 1;
+	}
+}
+
+void
+pdlibSPI_SelectInterface(unsigned char ucSSI)
+{
+	if(ucSSI < PDLIB_NRF24_EMU_MODULES)
+	{
+		g_ucSelected = ucSSI;
+	}
+}
+
+unsigned char
+pdlibSPI_ReceiveDataBlocking()
+{
+	return pdlibSPI_TransferByte(RF24_NOP);
+}
+
+unsigned int
+pdlibSPI_ReceiveDataNonBlocking(char *pcData)
+{
+	(void)pcData;
+
+	return 0;
+}
+
+unsigned char
+pdlibSPI_TransferByte(unsigned char ucData)
+{
+	_NRF24L01_EmuModule *psModule = _NRF24L01_EmuGetModule(g_ucSelected);
+	unsigned char ucCommand;
+	unsigned char ucIndex;
+	unsigned char ucOut = 0;
+
+	if(NULL == psModule)
+	{
+		return 0;
+	}
+
+	psModule->ulByteCount++;
+
+	if(psModule->ucCSN)
+	{
+		/* PS: Module not selected, MISO floats */
+		return 0xFF;
+	}
+
+	if(0 == psModule->ucPosition)
+	{
+		ucOut = _NRF24L01_EmuStatus(psModule);
+
+		psModule->ucCommand = ucData;
+		psModule->ucPosition = 1;
+		psModule->sWrite.ucLength = 0;
+
+		if(RF24_FLUSH_TX == ucData)
+		{
+			psModule->ucTxCount = 0;
+		}else if(RF24_FLUSH_RX == ucData)
+		{
+			psModule->ucRxCount = 0;
+		}
+
+		return ucOut;
+	}
+
+	ucCommand = psModule->ucCommand;
+	ucIndex = psModule->ucPosition - 1;
+
+	if(RF24_R_RX_PAYLOAD == ucCommand)
+	{
+		if(psModule->ucRxCount && (ucIndex < EMU_PAYLOAD_MAX))
+		{
+			ucOut = psModule->psRx[0].pucData[ucIndex];
+		}
+	}else if(RF24_R_RX_PL_WID == ucCommand)
+	{
+		ucOut = psModule->ucRxCount ? psModule->psRx[0].ucLength : 0;
+	}else if((RF24_W_TX_PAYLOAD == ucCommand) || (RF24_W_TX_PAYLOAD_NOACK == ucCommand) ||
+			 (RF24_W_ACK_PAYLOAD == (ucCommand & 0xF8)))
+	{
+		if(ucIndex < EMU_PAYLOAD_MAX)
+		{
+			psModule->sWrite.pucData[ucIndex] = ucData;
+			psModule->sWrite.ucLength = ucIndex + 1;
+		}
+	}else if(RF24_R_REGISTER == (ucCommand & 0xE0))
+	{
+		ucOut = _NRF24L01_EmuRegisterRead(psModule, ucCommand & RF24_REGISTER_MASK, ucIndex);
+	}else if(RF24_W_REGISTER == (ucCommand & 0xE0))
+	{
+		_NRF24L01_EmuRegisterWrite(psModule, ucCommand & RF24_REGISTER_MASK, ucIndex, ucData);
+	}
+
+	if(psModule->ucPosition < 0xFF)
+	{
+		psModule->ucPosition++;
+	}
+
+	return ucOut;
+}
+
+int
+pdlibSPI_SendData(unsigned char *pucData, unsigned int uiLength)
+{
+	unsigned int i;
+
+	if((NULL == pucData) || (g_ucSelected >= PDLIB_NRF24_EMU_MODULES))
+	{
+		return 0;
+	}
+
+	for(i = 0; i < uiLength; i++)
+	{
+		pdlibSPI_TransferByte(pucData[i]);
+	}
+
+	return (int)uiLength;
+}
+
+void
+pdlibSPI_SetBitRate(unsigned char ucSSI, unsigned long ulBitRate)
+{
+	_NRF24L01_EmuModule *psModule = _NRF24L01_EmuGetModule(ucSSI);
+
+	if(psModule && (ulBitRate > 0))
+	{
+		psModule->ulBitRate = (ulBitRate > EMU_BITRATE_MAX) ? EMU_BITRATE_MAX : ulBitRate;
+	}
+}
+
+unsigned long
+pdlibSPI_GetBitRate(unsigned char ucSSI)
+{
+	_NRF24L01_EmuModule *psModule = _NRF24L01_EmuGetModule(ucSSI);
+
+	return psModule ? psModule->ulBitRate : 0;
+}
+
+unsigned long
+pdlibSPI_GetByteCount(unsigned char ucSSI, unsigned char ucReset)
+{
+	_NRF24L01_EmuModule *psModule = _NRF24L01_EmuGetModule(ucSSI);
+	unsigned long ulCount = 0;
+
+	if(psModule)
+	{
+		ulCount = psModule->ulByteCount;
+
+		if(ucReset)
+		{
+			psModule->ulByteCount = 0;
+		}
+	}
+
+	return ulCount;
+}
+
+#endif
@@ -0,0 +1,32 @@
+#ifndef _PDLIB_NRF24L01_EMU
+#define _PDLIB_NRF24L01_EMU
+
+/*
+ * Host emulator of NRF24L01+ modules, built with PDLIB_NRF24_EMU. It is
+ * linked instead of pdlib_spi.c and provides the pdlibSPI_* functions,
+ * one emulated module per SSI index. The driver drives CE and CSN of
+ * the selected module through NRF24L01_EmuSetCE()/NRF24L01_EmuSetCSN().
+ *
+ * All the modules share one ideal air, see pdlib_nrf24l01_emu.c.
+ */
+
+/* Configurations */
+
+/* PS: Number of emulated modules, SSI index 0 to PDLIB_NRF24_EMU_MODULES - 1 */
+#ifndef PDLIB_NRF24_EMU_MODULES
+#define PDLIB_NRF24_EMU_MODULES		5
+#endif
+
+/* PS: Called when the IRQ pin of a module goes low. Must not call the driver */
+typedef void (*NRF24L01_EmuIRQHandler)(void *pvArg);
+
+/* PS: Function prototypes */
+
+void NRF24L01_EmuReset();
+void NRF24L01_EmuSetLoss(unsigned int uiPermille, unsigned long ulSeed);
+void NRF24L01_EmuSetIRQHandler(unsigned char ucSSI, NRF24L01_EmuIRQHandler pfnHandler, void *pvArg);
+unsigned char NRF24L01_EmuIRQAsserted(unsigned char ucSSI);
+void NRF24L01_EmuSetCE(unsigned char ucLevel);
+void NRF24L01_EmuSetCSN(unsigned char ucLevel);
+
+#endif
@@ -0,0 +1,230 @@
+/*
+ * Please find the license in the GIT repo.
+ *
+ * Description:
+ *
+ * FreeRTOS port of pdlib_os.h. Timeouts are rounded up to whole ticks.
+ *
+ * The driver busy waits on pdlibOS_GetTimeUs() (ie. the 130 us settle
+ * time), so the time source must be finer than the tick. On the
+ * LM4F120H5QR the position inside the tick is read from the SysTick
+ * counter which drives the FreeRTOS tick. Other targets only have the
+ * tick resolution and a short wait can end up to one tick early.
+ *
+ * Define PDLIB_OS_FREERTOS. Needs configUSE_RECURSIVE_MUTEXES. The SysTick
+ * reload must not change, so configUSE_TICKLESS_IDLE is not supported.
+ *
+ */
+
+#ifdef PDLIB_OS_FREERTOS
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "queue.h"
+#include "pdlib_os.h"
+
+#ifdef PART_LM4F120H5QR
+/* PS: SysTick reload and current value, interrupt control and state */
+#define OS_SYSTICK_LOAD		(*(volatile unsigned long *)0xE000E014)
+#define OS_SYSTICK_VAL		(*(volatile unsigned long *)0xE000E018)
+#define OS_NVIC_ICSR		(*(volatile unsigned long *)0xE000ED04)
+#define OS_ICSR_PENDSTSET	0x04000000UL
+#endif
+
+
+/* PS:
+ *
+ * Function		: 	_pdlibOS_Ticks
+ *
+ * Arguments	: 	ulTimeoutUs	:	Timeout in microseconds
+ *
+ * Return		: 	Timeout in ticks, rounded up
+ *
+ */
+
+static TickType_t
+_pdlibOS_Ticks(unsigned long ulTimeoutUs)
+{
+	unsigned long long ullTicks;
+
+	if(PDLIB_OS_WAIT_FOREVER == ulTimeoutUs)
+	{
+		return portMAX_DELAY;
+	}
+
+	ullTicks = ((unsigned long long)ulTimeoutUs * configTICK_RATE_HZ + 999999ULL) / 1000000ULL;
+
+	return (ullTicks >= portMAX_DELAY) ? (portMAX_DELAY - 1) : (TickType_t)ullTicks;
+}
+
+
+int
+pdlibOS_MutexCreate(pdlibOS_Mutex *psMutex)
+{
+	*psMutex = xSemaphoreCreateRecursiveMutex();
+
+	return (NULL != *psMutex) ? PDLIB_OS_SUCCESS : PDLIB_OS_ERROR;
+}
+
+void
+pdlibOS_MutexDelete(pdlibOS_Mutex sMutex)
+{
+	if(sMutex)
+	{
+		vSemaphoreDelete((SemaphoreHandle_t)sMutex);
+	}
+}
+
+void
+pdlibOS_MutexLock(pdlibOS_Mutex sMutex)
+{
+	xSemaphoreTakeRecursive((SemaphoreHandle_t)sMutex, portMAX_DELAY);
+}
+
+void
+pdlibOS_MutexUnlock(pdlibOS_Mutex sMutex)
+{
+	xSemaphoreGiveRecursive((SemaphoreHandle_t)sMutex);
+}
+
+
+int
+pdlibOS_SemaphoreCreate(pdlibOS_Semaphore *psSemaphore)
+{
+	*psSemaphore = xSemaphoreCreateBinary();
+
+	return (NULL != *psSemaphore) ? PDLIB_OS_SUCCESS : PDLIB_OS_ERROR;
+}
+
+void
+pdlibOS_SemaphoreDelete(pdlibOS_Semaphore sSemaphore)
+{
+	if(sSemaphore)
+	{
+		vSemaphoreDelete((SemaphoreHandle_t)sSemaphore);
+	}
+}
+
+int
+pdlibOS_SemaphoreTake(pdlibOS_Semaphore sSemaphore, unsigned long ulTimeoutUs)
+{
+	if(pdTRUE == xSemaphoreTake((SemaphoreHandle_t)sSemaphore, _pdlibOS_Ticks(ulTimeoutUs)))
+	{
+		return PDLIB_OS_SUCCESS;
+	}
+
+	return PDLIB_OS_TIMEOUT;
+}
+
+void
+pdlibOS_SemaphoreGive(pdlibOS_Semaphore sSemaphore)
+{
+	xSemaphoreGive((SemaphoreHandle_t)sSemaphore);
+}
+
+void
+pdlibOS_SemaphoreGiveFromISR(pdlibOS_Semaphore sSemaphore)
+{
+	BaseType_t xWoken = pdFALSE;
+
+	xSemaphoreGiveFromISR((SemaphoreHandle_t)sSemaphore, &xWoken);
+
+	portYIELD_FROM_ISR(xWoken);
+}
+
+
+int
+pdlibOS_QueueCreate(pdlibOS_Queue *psQueue, unsigned int uiItemSize, unsigned int uiDepth)
+{
+	*psQueue = xQueueCreate(uiDepth, uiItemSize);
+
+	return (NULL != *psQueue) ? PDLIB_OS_SUCCESS : PDLIB_OS_ERROR;
+}
+
+void
+pdlibOS_QueueDelete(pdlibOS_Queue sQueue)
+{
+	if(sQueue)
+	{
+		vQueueDelete((QueueHandle_t)sQueue);
+	}
+}
+
+int
+pdlibOS_QueueSend(pdlibOS_Queue sQueue, const void *pvItem, unsigned long ulTimeoutUs)
+{
+	if(pdTRUE == xQueueSend((QueueHandle_t)sQueue, pvItem, _pdlibOS_Ticks(ulTimeoutUs)))
+	{
+		return PDLIB_OS_SUCCESS;
+	}
+
+	return PDLIB_OS_TIMEOUT;
+}
+
+int
+pdlibOS_QueueReceive(pdlibOS_Queue sQueue, void *pvItem, unsigned long ulTimeoutUs)
+{
+	if(pdTRUE == xQueueReceive((QueueHandle_t)sQueue, pvItem, _pdlibOS_Ticks(ulTimeoutUs)))
+	{
+		return PDLIB_OS_SUCCESS;
+	}
+
+	return PDLIB_OS_TIMEOUT;
+}
+
+
+/* PS:
+ *
+ * Function		: 	pdlibOS_GetTimeUs
+ *
+ * Arguments	: 	None
+ *
+ * Return		: 	Time in microseconds
+ *
+ * Description	: 	Tick count plus the part of the current tick elapsed on the
+ * 					SysTick counter. A SysTick wrap whose interrupt is still
+ * 					pending is counted as a tick, and the tick count is read
+ * 					again in case the tick interrupt ran in between.
+ *
+ */
+
+unsigned long
+pdlibOS_GetTimeUs()
+{
+	TickType_t xTicks;
+	unsigned long long ullUs;
+#ifdef PART_LM4F120H5QR
+	unsigned long ulLoad = OS_SYSTICK_LOAD & 0x00FFFFFFUL;
+	unsigned long ulCount;
+	unsigned char ucWrapped;
+
+	do
+	{
+		xTicks = xTaskGetTickCount();
+		ulCount = OS_SYSTICK_VAL & 0x00FFFFFFUL;
+		ucWrapped = (OS_NVIC_ICSR & OS_ICSR_PENDSTSET) ? 1 : 0;
+
+		if(ucWrapped)
+		{
+			/* PS: Counter may have wrapped after the first read */
+			ulCount = OS_SYSTICK_VAL & 0x00FFFFFFUL;
+		}
+	}while(xTicks != xTaskGetTickCount());
+
+	if(ucWrapped)
+	{
+		xTicks++;
+	}
+
+	ullUs = (unsigned long long)xTicks * 1000000ULL / configTICK_RATE_HZ;
+	ullUs += ((unsigned long long)(ulLoad - ulCount) * 1000000ULL) / ((unsigned long long)(ulLoad + 1) * configTICK_RATE_HZ);
+#else
+	xTicks = xTaskGetTickCount();
+	ullUs = (unsigned long long)xTicks * 1000000ULL / configTICK_RATE_HZ;
+#endif
+
+	return (unsigned long)ullUs;
+}
+
+#endif
@@ -0,0 +1,368 @@
+/*
+ * Please find the license in the GIT repo.
+ *
+ * Description:
+ *
+ * POSIX threads port of pdlib_os.h, for running the upper layers on a
+ * Linux host. The "ISR" give is the same as a normal give, the caller
+ * is expected to be a thread.
+ *
+ * Define PDLIB_OS_POSIX and link with -lpthread.
+ *
+ */
+
+#ifdef PDLIB_OS_POSIX
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include "pdlib_os.h"
+
+typedef struct
+{
+	pthread_mutex_t sLock;
+	pthread_cond_t sCond;
+	int iCount;
+} pdlibOS_PosixSemaphore;
+
+typedef struct
+{
+	pthread_mutex_t sLock;
+	pthread_cond_t sNotEmpty;
+	pthread_cond_t sNotFull;
+	unsigned int uiItemSize;
+	unsigned int uiDepth;
+	unsigned int uiHead;
+	unsigned int uiCount;
+	unsigned char pucItems[];
+} pdlibOS_PosixQueue;
+
+
+/* PS:
+ *
+ * Function		: 	_pdlibOS_InitCond
+ *
+ * Arguments	: 	psCond		:	Condition variable
+ *
+ * Return		: 	0 on success
+ *
+ * Description	: 	Condition variables use the monotonic clock, so timeouts
+ * 					are not affected by changes of the wall clock.
+ *
+ */
+
+static int
+_pdlibOS_InitCond(pthread_cond_t *psCond)
+{
+	pthread_condattr_t sAttr;
+	int iRet;
+
+	pthread_condattr_init(&sAttr);
+	pthread_condattr_setclock(&sAttr, CLOCK_MONOTONIC);
+	iRet = pthread_cond_init(psCond, &sAttr);
+	pthread_condattr_destroy(&sAttr);
+
+	return iRet;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_pdlibOS_Wait
+ *
+ * Arguments	: 	psCond		:	Condition variable
+ * 					psLock		:	Locked mutex
+ * 					psDeadline	:	Absolute deadline, NULL to wait forever
+ *
+ * Return		: 	PDLIB_OS_SUCCESS or PDLIB_OS_TIMEOUT
+ *
+ */
+
+static int
+_pdlibOS_Wait(pthread_cond_t *psCond, pthread_mutex_t *psLock, const struct timespec *psDeadline)
+{
+	if(NULL == psDeadline)
+	{
+		pthread_cond_wait(psCond, psLock);
+		return PDLIB_OS_SUCCESS;
+	}
+
+	return (ETIMEDOUT == pthread_cond_timedwait(psCond, psLock, psDeadline)) ? PDLIB_OS_TIMEOUT : PDLIB_OS_SUCCESS;
+}
+
+
+/* PS:
+ *
+ * Function		: 	_pdlibOS_Deadline
+ *
+ * Arguments	: 	ulTimeoutUs	:	Timeout
+ * 					psDeadline	:	[out] Absolute deadline
+ *
+ * Return		: 	psDeadline, or NULL for PDLIB_OS_WAIT_FOREVER
+ *
+ */
+
+static struct timespec *
+_pdlibOS_Deadline(unsigned long ulTimeoutUs, struct timespec *psDeadline)
+{
+	if(PDLIB_OS_WAIT_FOREVER == ulTimeoutUs)
+	{
+		return NULL;
+	}
+
+	clock_gettime(CLOCK_MONOTONIC, psDeadline);
+
+	psDeadline->tv_sec += ulTimeoutUs / 1000000;
+	psDeadline->tv_nsec += (long)(ulTimeoutUs % 1000000) * 1000;
+
+	if(psDeadline->tv_nsec >= 1000000000L)
+	{
+		psDeadline->tv_sec++;
+		psDeadline->tv_nsec -= 1000000000L;
+	}
+
+	return psDeadline;
+}
+
+
+int
+pdlibOS_MutexCreate(pdlibOS_Mutex *psMutex)
+{
+	pthread_mutexattr_t sAttr;
+	pthread_mutex_t *psLock = (pthread_mutex_t*) malloc(sizeof(pthread_mutex_t));
+
+	if(NULL == psLock)
+	{
+		return PDLIB_OS_ERROR;
+	}
+
+	pthread_mutexattr_init(&sAttr);
+	pthread_mutexattr_settype(&sAttr, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init(psLock, &sAttr);
+	pthread_mutexattr_destroy(&sAttr);
+
+	*psMutex = psLock;
+
+	return PDLIB_OS_SUCCESS;
+}
+
+void
+pdlibOS_MutexDelete(pdlibOS_Mutex sMutex)
+{
+	if(sMutex)
+	{
+		pthread_mutex_destroy((pthread_mutex_t*)sMutex);
+		free(sMutex);
+	}
+}
+
+void
+pdlibOS_MutexLock(pdlibOS_Mutex sMutex)
+{
+	pthread_mutex_lock((pthread_mutex_t*)sMutex);
+}
+
+void
+pdlibOS_MutexUnlock(pdlibOS_Mutex sMutex)
+{
+	pthread_mutex_unlock((pthread_mutex_t*)sMutex);
+}
+
+
+int
+pdlibOS_SemaphoreCreate(pdlibOS_Semaphore *psSemaphore)
+{
+	pdlibOS_PosixSemaphore *psSem = (pdlibOS_PosixSemaphore*) malloc(sizeof(pdlibOS_PosixSemaphore));
+
+	if(NULL == psSem)
+	{
+		return PDLIB_OS_ERROR;
+	}
+
+	pthread_mutex_init(&psSem->sLock, NULL);
+	_pdlibOS_InitCond(&psSem->sCond);
+	psSem->iCount = 0;
+
+	*psSemaphore = psSem;
+
+	return PDLIB_OS_SUCCESS;
+}
+
+void
+pdlibOS_SemaphoreDelete(pdlibOS_Semaphore sSemaphore)
+{
+	pdlibOS_PosixSemaphore *psSem = (pdlibOS_PosixSemaphore*)sSemaphore;
+
+	if(psSem)
+	{
+		pthread_cond_destroy(&psSem->sCond);
+		pthread_mutex_destroy(&psSem->sLock);
+		free(psSem);
+	}
+}
+
+int
+pdlibOS_SemaphoreTake(pdlibOS_Semaphore sSemaphore, unsigned long ulTimeoutUs)
+{
+	pdlibOS_PosixSemaphore *psSem = (pdlibOS_PosixSemaphore*)sSemaphore;
+	struct timespec sDeadline;
+	struct timespec *psDeadline = _pdlibOS_Deadline(ulTimeoutUs, &sDeadline);
+	int iRet = PDLIB_OS_SUCCESS;
+
+	pthread_mutex_lock(&psSem->sLock);
+
+	while((0 == psSem->iCount) && (PDLIB_OS_SUCCESS == iRet))
+	{
+		iRet = _pdlibOS_Wait(&psSem->sCond, &psSem->sLock, psDeadline);
+	}
+
+	if(psSem->iCount)
+	{
+		psSem->iCount = 0;
+		iRet = PDLIB_OS_SUCCESS;
+	}
+
+	pthread_mutex_unlock(&psSem->sLock);
+
+	return iRet;
+}
+
+void
+pdlibOS_SemaphoreGive(pdlibOS_Semaphore sSemaphore)
+{
+	pdlibOS_PosixSemaphore *psSem = (pdlibOS_PosixSemaphore*)sSemaphore;
+
+	pthread_mutex_lock(&psSem->sLock);
+	psSem->iCount = 1;
+	pthread_cond_signal(&psSem->sCond);
+	pthread_mutex_unlock(&psSem->sLock);
+}
+
+void
+pdlibOS_SemaphoreGiveFromISR(pdlibOS_Semaphore sSemaphore)
+{
+	pdlibOS_SemaphoreGive(sSemaphore);
+}
+
+
+int
+pdlibOS_QueueCreate(pdlibOS_Queue *psQueue, unsigned int uiItemSize, unsigned int uiDepth)
+{
+	pdlibOS_PosixQueue *psQ;
+
+	if((0 == uiItemSize) || (0 == uiDepth))
+	{
+		return PDLIB_OS_ERROR;
+	}
+
+	psQ = (pdlibOS_PosixQueue*) malloc(sizeof(pdlibOS_PosixQueue) + (uiItemSize * uiDepth));
+
+	if(NULL == psQ)
+	{
+		return PDLIB_OS_ERROR;
+	}
+
+	pthread_mutex_init(&psQ->sLock, NULL);
+	_pdlibOS_InitCond(&psQ->sNotEmpty);
+	_pdlibOS_InitCond(&psQ->sNotFull);
+	psQ->uiItemSize = uiItemSize;
+	psQ->uiDepth = uiDepth;
+	psQ->uiHead = 0;
+	psQ->uiCount = 0;
+
+	*psQueue = psQ;
+
+	return PDLIB_OS_SUCCESS;
+}
+
+void
+pdlibOS_QueueDelete(pdlibOS_Queue sQueue)
+{
+	pdlibOS_PosixQueue *psQ = (pdlibOS_PosixQueue*)sQueue;
+
+	if(psQ)
+	{
+		pthread_cond_destroy(&psQ->sNotFull);
+		pthread_cond_destroy(&psQ->sNotEmpty);
+		pthread_mutex_destroy(&psQ->sLock);
+		free(psQ);
+	}
+}
+
+int
+pdlibOS_QueueSend(pdlibOS_Queue sQueue, const void *pvItem, unsigned long ulTimeoutUs)
+{
+	pdlibOS_PosixQueue *psQ = (pdlibOS_PosixQueue*)sQueue;
+	struct timespec sDeadline;
+	struct timespec *psDeadline = _pdlibOS_Deadline(ulTimeoutUs, &sDeadline);
+	int iRet = PDLIB_OS_SUCCESS;
+
+	pthread_mutex_lock(&psQ->sLock);
+
+	while((psQ->uiCount >= psQ->uiDepth) && (PDLIB_OS_SUCCESS == iRet) && (0 != ulTimeoutUs))
+	{
+		iRet = _pdlibOS_Wait(&psQ->sNotFull, &psQ->sLock, psDeadline);
+	}
+
+	if(psQ->uiCount < psQ->uiDepth)
+	{
+		memcpy(&psQ->pucItems[((psQ->uiHead + psQ->uiCount) % psQ->uiDepth) * psQ->uiItemSize], pvItem, psQ->uiItemSize);
+		psQ->uiCount++;
+		pthread_cond_signal(&psQ->sNotEmpty);
+		iRet = PDLIB_OS_SUCCESS;
+	}else
+	{
+		iRet = PDLIB_OS_TIMEOUT;
+	}
+
+	pthread_mutex_unlock(&psQ->sLock);
+
+	return iRet;
+}
+
+int
+pdlibOS_QueueReceive(pdlibOS_Queue sQueue, void *pvItem, unsigned long ulTimeoutUs)
+{
+	pdlibOS_PosixQueue *psQ = (pdlibOS_PosixQueue*)sQueue;
+	struct timespec sDeadline;
+	struct timespec *psDeadline = _pdlibOS_Deadline(ulTimeoutUs, &sDeadline);
+	int iRet = PDLIB_OS_SUCCESS;
+
+	pthread_mutex_lock(&psQ->sLock);
+
+	while((0 == psQ->uiCount) && (PDLIB_OS_SUCCESS == iRet) && (0 != ulTimeoutUs))
+	{
+		iRet = _pdlibOS_Wait(&psQ->sNotEmpty, &psQ->sLock, psDeadline);
+	}
+
+	if(psQ->uiCount > 0)
+	{
+		memcpy(pvItem, &psQ->pucItems[psQ->uiHead * psQ->uiItemSize], psQ->uiItemSize);
+		psQ->uiHead = (psQ->uiHead + 1) % psQ->uiDepth;
+		psQ->uiCount--;
+		pthread_cond_signal(&psQ->sNotFull);
+		iRet = PDLIB_OS_SUCCESS;
+	}else
+	{
+		iRet = PDLIB_OS_TIMEOUT;
+	}
+
+	pthread_mutex_unlock(&psQ->sLock);
+
+	return iRet;
+}
+
+
+unsigned long
+pdlibOS_GetTimeUs()
+{
+	struct timespec sNow;
+
+	clock_gettime(CLOCK_MONOTONIC, &sNow);
+
+	return (unsigned long)((unsigned long long)sNow.tv_sec * 1000000ULL + (sNow.tv_nsec / 1000));
+}
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef _PDLIB_OS
+#define _PDLIB_OS
+
+/*
+ * OS abstraction used by pdlib_nrf24l01_rtos.c. One port is linked in:
+ *
+ * 		PDLIB_OS_FREERTOS	:	common/os/pdlib_os_freertos.c
+ * 		PDLIB_OS_POSIX		:	common/os/pdlib_os_posix.c
+ *
+ * Timeouts are in microseconds, PDLIB_OS_WAIT_FOREVER waits without a
+ * limit. Functions return PDLIB_OS_SUCCESS, PDLIB_OS_TIMEOUT or
+ * PDLIB_OS_ERROR.
+ */
+
+#define PDLIB_OS_SUCCESS		0
+#define PDLIB_OS_ERROR			-1
+#define PDLIB_OS_TIMEOUT		-2
+
+#define PDLIB_OS_WAIT_FOREVER	0xFFFFFFFFUL
+
+/* PS: Handles are created by the port. Delete accepts NULL */
+typedef void *pdlibOS_Mutex;
+typedef void *pdlibOS_Semaphore;
+typedef void *pdlibOS_Queue;
+
+/* PS: Recursive mutex */
+int pdlibOS_MutexCreate(pdlibOS_Mutex *psMutex);
+void pdlibOS_MutexDelete(pdlibOS_Mutex sMutex);
+void pdlibOS_MutexLock(pdlibOS_Mutex sMutex);
+void pdlibOS_MutexUnlock(pdlibOS_Mutex sMutex);
+
+/* PS: Binary semaphore, created empty */
+int pdlibOS_SemaphoreCreate(pdlibOS_Semaphore *psSemaphore);
+void pdlibOS_SemaphoreDelete(pdlibOS_Semaphore sSemaphore);
+int pdlibOS_SemaphoreTake(pdlibOS_Semaphore sSemaphore, unsigned long ulTimeoutUs);
+void pdlibOS_SemaphoreGive(pdlibOS_Semaphore sSemaphore);
+void pdlibOS_SemaphoreGiveFromISR(pdlibOS_Semaphore sSemaphore);
+
+/* PS: Queue of fixed size items, items are copied */
+int pdlibOS_QueueCreate(pdlibOS_Queue *psQueue, unsigned int uiItemSize, unsigned int uiDepth);
+void pdlibOS_QueueDelete(pdlibOS_Queue sQueue);
+int pdlibOS_QueueSend(pdlibOS_Queue sQueue, const void *pvItem, unsigned long ulTimeoutUs);
+int pdlibOS_QueueReceive(pdlibOS_Queue sQueue, void *pvItem, unsigned long ulTimeoutUs);
+
+/* PS: Monotonic time, can be passed to NRF24L01_SetClockSource() */
+unsigned long pdlibOS_GetTimeUs();
+
+#endif
@@ -4,6 +4,7 @@
 
 
 #include "pdlib_nrf24l01.h"
+#include "pdlib_nrf24l01_pool.h"
 #include "inc/hw_memmap.h"
 #include "inc/hw_types.h"
 #include "driverlib/gpio.h"
@@ -86,7 +87,7 @@ void TransmitDataISR(){
 	long interrupts;
 	char interrupt_flag = 0;
 	char pipe = 0;
-	char *data = NULL;
+	NRF24L01_Frame *frame = NULL;
 
 	// Disable global interrupts
 	ROM_IntMasterDisable();
@@ -115,21 +116,15 @@ void TransmitDataISR(){
 			status = NRF24L01_IsDataReadyRx(&pipe);
 
 			if(PDLIB_NRF24_SUCCESS == status){
-				status = NRF24L01_GetAckDataAmount(pipe);
+				/* Payload is read straight into a pool frame, no malloc in the ISR */
+				frame = NRF24L01_FrameReceive();
 
-				if(status > 0){
+				if(frame){
+					/* Clear interrupt */
+					NRF24L01_ClearInterruptFlag(PDLIB_INTERRUPT_DATA_READY);
 
-					data = (char *)malloc(sizeof(char) * status);
-
-					if(data){
-						NRF24L01_ReadRxPayload(data, status);
-
-						/* Clear interrupt */
-						NRF24L01_ClearInterruptFlag(PDLIB_INTERRUPT_DATA_READY);
-
-						//PrintString(data);
-						free(data);
-					}
+					//PrintString(frame->pcData);
+					NRF24L01_FrameRelease(frame);
 				}
 			}
 		}